@@ -0,0 +1,482 @@
+#include "../include/betterdouble/betterdouble-eigen.hpp"
+#include "../include/betterdouble/fast.hpp"
+#include "../include/betterdouble/taylor.hpp"
+#include "../include/betterdouble/io.hpp"
+#include "../test/kernel.hpp"
+#include <benchmark/benchmark.h>
+#include <Eigen/Eigenvalues>
+#include <Eigen/QR>
+#include <unsupported/Eigen/IterativeSolvers>
+#include <sstream>
+#include <string>
+#include <vector>
+
+typedef bd::Differentiable<double, 4> D4;
+static constexpr std::size_t count = 1024;
+
+///Evenly spaced inputs in `[low, high)`
+template<class T> std::vector<T> inputs(double low = 0.1, double high = 0.9)
+{
+    std::vector<T> x(count);
+    for (std::size_t i = 0; i < count; i++) x[i] = (T)(low + (high - low) * (double)i / count);
+    return x;
+}
+
+///Evenly spaced inputs in `[low, high)` with nonzero derivatives
+template<unsigned int N> std::vector<bd::Differentiable<double, N>> seeded(double low = 0.1, double high = 0.9)
+{
+    std::vector<bd::Differentiable<double, N>> x(count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        x[i] = low + (high - low) * (double)i / count;
+        for (unsigned int j = 0; j < N; j++) x[i].derivative[j] = 1.0 / (1 + i + j);
+    }
+    return x;
+}
+
+template<class T> Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> matrix(Eigen::Index n)
+{
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> a(n, n);
+    for (Eigen::Index c = 0; c < n; c++) for (Eigen::Index r = 0; r < n; r++) a(r, c) = (T)((r == c) ? (double)n : 1.0 / (1 + r + c));
+    return a;
+}
+
+//Scalar arithmetics
+template<class T> void Arithmetics(benchmark::State &state)
+{
+    const std::vector<T> x = inputs<T>(), y = inputs<T>(1.1, 1.9);
+    for (auto _ : state)
+    {
+        T s = (T)0;
+        for (std::size_t i = 0; i < count; i++) s += (x[i] * y[i] - x[i]) / y[i] + x[i];
+        benchmark::DoNotOptimize(s);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(Arithmetics, double);
+BENCHMARK_TEMPLATE(Arithmetics, bd::Real<double>);
+BENCHMARK_TEMPLATE(Arithmetics, D4);
+
+//Functions, one benchmark per function and type
+#define BD_BENCH_UNARY(f, low, high) \
+    template<class T> void Unary_##f(benchmark::State &state) \
+    { \
+        using std::f; using bd::f; \
+        const std::vector<T> x = inputs<T>(low, high); \
+        for (auto _ : state) for (std::size_t i = 0; i < count; i++) benchmark::DoNotOptimize(f(x[i])); \
+        state.SetItemsProcessed(state.iterations() * count); \
+    } \
+    BENCHMARK_TEMPLATE(Unary_##f, double); \
+    BENCHMARK_TEMPLATE(Unary_##f, bd::Real<double>); \
+    BENCHMARK_TEMPLATE(Unary_##f, D4);
+
+#define BD_BENCH_BINARY(f) \
+    template<class T> void Binary_##f(benchmark::State &state) \
+    { \
+        using std::f; using bd::f; \
+        const std::vector<T> x = inputs<T>(), y = inputs<T>(1.1, 1.9); \
+        for (auto _ : state) for (std::size_t i = 0; i < count; i++) benchmark::DoNotOptimize(f(x[i], y[i])); \
+        state.SetItemsProcessed(state.iterations() * count); \
+    } \
+    BENCHMARK_TEMPLATE(Binary_##f, double); \
+    BENCHMARK_TEMPLATE(Binary_##f, bd::Real<double>); \
+    BENCHMARK_TEMPLATE(Binary_##f, D4);
+
+BD_BENCH_UNARY(cos, 0.1, 0.9)
+BD_BENCH_UNARY(sin, 0.1, 0.9)
+BD_BENCH_UNARY(tan, 0.1, 0.9)
+BD_BENCH_UNARY(acos, 0.1, 0.9)
+BD_BENCH_UNARY(asin, 0.1, 0.9)
+BD_BENCH_UNARY(atan, 0.1, 0.9)
+BD_BENCH_UNARY(cosh, 0.1, 0.9)
+BD_BENCH_UNARY(sinh, 0.1, 0.9)
+BD_BENCH_UNARY(tanh, 0.1, 0.9)
+BD_BENCH_UNARY(acosh, 1.1, 1.9)
+BD_BENCH_UNARY(asinh, 0.1, 0.9)
+BD_BENCH_UNARY(atanh, 0.1, 0.9)
+BD_BENCH_UNARY(exp, 0.1, 0.9)
+BD_BENCH_UNARY(log, 0.1, 0.9)
+BD_BENCH_UNARY(log10, 0.1, 0.9)
+BD_BENCH_UNARY(exp2, 0.1, 0.9)
+BD_BENCH_UNARY(expm1, 0.1, 0.9)
+BD_BENCH_UNARY(log1p, 0.1, 0.9)
+BD_BENCH_UNARY(log2, 0.1, 0.9)
+BD_BENCH_UNARY(sqrt, 0.1, 0.9)
+BD_BENCH_UNARY(cbrt, 0.1, 0.9)
+BD_BENCH_UNARY(erf, 0.1, 0.9)
+BD_BENCH_UNARY(erfc, 0.1, 0.9)
+BD_BENCH_UNARY(tgamma, 0.1, 0.9)
+BD_BENCH_UNARY(lgamma, 0.1, 0.9)
+BD_BENCH_UNARY(ceil, 0.1, 0.9)
+BD_BENCH_UNARY(floor, 0.1, 0.9)
+BD_BENCH_UNARY(trunc, 0.1, 0.9)
+BD_BENCH_UNARY(round, 0.1, 0.9)
+BD_BENCH_UNARY(rint, 0.1, 0.9)
+BD_BENCH_UNARY(nearbyint, 0.1, 0.9)
+BD_BENCH_UNARY(fabs, -0.9, 0.9)
+BD_BENCH_UNARY(abs, -0.9, 0.9)
+BD_BENCH_BINARY(pow)
+BD_BENCH_BINARY(hypot)
+BD_BENCH_BINARY(remainder)
+BD_BENCH_BINARY(copysign)
+BD_BENCH_BINARY(nextafter)
+BD_BENCH_BINARY(fdim)
+BD_BENCH_BINARY(fmax)
+BD_BENCH_BINARY(fmin)
+
+template<class T> void Ternary_fma(benchmark::State &state)
+{
+    using std::fma; using bd::fma;
+    const std::vector<T> x = inputs<T>(), y = inputs<T>(1.1, 1.9);
+    for (auto _ : state) for (std::size_t i = 0; i < count; i++) benchmark::DoNotOptimize(fma(x[i], y[i], x[i]));
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(Ternary_fma, double);
+BENCHMARK_TEMPLATE(Ternary_fma, bd::Real<double>);
+BENCHMARK_TEMPLATE(Ternary_fma, D4);
+
+//Approximations, argument 0 for the standard library and 1 for bd::fast, over arrays so that loops can vectorize
+#define BD_BENCH_FAST(f, low, high) \
+    void Fast_##f(benchmark::State &state) \
+    { \
+        const std::vector<double> x = inputs<double>(low, high); \
+        std::vector<double> y(count); \
+        for (auto _ : state) \
+        { \
+            if (state.range(0)) for (std::size_t i = 0; i < count; i++) y[i] = bd::fast::f(x[i]); \
+            else                for (std::size_t i = 0; i < count; i++) y[i] = std::f(x[i]); \
+            benchmark::DoNotOptimize(y.data()); \
+        } \
+        state.SetItemsProcessed(state.iterations() * count); \
+    } \
+    BENCHMARK(Fast_##f)->Arg(0)->Arg(1);
+
+BD_BENCH_FAST(exp, -10, 10)
+BD_BENCH_FAST(log, 0.1, 10)
+BD_BENCH_FAST(sin, -10, 10)
+BD_BENCH_FAST(cos, -10, 10)
+BD_BENCH_FAST(atan, -10, 10)
+BD_BENCH_FAST(tanh, -5, 5)
+BD_BENCH_FAST(erf, -3, 3)
+
+void Fast_pow(benchmark::State &state)
+{
+    const std::vector<double> x = inputs<double>(0.1, 10), y = inputs<double>(-3, 3);
+    std::vector<double> z(count);
+    for (auto _ : state)
+    {
+        if (state.range(0)) for (std::size_t i = 0; i < count; i++) z[i] = bd::fast::pow(x[i], y[i]);
+        else                for (std::size_t i = 0; i < count; i++) z[i] = std::pow(x[i], y[i]);
+        benchmark::DoNotOptimize(z.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(Fast_pow)->Arg(0)->Arg(1);
+
+void FastDerivatives(benchmark::State &state)
+{
+    const std::vector<D4> x = seeded<4>();
+    std::vector<D4> y(count);
+    for (auto _ : state)
+    {
+        if (state.range(0)) for (std::size_t i = 0; i < count; i++) y[i] = bd::fast::exp(x[i]) * bd::fast::sin(x[i]);
+        else                for (std::size_t i = 0; i < count; i++) y[i] = bd::exp(x[i]) * bd::sin(x[i]);
+        benchmark::DoNotOptimize(y.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(FastDerivatives)->Arg(0)->Arg(1);
+
+//Scaling with number of derivatives
+template<unsigned int N> void Derivatives(benchmark::State &state)
+{
+    const std::vector<bd::Differentiable<double, N>> x = seeded<N>(), y = seeded<N>(1.1, 1.9);
+    for (auto _ : state)
+        for (std::size_t i = 0; i < count; i++) benchmark::DoNotOptimize(x[i] * y[i] + sin(x[i]) / y[i]);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(Derivatives, 1);
+BENCHMARK_TEMPLATE(Derivatives, 4);
+BENCHMARK_TEMPLATE(Derivatives, 16);
+BENCHMARK_TEMPLATE(Derivatives, 64);
+BENCHMARK_TEMPLATE(Derivatives, 256);
+
+//Same with float derivatives of double values
+template<unsigned int N> void FloatDerivatives(benchmark::State &state)
+{
+    const std::vector<bd::Differentiable<double, N>> sx = seeded<N>(), sy = seeded<N>(1.1, 1.9);
+    std::vector<bd::DDoubleF<N>> x, y;
+    for (std::size_t i = 0; i < count; i++) { x.emplace_back(sx[i]); y.emplace_back(sy[i]); }
+    for (auto _ : state)
+        for (std::size_t i = 0; i < count; i++) benchmark::DoNotOptimize(x[i] * y[i] + sin(x[i]) / y[i]);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(FloatDerivatives, 16);
+BENCHMARK_TEMPLATE(FloatDerivatives, 64);
+BENCHMARK_TEMPLATE(FloatDerivatives, 256);
+
+//Second derivatives, Hessian of the Rosenbrock function
+void Hessian(benchmark::State &state)
+{
+    const Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(state.range(0), -1, 1);
+    for (auto _ : state) benchmark::DoNotOptimize(bd::hessian([](const auto &x)
+    {
+        typedef typename std::decay<decltype(x)>::type::Scalar S;
+        const S one = 1, hundred = 100;
+        S s = 0;
+        for (Eigen::Index i = 0; i + 1 < x.size(); i++) s += hundred * (x(i + 1) - x(i) * x(i)) * (x(i + 1) - x(i) * x(i)) + (one - x(i)) * (one - x(i));
+        return s;
+    }, x).data());
+}
+BENCHMARK(Hessian)->Arg(8)->Arg(32);
+
+//Jacobian of a tridiagonal function, dense chunks against colored sparse evaluation
+const auto tridiagonal = [](const auto &x)
+{
+    typename std::decay<decltype(x)>::type y(x.size());
+    for (Eigen::Index i = 0; i < x.size(); i++) y(i) = bd::sin(x(i)) * ((i + 1 < x.size()) ? x(i + 1) : x(i)) - ((i > 0) ? x(i - 1) : x(i));
+    return y;
+};
+void DenseJacobian(benchmark::State &state)
+{
+    const Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(state.range(0), -1, 1);
+    for (auto _ : state) benchmark::DoNotOptimize(bd::jacobian(tridiagonal, x).data());
+}
+BENCHMARK(DenseJacobian)->Arg(64)->Arg(512);
+void SparseJacobian(benchmark::State &state)
+{
+    const Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(state.range(0), -1, 1);
+    const bd::SparseJacobian<double, 4> sparse(tridiagonal, x);
+    for (auto _ : state) benchmark::DoNotOptimize(sparse.compute(tridiagonal, x).valuePtr());
+}
+BENCHMARK(SparseJacobian)->Arg(64)->Arg(512);
+
+//Gradient of a least squares loss over a million samples, on the given number of threads
+void ReduceGradient(benchmark::State &state)
+{
+    bd::ThreadPool pool((unsigned int)state.range(0));
+    bd::Differentiable<double, 8> w[8];
+    for (unsigned int k = 0; k < 8; k++) { w[k] = 0.1 * k; w[k].derivative[k] = 1; }
+    const auto loss = [&](std::size_t i)
+    {
+        bd::Differentiable<double, 8> r = -std::sin(1e-6 * i);
+        for (unsigned int k = 0; k < 8; k++) r += w[k] * bd::Differentiable<double, 8>(std::pow(1e-6 * i, k));
+        return r * r;
+    };
+    for (auto _ : state) benchmark::DoNotOptimize(bd::parallel_reduce_gradient(1000000, loss, bd::Differentiable<double, 8>(), false, 4096, pool));
+}
+BENCHMARK(ReduceGradient)->Arg(1)->Arg(4)->Arg(16)->UseRealTime();
+
+//Taylor coefficients of the pendulum x'' = -sin(x), as a first-order system
+template<unsigned int K> void TaylorOde(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        bd::Taylor<double, K> x = 1, v = 0;
+        for (unsigned int k = 0; k < K; k++)
+        {
+            const bd::Taylor<double, K> a = -bd::sin(x);
+            x.coefficient[k + 1] = v.coefficient[k] / (k + 1);
+            v.coefficient[k + 1] = a.coefficient[k] / (k + 1);
+        }
+        benchmark::DoNotOptimize(x);
+    }
+}
+BENCHMARK_TEMPLATE(TaylorOde, 8);
+BENCHMARK_TEMPLATE(TaylorOde, 20);
+
+//Eigen
+template<class T> void Gemm(benchmark::State &state)
+{
+    const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> a = matrix<T>(state.range(0));
+    for (auto _ : state) { Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> c = a * a; benchmark::DoNotOptimize(c.data()); }
+}
+BENCHMARK_TEMPLATE(Gemm, double)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(Gemm, bd::Real<double>)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(Gemm, D4)->Arg(16)->Arg(64);
+
+void GemmPlanes(benchmark::State &state)
+{
+    const Eigen::Matrix<D4, Eigen::Dynamic, Eigen::Dynamic> a = matrix<D4>(state.range(0));
+    for (auto _ : state) { Eigen::Matrix<D4, Eigen::Dynamic, Eigen::Dynamic> c = bd::product(a, a); benchmark::DoNotOptimize(c.data()); }
+}
+BENCHMARK(GemmPlanes)->Arg(16)->Arg(64);
+
+template<class T> void Qr(benchmark::State &state)
+{
+    const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> a = matrix<T>(state.range(0)), b = a.col(0);
+    for (auto _ : state) { Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> x = a.colPivHouseholderQr().solve(b); benchmark::DoNotOptimize(x.data()); }
+}
+BENCHMARK_TEMPLATE(Qr, double)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(Qr, bd::Real<double>)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(Qr, D4)->Arg(16)->Arg(64);
+
+void QrPlanes(benchmark::State &state)
+{
+    typedef Eigen::Matrix<D4, Eigen::Dynamic, Eigen::Dynamic> M;
+    const M a = matrix<D4>(state.range(0)), b = a.col(0);
+    for (auto _ : state) { M x = bd::LinearSolver<M, Eigen::ColPivHouseholderQR<Eigen::MatrixXd>>(a).solve(b); benchmark::DoNotOptimize(x.data()); }
+}
+BENCHMARK(QrPlanes)->Arg(16)->Arg(64);
+
+template<class T> void EigenSolve(benchmark::State &state)
+{
+    const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> a = matrix<T>(state.range(0));
+    for (auto _ : state) { Eigen::EigenSolver<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>> e(a); benchmark::DoNotOptimize(e.eigenvalues().data()); }
+}
+BENCHMARK_TEMPLATE(EigenSolve, double)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(EigenSolve, bd::Real<double>)->Arg(16)->Arg(64);
+
+void EigenSolvePlanes(benchmark::State &state)
+{
+    const Eigen::Matrix<D4, Eigen::Dynamic, Eigen::Dynamic> a = matrix<D4>(state.range(0));
+    for (auto _ : state) { bd::EigenSolver<Eigen::Matrix<D4, Eigen::Dynamic, Eigen::Dynamic>> e(a); benchmark::DoNotOptimize(e.eigenvalues().data()); }
+}
+BENCHMARK(EigenSolvePlanes)->Arg(16)->Arg(64);
+
+//Formatting
+template<class T> void Stream(benchmark::State &state)
+{
+    const std::vector<T> x = inputs<T>();
+    for (auto _ : state)
+    {
+        std::ostringstream os;
+        for (std::size_t i = 0; i < count; i++) os << x[i] << '\n';
+        benchmark::DoNotOptimize(os.str().size());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(Stream, double);
+BENCHMARK_TEMPLATE(Stream, bd::Real<double>);
+BENCHMARK_TEMPLATE(Stream, D4);
+
+template<class T> void ToString(benchmark::State &state)
+{
+    using std::to_string;
+    const std::vector<T> x = inputs<T>();
+    for (auto _ : state) for (std::size_t i = 0; i < count; i++) benchmark::DoNotOptimize(to_string(x[i]));
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(ToString, double);
+BENCHMARK_TEMPLATE(ToString, bd::Real<double>);
+BENCHMARK_TEMPLATE(ToString, D4);
+
+template<class T> void ToChars(benchmark::State &state)
+{
+    const std::vector<T> x = inputs<T>();
+    char buffer[256];
+    for (auto _ : state) for (std::size_t i = 0; i < count; i++) benchmark::DoNotOptimize(bd::io::format(buffer, buffer + sizeof(buffer), x[i]));
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(ToChars, bd::Real<double>);
+BENCHMARK_TEMPLATE(ToChars, D4);
+
+//Binary records, against text through streams
+void BinaryWrite(benchmark::State &state)
+{
+    const std::vector<D4> x = seeded<4>();
+    for (auto _ : state)
+    {
+        std::ostringstream os;
+        { bd::io::Writer<D4> writer(os, count); writer.write(x.data(), count); }
+        benchmark::DoNotOptimize(os.str().size());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BinaryWrite);
+
+//Generated kernel, against the same model over bd::Differentiable
+void generated_model_jacobian(const double *x, double *y, double *jacobian) noexcept;
+
+void KernelJacobian(benchmark::State &state)
+{
+    const std::vector<double> x = inputs<double>();
+    double y[3], jacobian[9];
+    for (auto _ : state) for (std::size_t i = 0; i + 2 < count; i++) { generated_model_jacobian(&x[i], y, jacobian); benchmark::DoNotOptimize(jacobian); }
+    state.SetItemsProcessed(state.iterations() * (count - 2));
+}
+BENCHMARK(KernelJacobian);
+
+void DifferentiableJacobian(benchmark::State &state)
+{
+    const std::vector<double> x = inputs<double>();
+    std::vector<bd::Differentiable<double, 3>> dx(3);
+    for (auto _ : state) for (std::size_t i = 0; i + 2 < count; i++)
+    {
+        for (unsigned int k = 0; k < 3; k++) { dx[k] = x[i + k]; dx[k].derivative[k] = 1; }
+        benchmark::DoNotOptimize(kernel_model(dx));
+    }
+    state.SetItemsProcessed(state.iterations() * (count - 2));
+}
+BENCHMARK(DifferentiableJacobian);
+
+//Constant operands, mixed overloads against promotion to Differentiable
+template<unsigned int N> void MixedConstants(benchmark::State &state)
+{
+    const std::vector<bd::Differentiable<double, N>> x = seeded<N>();
+    for (auto _ : state) for (std::size_t i = 0; i < count; i++) benchmark::DoNotOptimize(2.0 * x[i] + 1.0);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(MixedConstants, 4);
+BENCHMARK_TEMPLATE(MixedConstants, 64);
+
+template<unsigned int N> void PromotedConstants(benchmark::State &state)
+{
+    typedef bd::Differentiable<double, N> D;
+    const std::vector<D> x = seeded<N>();
+    for (auto _ : state) for (std::size_t i = 0; i < count; i++) benchmark::DoNotOptimize(D(2.0) * x[i] + D(1.0));
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(PromotedConstants, 4);
+BENCHMARK_TEMPLATE(PromotedConstants, 64);
+
+void MixedMatrixProduct(benchmark::State &state)
+{
+    const Eigen::MatrixXd a = Eigen::MatrixXd::Random(state.range(0), state.range(0));
+    const Eigen::Matrix<D4, Eigen::Dynamic, 1> v = Eigen::Matrix<D4, Eigen::Dynamic, 1>::Constant(state.range(0), D4(0.5));
+    for (auto _ : state) { Eigen::Matrix<D4, Eigen::Dynamic, 1> w = a * v; benchmark::DoNotOptimize(w.data()); }
+}
+BENCHMARK(MixedMatrixProduct)->Arg(64)->Arg(256);
+
+void PromotedMatrixProduct(benchmark::State &state)
+{
+    const Eigen::MatrixXd a = Eigen::MatrixXd::Random(state.range(0), state.range(0));
+    const Eigen::Matrix<D4, Eigen::Dynamic, 1> v = Eigen::Matrix<D4, Eigen::Dynamic, 1>::Constant(state.range(0), D4(0.5));
+    for (auto _ : state) { Eigen::Matrix<D4, Eigen::Dynamic, 1> w = a.cast<D4>() * v; benchmark::DoNotOptimize(w.data()); }
+}
+BENCHMARK(PromotedMatrixProduct)->Arg(64)->Arg(256);
+
+//Matrix-free Newton-Krylov on the Bratu problem, never forming the Jacobian
+static const auto bratu = [](const auto &x)
+{
+    typedef typename std::decay<decltype(x)>::type Vector;
+    typedef typename Vector::Scalar S;
+    const Eigen::Index n = x.size();
+    const double h = 1.0 / (double)(n + 1);
+    Vector y(n);
+    for (Eigen::Index i = 0; i < n; i++) y(i) = ((i > 0) ? x(i - 1) : S(0.0)) - S(2.0) * x(i) + ((i + 1 < n) ? x(i + 1) : S(0.0)) + S(h * h) * bd::exp(x(i));
+    return y;
+};
+
+void JacobianVector(benchmark::State &state)
+{
+    const Eigen::VectorXd x = Eigen::VectorXd::Constant(state.range(0), 0.1), v = Eigen::VectorXd::Ones(state.range(0));
+    const bd::JacobianOperator<double, decltype(bratu)> op(bratu, x);
+    for (auto _ : state) benchmark::DoNotOptimize(op.apply(v));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(JacobianVector)->Arg(1 << 10)->Arg(1 << 20);
+
+void NewtonKrylov(benchmark::State &state)
+{
+    unsigned int linear = 0;
+    for (auto _ : state)
+    {
+        Eigen::VectorXd x = Eigen::VectorXd::Zero(state.range(0));
+        linear = bd::newton_krylov<Eigen::GMRES, bd::ProbedDiagonalPreconditioner<double, 2>>(bratu, x).linear;
+    }
+    state.counters["linear"] = linear;
+}
+BENCHMARK(NewtonKrylov)->Arg(1 << 6)->Arg(1 << 8)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
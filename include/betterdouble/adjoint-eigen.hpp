@@ -0,0 +1,34 @@
+#pragma once
+
+#include "adjoint.hpp"
+#include <Eigen/Core>
+
+template<class T> struct Eigen::NumTraits<bd::Adjoint<T>>
+{
+    typedef bd::Adjoint<T> Real;
+    typedef bd::Adjoint<T> NonInteger;
+    typedef bd::Adjoint<T> Literal;
+    typedef bd::Adjoint<T> Nested;
+
+    enum
+    {
+        IsComplex = 0,
+        IsInteger = 0,
+        IsSigned = 1,
+        ReadCost = 1,
+        AddCost = 3,
+        MulCost = 3,
+        RequireInitialization = 1 //constants must have null tape
+    };
+
+    static inline bd::Adjoint<T> epsilon        () noexcept { return (bd::Adjoint<T>)std::numeric_limits<T>::epsilon(); }
+    static inline bd::Adjoint<T> dummy_precision() noexcept { return (bd::Adjoint<T>)std::numeric_limits<T>::epsilon(); }
+    static inline bd::Adjoint<T> highest        () noexcept { return (bd::Adjoint<T>)std::numeric_limits<T>::infinity(); }
+    static inline bd::Adjoint<T> lowest         () noexcept { return (bd::Adjoint<T>)-std::numeric_limits<T>::infinity(); }
+    static inline int            digits         () noexcept { return std::numeric_limits<T>::digits; }
+    static inline int            digits10       () noexcept { return std::numeric_limits<T>::digits10; }
+    static inline int            min_exponent   () noexcept { return std::numeric_limits<T>::min_exponent; }
+    static inline int            max_exponent   () noexcept { return std::numeric_limits<T>::max_exponent; }
+    static inline bd::Adjoint<T> infinity       () noexcept { return (bd::Adjoint<T>)std::numeric_limits<T>::infinity(); }
+    static inline bd::Adjoint<T> quiet_NaN      () noexcept { return (bd::Adjoint<T>)std::numeric_limits<T>::quiet_NaN(); }
+};
\ No newline at end of file
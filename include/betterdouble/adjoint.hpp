@@ -0,0 +1,266 @@
+#pragma once
+
+#include "rules.hpp"
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace bd
+{
+    //Predefine
+    template<class T> class Tape;
+    template<class T> class Adjoint;
+
+    ///Bump allocator, hands out elements from fixed-size blocks and releases them all at once
+    ///@tparam E Element type
+    ///@tparam B Number of elements in one block
+    template<class E, std::size_t B = 4096>
+    class Arena
+    {
+    private:
+        std::vector<std::unique_ptr<E[]>> _blocks;
+        std::size_t _size = 0;
+
+    public:
+        //Allocation
+        inline E &push()
+        {
+            if (_size == _blocks.size() * B) _blocks.emplace_back(new E[B]);
+            E &element = _blocks[_size / B][_size % B];
+            ++_size;
+            return element;
+        };
+        inline void clear() noexcept { _size = 0; }; //blocks are kept for reuse
+
+        //Access
+        inline       E &operator[](std::size_t i)       noexcept { return _blocks[i / B][i % B]; };
+        inline const E &operator[](std::size_t i) const noexcept { return _blocks[i / B][i % B]; };
+        inline std::size_t size() const noexcept { return _size; };
+    };
+
+    ///Record of operations performed on adjoint variables
+    ///@tparam T Base type
+    template<class T>
+    class Tape
+    {
+    public:
+        ///One recorded operation, partial derivatives of the result with respect to up to two operands
+        struct Node
+        {
+            std::size_t operand[2];
+            T partial[2];
+        };
+
+    private:
+        Arena<Node> _nodes;
+        std::vector<T> _adjoints;
+
+    public:
+        //Recording
+        inline std::size_t record()                                                                  { Node &node = _nodes.push(); node.operand[0] = node.operand[1] = 0; node.partial[0] = node.partial[1] = 0; return _nodes.size() - 1; };
+        inline std::size_t record(std::size_t a, const T &da)                                        { Node &node = _nodes.push(); node.operand[0] = node.operand[1] = a; node.partial[0] = da; node.partial[1] = 0; return _nodes.size() - 1; };
+        inline std::size_t record(std::size_t a, const T &da, std::size_t b, const T &db)            { Node &node = _nodes.push(); node.operand[0] = a; node.operand[1] = b; node.partial[0] = da; node.partial[1] = db; return _nodes.size() - 1; };
+        inline Adjoint<T> variable(const T &value)                                                   { Adjoint<T> v(value); v.tape = this; v.index = record(); return v; };
+        inline std::size_t size() const noexcept                                                     { return _nodes.size(); };
+        inline void clear() noexcept                                                                 { _nodes.clear(); _adjoints.clear(); };
+
+        ///Propagates adjoints backwards from the given output, in one sweep over the tape
+        inline void backward(const Adjoint<T> &output)
+        {
+            _adjoints.assign(_nodes.size(), 0);
+            if (output.tape != this) return;
+            _adjoints[output.index] = 1;
+            for (std::size_t i = output.index + 1; i-- > 0;)
+            {
+                const T adjoint = _adjoints[i];
+                if (adjoint == 0) continue;
+                const Node &node = _nodes[i];
+                _adjoints[node.operand[0]] += adjoint * node.partial[0];
+                _adjoints[node.operand[1]] += adjoint * node.partial[1];
+            }
+        };
+
+        ///Derivative of the last output passed to `backward()` with respect to the given variable
+        inline T adjoint(const Adjoint<T> &x) const noexcept { return (x.tape == this && x.index < _adjoints.size()) ? _adjoints[x.index] : 0; };
+    };
+
+    //Basic arithmetics
+    template<class T> inline Adjoint<T> operator+(const Adjoint<T> &a, const Adjoint<T> &b) { return Adjoint<T>::binary(a.value + b.value, a, 1, b, 1); };
+    template<class T> inline Adjoint<T> operator-(const Adjoint<T> &a, const Adjoint<T> &b) { return Adjoint<T>::binary(a.value - b.value, a, 1, b, -1); };
+    template<class T> inline Adjoint<T> operator*(const Adjoint<T> &a, const Adjoint<T> &b) { return Adjoint<T>::binary(a.value * b.value, a, b.value, b, a.value); };
+    template<class T> inline Adjoint<T> operator/(const Adjoint<T> &a, const Adjoint<T> &b) { return Adjoint<T>::binary(a.value / b.value, a, 1 / b.value, b, -a.value / (b.value * b.value)); };
+
+    ///Same as double, but records operations for reverse-mode differentiation
+    ///@tparam T Base type
+    template<class T>
+    class Adjoint
+    {
+    public:
+        //Variables
+        T value;
+        Tape<T> *tape;      //nullptr for constants
+        std::size_t index;  //position of the variable on the tape
+
+        //Constructors & assignment
+        inline explicit Adjoint()                   noexcept : value(0),           tape(nullptr),    index(0)           {};
+        inline Adjoint(const T &other)              noexcept : value(other),       tape(nullptr),    index(0)           {};
+        inline Adjoint(const Adjoint<T> &other)     noexcept : value(other.value), tape(other.tape), index(other.index) {};
+        inline Adjoint &operator=(const Adjoint<T> &other) noexcept { value = other.value; tape = other.tape; index = other.index; return *this; };
+
+        //Recording
+        static inline Adjoint unary(const T &value, const Adjoint &x, const T &dx)
+        {
+            Adjoint v(value);
+            if (x.tape != nullptr) { v.tape = x.tape; v.index = x.tape->record(x.index, dx); }
+            return v;
+        };
+        static inline Adjoint binary(const T &value, const Adjoint &a, const T &da, const Adjoint &b, const T &db)
+        {
+            if (a.tape == nullptr) return unary(value, b, db);
+            if (b.tape == nullptr) return unary(value, a, da);
+            Adjoint v(value);
+            v.tape = a.tape;
+            v.index = a.tape->record(a.index, da, b.index, db);
+            return v;
+        };
+
+        //Increments/decrements
+        inline Adjoint &operator++()    noexcept { ++value; return *this; };
+        inline Adjoint &operator--()    noexcept { --value; return *this; };
+        inline Adjoint operator++ (int) noexcept { Adjoint v = *this; ++value; return v; };
+        inline Adjoint operator-- (int) noexcept { Adjoint v = *this; --value; return v; };
+
+        //Arithmetics
+        inline Adjoint &operator+=(const Adjoint &other) { return *this = *this + other; };
+        inline Adjoint &operator-=(const Adjoint &other) { return *this = *this - other; };
+        inline Adjoint &operator*=(const Adjoint &other) { return *this = *this * other; };
+        inline Adjoint &operator/=(const Adjoint &other) { return *this = *this / other; };
+
+        //Transformations
+        inline Adjoint operator+() const { return *this; };
+        inline Adjoint operator-() const { return unary(-value, *this, -1); };
+
+        //Cast
+        inline explicit operator T() const noexcept { return value; };
+    };
+
+    //Comparison
+    template<class T> inline bool operator==(const Adjoint<T> &a, const Adjoint<T> &b) noexcept { return a.value == b.value; };
+    template<class T> inline bool operator!=(const Adjoint<T> &a, const Adjoint<T> &b) noexcept { return a.value != b.value; };
+    template<class T> inline bool operator> (const Adjoint<T> &a, const Adjoint<T> &b) noexcept { return a.value >  b.value; };
+    template<class T> inline bool operator< (const Adjoint<T> &a, const Adjoint<T> &b) noexcept { return a.value <  b.value; };
+    template<class T> inline bool operator>=(const Adjoint<T> &a, const Adjoint<T> &b) noexcept { return a.value >= b.value; };
+    template<class T> inline bool operator<=(const Adjoint<T> &a, const Adjoint<T> &b) noexcept { return a.value <= b.value; };
+
+    //Trigonometric functions
+    template<class T> inline Adjoint<T> cos  (const Adjoint<T> &x) { T d = 0; const T r = rules::cos(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> sin  (const Adjoint<T> &x) { T d = 0; const T r = rules::sin(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> tan  (const Adjoint<T> &x) { T d = 0; const T r = rules::tan(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> acos (const Adjoint<T> &x) { T d = 0; const T r = rules::acos(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> asin (const Adjoint<T> &x) { T d = 0; const T r = rules::asin(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> atan (const Adjoint<T> &x) { T d = 0; const T r = rules::atan(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> atan2(const Adjoint<T> &y, const Adjoint<T> &x) { const T r = x.value * x.value + y.value * y.value; return Adjoint<T>::binary(std::atan2(y.value, x.value), y, x.value / r, x, -y.value / r); };
+
+    //Hyperbolic functions
+    template<class T> inline Adjoint<T> cosh (const Adjoint<T> &x) { T d = 0; const T r = rules::cosh(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> sinh (const Adjoint<T> &x) { T d = 0; const T r = rules::sinh(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> tanh (const Adjoint<T> &x) { T d = 0; const T r = rules::tanh(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> acosh(const Adjoint<T> &x) { T d = 0; const T r = rules::acosh(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> asinh(const Adjoint<T> &x) { T d = 0; const T r = rules::asinh(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> atanh(const Adjoint<T> &x) { T d = 0; const T r = rules::atanh(x.value, d); return Adjoint<T>::unary(r, x, d); };
+
+    //Exponential and logarithmic functions
+    template<class T> inline Adjoint<T> exp  (const Adjoint<T> &x) { T d = 0; const T r = rules::exp(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> log  (const Adjoint<T> &x) { T d = 0; const T r = rules::log(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> log10(const Adjoint<T> &x) { T d = 0; const T r = rules::log10(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> exp2 (const Adjoint<T> &x) { T d = 0; const T r = rules::exp2(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> expm1(const Adjoint<T> &x) { T d = 0; const T r = rules::expm1(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> log1p(const Adjoint<T> &x) { T d = 0; const T r = rules::log1p(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> log2 (const Adjoint<T> &x) { T d = 0; const T r = rules::log2(x.value, d); return Adjoint<T>::unary(r, x, d); };
+
+    //Power functions
+    template<class T> inline Adjoint<T> pow  (const Adjoint<T> &base, const Adjoint<T> &exponent) { T da = 0, db = 0; const T r = rules::pow(base.value, exponent.value, da, db); return Adjoint<T>::binary(r, base, da, exponent, db); };
+    template<class T> inline Adjoint<T> sqrt (const Adjoint<T> &x)                                { T d = 0; const T r = rules::sqrt(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> cbrt (const Adjoint<T> &x)                                { T d = 0; const T r = rules::cbrt(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> hypot(const Adjoint<T> &x,    const Adjoint<T> &y)        { T da = 0, db = 0; const T r = rules::hypot(x.value, y.value, da, db); return Adjoint<T>::binary(r, x, da, y, db); };
+
+    //Error and gamma functions
+    template<class T> inline Adjoint<T> erf   (const Adjoint<T> &x) { T d = 0; const T r = rules::erf(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> erfc  (const Adjoint<T> &x) { T d = 0; const T r = rules::erfc(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> tgamma(const Adjoint<T> &x) { T d = 0; const T r = rules::tgamma(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> lgamma(const Adjoint<T> &x) { T d = 0; const T r = rules::lgamma(x.value, d); return Adjoint<T>::unary(r, x, d); };
+
+    //Rounding and remainder functions
+    template<class T> inline Adjoint<T>    ceil     (const Adjoint<T> &x) noexcept { return (Adjoint<T>)std::ceil     (x.value); };
+    template<class T> inline Adjoint<T>    floor    (const Adjoint<T> &x) noexcept { return (Adjoint<T>)std::floor    (x.value); };
+    template<class T> inline Adjoint<T>    trunc    (const Adjoint<T> &x) noexcept { return (Adjoint<T>)std::trunc    (x.value); };
+    template<class T> inline Adjoint<T>    round    (const Adjoint<T> &x) noexcept { return (Adjoint<T>)std::round    (x.value); };
+    template<class T> inline long int      lround   (const Adjoint<T> &x) noexcept { return std::lround   (x.value); };
+    template<class T> inline long long int llround  (const Adjoint<T> &x) noexcept { return std::llround  (x.value); };
+    template<class T> inline Adjoint<T>    rint     (const Adjoint<T> &x) noexcept { return (Adjoint<T>)std::rint     (x.value); };
+    template<class T> inline long int      lrint    (const Adjoint<T> &x) noexcept { return std::lrint    (x.value); };
+    template<class T> inline long long int llrint   (const Adjoint<T> &x) noexcept { return std::llrint   (x.value); };
+    template<class T> inline Adjoint<T>    nearbyint(const Adjoint<T> &x) noexcept { return (Adjoint<T>)std::nearbyint(x.value); };
+    template<class T> inline Adjoint<T>    remainder(const Adjoint<T> &numer, const Adjoint<T> &denom)            noexcept { return (Adjoint<T>)std::remainder(numer.value, denom.value); };
+    template<class T> inline Adjoint<T>    remquo   (const Adjoint<T> &numer, const Adjoint<T> &denom, int *quot) noexcept { return (Adjoint<T>)std::remquo   (numer.value, denom.value, quot); };
+
+    //Floating-point manipulation functions
+    template<class T> inline Adjoint<T> copysign  (const Adjoint<T> &mag, const Adjoint<T> &sgn) { return (std::signbit(mag.value) == std::signbit(sgn.value)) ? (mag) : (-mag); };
+    template<class T> inline Adjoint<T> nan       (const char* tagp)                             noexcept { return (Adjoint<T>)std::nan       (tagp); };
+    template<class T> inline Adjoint<T> nextafter (const Adjoint<T> &x,   const Adjoint<T> &y)   noexcept { return (Adjoint<T>)std::nextafter (x.value, y.value); };
+    template<class T> inline Adjoint<T> nexttoward(const Adjoint<T> &x,   const Adjoint<T> &y)   noexcept { return (Adjoint<T>)std::nexttoward(x.value, y.value); };
+
+    //Minimum, maximum, difference functions
+    template<class T> inline Adjoint<T> fdim(const Adjoint<T> &x, const Adjoint<T> &y) { return (x > y) ? (x - y) : ((Adjoint<T>)0); };
+    template<class T> inline Adjoint<T> fmax(const Adjoint<T> &x, const Adjoint<T> &y) noexcept { if (std::isnan(x.value)) return y; if (std::isnan(y.value)) return x; return (x > y) ? (x) : (y); };
+    template<class T> inline Adjoint<T> fmin(const Adjoint<T> &x, const Adjoint<T> &y) noexcept { if (std::isnan(x.value)) return y; if (std::isnan(y.value)) return x; return (x < y) ? (x) : (y); };
+
+    //Other functions
+    template<class T> inline Adjoint<T> fabs(const Adjoint<T> &x) { T d = 0; const T r = rules::fabs(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> abs (const Adjoint<T> &x) { T d = 0; const T r = rules::abs(x.value, d); return Adjoint<T>::unary(r, x, d); };
+    template<class T> inline Adjoint<T> fma (const Adjoint<T> &x, const Adjoint<T> &y, const Adjoint<T> &z) { return x * y + z; };
+
+    //Classification macro / functions
+    template<class T> inline int  fpclassify(const Adjoint<T> &x) noexcept { return std::fpclassify(x.value); }
+    template<class T> inline bool isfinite  (const Adjoint<T> &x) noexcept { return std::isfinite  (x.value); }
+    template<class T> inline bool isinf     (const Adjoint<T> &x) noexcept { return std::isinf     (x.value); }
+    template<class T> inline bool isnan     (const Adjoint<T> &x) noexcept { return std::isnan     (x.value); }
+    template<class T> inline bool isnormal  (const Adjoint<T> &x) noexcept { return std::isnormal  (x.value); }
+    template<class T> inline bool signbit   (const Adjoint<T> &x) noexcept { return std::signbit   (x.value); }
+
+    //Comparison macro / functions
+    template<class T> inline bool isgreater     (const Adjoint<T> &x, const Adjoint<T> &y) noexcept { return std::isgreater     (x.value, y.value); }
+    template<class T> inline bool isgreaterequal(const Adjoint<T> &x, const Adjoint<T> &y) noexcept { return std::isgreaterequal(x.value, y.value); }
+    template<class T> inline bool isless        (const Adjoint<T> &x, const Adjoint<T> &y) noexcept { return std::isless        (x.value, y.value); }
+    template<class T> inline bool islessequal   (const Adjoint<T> &x, const Adjoint<T> &y) noexcept { return std::islessequal   (x.value, y.value); }
+    template<class T> inline bool islessgreater (const Adjoint<T> &x, const Adjoint<T> &y) noexcept { return std::islessgreater (x.value, y.value); }
+    template<class T> inline bool isunordered   (const Adjoint<T> &x, const Adjoint<T> &y) noexcept { return std::isunordered   (x.value, y.value); }
+
+    //Defines
+    typedef Adjoint<float> AFloat;
+    typedef Adjoint<double> ADouble;
+    typedef Adjoint<long double> ALongDouble;
+}
+
+namespace std
+{
+    template<class C, class T> basic_ostream<C> &operator<<(basic_ostream<C> &os, const bd::Adjoint<T> &x)
+    {
+        os << x.value;
+        return os;
+    }
+
+    template<class T> std::string to_string(const bd::Adjoint<T> &x)
+    {
+        return std::to_string(x.value);
+    }
+
+    template<class T> std::wstring to_wstring(const bd::Adjoint<T> &x)
+    {
+        return std::to_wstring(x.value);
+    }
+};
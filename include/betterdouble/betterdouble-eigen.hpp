@@ -1,3 +1,9 @@
 #pragma once
 #include "real-eigen.hpp"
-#include "differentiable-eigen.hpp"
\ No newline at end of file
+#include "differentiable-eigen.hpp"
+#include "hyper-dual-eigen.hpp"
+#include "adjoint-eigen.hpp"
+#include "tracer-eigen.hpp"
+#include "jacobian.hpp"
+#include "newton-krylov.hpp"
+#include "linear-algebra.hpp"
\ No newline at end of file
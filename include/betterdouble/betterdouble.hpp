@@ -1,3 +1,14 @@
 #pragma once
 #include "real.hpp"
-#include "differentiable.hpp"
\ No newline at end of file
+#include "real-batch.hpp"
+#include "differentiable.hpp"
+#include "differentiable-dynamic.hpp"
+#include "differentiable-sparse.hpp"
+#include "differentiable-expression.hpp"
+#include "differentiable-batch.hpp"
+#include "hyper-dual.hpp"
+#include "taylor.hpp"
+#include "adjoint.hpp"
+#include "thread-pool.hpp"
+#include "tracer.hpp"
+#include "io.hpp"
\ No newline at end of file
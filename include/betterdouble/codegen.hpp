@@ -0,0 +1,502 @@
+#pragma once
+
+#include "io.hpp"
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace bd
+{
+    template<class T> class Symbol;
+
+    namespace codegen
+    {
+        //List of operations, functions map to std:: functions of same name
+        #define BD_CODEGEN_UNARY(X) \
+            X(sin) X(cos) X(tan) X(asin) X(acos) X(atan) \
+            X(sinh) X(cosh) X(tanh) X(asinh) X(acosh) X(atanh) \
+            X(exp) X(log) X(log10) X(exp2) X(expm1) X(log1p) X(log2) X(sqrt) X(cbrt) X(erf) X(erfc) X(fabs)
+        #define BD_CODEGEN_BINARY(X) X(pow) X(hypot) X(atan2) X(fmin) X(fmax) X(fdim) X(copysign)
+        #define BD_CODEGEN_TERNARY(X) X(fma)
+
+        ///Operation of a node, `sign` and `step` are derivatives of `fabs` and of `fmax` alike
+        enum class Op : unsigned char
+        {
+            constant, input, add, sub, mul, div, neg, sign, step,
+            #define BD_CODEGEN_OP(name) name,
+            BD_CODEGEN_UNARY(BD_CODEGEN_OP)
+            BD_CODEGEN_BINARY(BD_CODEGEN_OP)
+            BD_CODEGEN_TERNARY(BD_CODEGEN_OP)
+            #undef BD_CODEGEN_OP
+        };
+
+        ///Node of expression graph, operands always precede the node
+        template<class T>
+        struct Node
+        {
+            Op op;
+            unsigned int a, b, c; //operands, index of input for `input`
+            T constant;           //value of `constant`
+        };
+
+        ///Expression DAG. Every node is created once: equal operations on equal operands return the existing node (common subexpression elimination),
+        ///operations on constants are folded, and additions of zero, multiplications by zero or one and alike are simplified away.
+        ///@tparam T Base type
+        template<class T>
+        class Graph
+        {
+        public:
+            //Constants
+            static constexpr unsigned int none = (unsigned int)-1;
+
+        private:
+            std::vector<Node<T>> _nodes;
+            std::map<std::tuple<Op, unsigned int, unsigned int, unsigned int>, unsigned int> _operations;
+            std::map<T, unsigned int> _constants;
+
+            inline unsigned int _push(const Node<T> &node) { _nodes.push_back(node); return (unsigned int)_nodes.size() - 1; };
+
+        public:
+            ///Value of `op` applied to `a`, `b` and `c`
+            static inline T apply(Op op, T a, T b = 0, T c = 0) noexcept
+            {
+                switch (op)
+                {
+                case Op::add: return a + b;
+                case Op::sub: return a - b;
+                case Op::mul: return a * b;
+                case Op::div: return a / b;
+                case Op::neg: return -a;
+                case Op::sign: return std::copysign((T)1, a);
+                case Op::step: return (a > 0) ? (T)1 : (T)0;
+                #define BD_CODEGEN_APPLY(name) case Op::name: return std::name(a);
+                BD_CODEGEN_UNARY(BD_CODEGEN_APPLY)
+                #undef BD_CODEGEN_APPLY
+                #define BD_CODEGEN_APPLY(name) case Op::name: return std::name(a, b);
+                BD_CODEGEN_BINARY(BD_CODEGEN_APPLY)
+                #undef BD_CODEGEN_APPLY
+                #define BD_CODEGEN_APPLY(name) case Op::name: return std::name(a, b, c);
+                BD_CODEGEN_TERNARY(BD_CODEGEN_APPLY)
+                #undef BD_CODEGEN_APPLY
+                default: return a;
+                }
+            };
+
+            //Access
+            inline const std::vector<Node<T>> &nodes()        const noexcept { return _nodes; };
+            inline const Node<T> &operator[](unsigned int k)  const noexcept { return _nodes[k]; };
+            inline bool is_constant(unsigned int k, T c)      const noexcept { return _nodes[k].op == Op::constant && _nodes[k].constant == c; };
+
+            //Construction
+            inline unsigned int constant(T c)
+            {
+                if (c != c) return _push({ Op::constant, none, none, none, c }); //NaN does not compare
+                const auto found = _constants.find(c);
+                if (found != _constants.end() && std::signbit(_nodes[found->second].constant) == std::signbit(c)) return found->second;
+                const unsigned int k = _push({ Op::constant, none, none, none, c });
+                if (found == _constants.end()) _constants[c] = k;
+                return k;
+            };
+            inline unsigned int input(unsigned int i) { return node(Op::input, i, none); };
+            ///Node of `op` applied to nodes `a`, `b` and `c`, unused operands are `none`
+            inline unsigned int node(Op op, unsigned int a, unsigned int b = none, unsigned int c = none)
+            {
+                if (op != Op::input)
+                {
+                    const bool ca = _nodes[a].op == Op::constant, cb = (b == none) || _nodes[b].op == Op::constant, cc = (c == none) || _nodes[c].op == Op::constant;
+                    if (ca && cb && cc) return constant(apply(op, _nodes[a].constant, (b == none) ? (T)0 : _nodes[b].constant, (c == none) ? (T)0 : _nodes[c].constant));
+                    switch (op)
+                    {
+                    case Op::add:
+                        if (is_constant(a, 0)) return b;
+                        if (is_constant(b, 0)) return a;
+                        if (a > b) std::swap(a, b);
+                        break;
+                    case Op::sub:
+                        if (is_constant(b, 0)) return a;
+                        if (is_constant(a, 0)) return node(Op::neg, b);
+                        if (a == b) return constant(0);
+                        break;
+                    case Op::mul:
+                        if (is_constant(a, 0) || is_constant(b, 0)) return constant(0);
+                        if (is_constant(a, 1)) return b;
+                        if (is_constant(b, 1)) return a;
+                        if (is_constant(a, -1)) return node(Op::neg, b);
+                        if (is_constant(b, -1)) return node(Op::neg, a);
+                        if (a > b) std::swap(a, b);
+                        break;
+                    case Op::div:
+                        if (is_constant(a, 0)) return constant(0);
+                        if (is_constant(b, 1)) return a;
+                        break;
+                    case Op::neg:
+                        if (_nodes[a].op == Op::neg) return _nodes[a].a;
+                        break;
+                    case Op::pow:
+                        if (is_constant(b, 1)) return a;
+                        if (is_constant(b, 2)) return node(Op::mul, a, a);
+                        if (is_constant(b, 0)) return constant(1);
+                        break;
+                    case Op::fma:
+                        if (is_constant(a, 0) || is_constant(b, 0)) return c;
+                        if (is_constant(c, 0)) return node(Op::mul, a, b);
+                        if (is_constant(a, 1)) return node(Op::add, b, c);
+                        if (is_constant(b, 1)) return node(Op::add, a, c);
+                        if (a > b) std::swap(a, b);
+                        break;
+                    default:
+                        break;
+                    }
+                }
+                const auto key = std::make_tuple(op, a, b, c);
+                const auto found = _operations.find(key);
+                if (found != _operations.end()) return found->second;
+                const unsigned int k = _push({ op, a, b, c, (T)0 });
+                _operations[key] = k;
+                return k;
+            };
+
+            ///Nodes of derivatives of `output` by `inputs` (nodes of inputs), built symbolically by a reverse sweep.
+            ///Partials are only built for operands that are not constant, and zero adjoints are never propagated.
+            inline std::vector<unsigned int> gradient(unsigned int output, const std::vector<unsigned int> &inputs)
+            {
+                const unsigned int zero = constant(0), one = constant(1);
+                std::vector<unsigned int> adjoint(output + 1, zero);
+                adjoint[output] = one;
+                auto accumulate = [&](unsigned int operand, unsigned int a, unsigned int partial) { adjoint[operand] = node(Op::add, adjoint[operand], node(Op::mul, a, partial)); };
+                for (unsigned int k = output + 1; k-- > 0;)
+                {
+                    const Node<T> n = _nodes[k]; //copy, nodes grow below
+                    const unsigned int a = adjoint[k];
+                    if (a == zero || n.op == Op::constant || n.op == Op::input) continue;
+                    const bool da = _nodes[n.a].op != Op::constant, db = n.b != none && _nodes[n.b].op != Op::constant, dc = n.c != none && _nodes[n.c].op != Op::constant;
+                    auto square = [&](unsigned int x) { return node(Op::mul, x, x); };
+                    switch (n.op)
+                    {
+                    case Op::add: if (da) accumulate(n.a, a, one); if (db) accumulate(n.b, a, one); break;
+                    case Op::sub: if (da) accumulate(n.a, a, one); if (db) accumulate(n.b, a, constant(-1)); break;
+                    case Op::mul: if (da) accumulate(n.a, a, n.b); if (db) accumulate(n.b, a, n.a); break;
+                    case Op::div: if (da) accumulate(n.a, a, node(Op::div, one, n.b)); if (db) accumulate(n.b, a, node(Op::neg, node(Op::div, k, n.b))); break;
+                    case Op::neg:   accumulate(n.a, a, constant(-1)); break;
+                    case Op::sign:  break;
+                    case Op::step:  break;
+                    case Op::sin:   accumulate(n.a, a, node(Op::cos, n.a)); break;
+                    case Op::cos:   accumulate(n.a, a, node(Op::neg, node(Op::sin, n.a))); break;
+                    case Op::tan:   accumulate(n.a, a, node(Op::add, one, square(k))); break;
+                    case Op::asin:  accumulate(n.a, a, node(Op::div, one, node(Op::sqrt, node(Op::sub, one, square(n.a))))); break;
+                    case Op::acos:  accumulate(n.a, a, node(Op::neg, node(Op::div, one, node(Op::sqrt, node(Op::sub, one, square(n.a)))))); break;
+                    case Op::atan:  accumulate(n.a, a, node(Op::div, one, node(Op::add, one, square(n.a)))); break;
+                    case Op::sinh:  accumulate(n.a, a, node(Op::cosh, n.a)); break;
+                    case Op::cosh:  accumulate(n.a, a, node(Op::sinh, n.a)); break;
+                    case Op::tanh:  accumulate(n.a, a, node(Op::sub, one, square(k))); break;
+                    case Op::asinh: accumulate(n.a, a, node(Op::div, one, node(Op::sqrt, node(Op::add, square(n.a), one)))); break;
+                    case Op::acosh: accumulate(n.a, a, node(Op::div, one, node(Op::sqrt, node(Op::sub, square(n.a), one)))); break;
+                    case Op::atanh: accumulate(n.a, a, node(Op::div, one, node(Op::sub, one, square(n.a)))); break;
+                    case Op::exp:   accumulate(n.a, a, k); break;
+                    case Op::log:   accumulate(n.a, a, node(Op::div, one, n.a)); break;
+                    case Op::log10: accumulate(n.a, a, node(Op::div, one, node(Op::mul, constant((T)2.3025850929940456840179914546843642L), n.a))); break;
+                    case Op::exp2:  accumulate(n.a, a, node(Op::mul, constant((T)0.6931471805599453094172321214581766L), k)); break;
+                    case Op::expm1: accumulate(n.a, a, node(Op::add, k, one)); break;
+                    case Op::log1p: accumulate(n.a, a, node(Op::div, one, node(Op::add, n.a, one))); break;
+                    case Op::log2:  accumulate(n.a, a, node(Op::div, one, node(Op::mul, constant((T)0.6931471805599453094172321214581766L), n.a))); break;
+                    case Op::sqrt:  accumulate(n.a, a, node(Op::div, constant((T)0.5), k)); break;
+                    case Op::cbrt:  accumulate(n.a, a, node(Op::div, k, node(Op::mul, constant(3), n.a))); break;
+                    case Op::erf:   accumulate(n.a, a, node(Op::mul, constant((T)1.1283791670955125738961589031215452L), node(Op::exp, node(Op::neg, square(n.a))))); break;
+                    case Op::erfc:  accumulate(n.a, a, node(Op::mul, constant((T)-1.1283791670955125738961589031215452L), node(Op::exp, node(Op::neg, square(n.a))))); break;
+                    case Op::fabs:  accumulate(n.a, a, node(Op::sign, n.a)); break;
+                    case Op::pow:
+                        if (da) accumulate(n.a, a, node(Op::mul, n.b, node(Op::pow, n.a, node(Op::sub, n.b, one))));
+                        if (db) accumulate(n.b, a, node(Op::mul, k, node(Op::log, n.a)));
+                        break;
+                    case Op::hypot: if (da) accumulate(n.a, a, node(Op::div, n.a, k)); if (db) accumulate(n.b, a, node(Op::div, n.b, k)); break;
+                    case Op::atan2:
+                    {
+                        const unsigned int r = node(Op::add, square(n.a), square(n.b));
+                        if (da) accumulate(n.a, a, node(Op::div, n.b, r));
+                        if (db) accumulate(n.b, a, node(Op::neg, node(Op::div, n.a, r)));
+                        break;
+                    }
+                    //Kinks follow Differentiable: ties and NaN in `a` select `b`
+                    case Op::fmin:
+                    case Op::fmax:
+                    {
+                        const unsigned int s = (n.op == Op::fmax) ? node(Op::step, node(Op::sub, n.a, n.b)) : node(Op::step, node(Op::sub, n.b, n.a));
+                        if (da) accumulate(n.a, a, s);
+                        if (db) accumulate(n.b, a, node(Op::sub, one, s));
+                        break;
+                    }
+                    case Op::fdim:
+                    {
+                        const unsigned int s = node(Op::step, node(Op::sub, n.a, n.b));
+                        if (da) accumulate(n.a, a, s);
+                        if (db) accumulate(n.b, a, node(Op::neg, s));
+                        break;
+                    }
+                    case Op::copysign: if (da) accumulate(n.a, a, node(Op::mul, node(Op::sign, n.a), node(Op::sign, n.b))); break;
+                    case Op::fma: if (da) accumulate(n.a, a, n.b); if (db) accumulate(n.b, a, n.a); if (dc) accumulate(n.c, a, one); break;
+                    default: break;
+                    }
+                }
+                std::vector<unsigned int> result(inputs.size());
+                for (std::size_t i = 0; i < inputs.size(); ++i) result[i] = (inputs[i] <= output) ? adjoint[inputs[i]] : zero;
+                return result;
+            };
+
+            ///Values of all nodes at `x`
+            inline std::vector<T> evaluate(const T *x) const
+            {
+                std::vector<T> v(_nodes.size());
+                for (std::size_t k = 0; k < _nodes.size(); ++k)
+                {
+                    const Node<T> &n = _nodes[k];
+                    if (n.op == Op::constant) v[k] = n.constant;
+                    else if (n.op == Op::input) v[k] = x[n.a];
+                    else v[k] = apply(n.op, v[n.a], (n.b == none) ? (T)0 : v[n.b], (n.c == none) ? (T)0 : v[n.c]);
+                }
+                return v;
+            };
+        };
+
+        ///Name of T in generated code
+        template<class T> inline const char *_type() noexcept;
+        template<> inline const char *_type<float>()       noexcept { return "float"; };
+        template<> inline const char *_type<double>()      noexcept { return "double"; };
+        template<> inline const char *_type<long double>() noexcept { return "long double"; };
+
+        ///Literal that reads back exactly
+        template<class T> inline std::string _literal(T c)
+        {
+            const std::string type = _type<T>();
+            if (c != c) return "std::numeric_limits<" + type + ">::quiet_NaN()";
+            if (std::isinf(c)) return std::string(c < 0 ? "-" : "") + "std::numeric_limits<" + type + ">::infinity()";
+            std::string s = io::to_string(Real<T>(c));
+            if (s.find_first_of(".e") == std::string::npos) s += ".0";
+            if (std::is_same<T, float>::value) s += 'f';
+            if (std::is_same<T, long double>::value) s += 'L';
+            return (c < 0 || std::signbit(c)) ? ("(" + s + ")") : s;
+        };
+
+        ///Function recorded from one evaluation over Symbol<T> inputs, compiled to straight-line C++.
+        ///@tparam T Base type, float, double or long double
+        template<class T>
+        class Kernel
+        {
+        private:
+            Graph<T> _graph;
+            std::vector<unsigned int> _inputs;
+            std::vector<unsigned int> _outputs;
+            std::vector<unsigned int> _jacobian; //row-major nodes of derivatives, built on first use
+
+            inline void _differentiate()
+            {
+                if (_jacobian.size() == _outputs.size() * _inputs.size()) return;
+                _jacobian.clear();
+                for (unsigned int output : _outputs)
+                {
+                    const std::vector<unsigned int> row = _graph.gradient(output, _inputs);
+                    _jacobian.insert(_jacobian.end(), row.begin(), row.end());
+                }
+            };
+
+            ///Emits function body computing `targets`, only nodes they depend on are emitted
+            inline void _emit(std::ostream &os, const std::vector<unsigned int> &targets, const std::vector<std::string> &names) const
+            {
+                const std::vector<Node<T>> &nodes = _graph.nodes();
+                std::vector<bool> live(nodes.size(), false);
+                for (unsigned int t : targets) live[t] = true;
+                for (std::size_t k = nodes.size(); k-- > 0;)
+                {
+                    if (!live[k] || nodes[k].op == Op::constant || nodes[k].op == Op::input) continue;
+                    live[nodes[k].a] = true;
+                    if (nodes[k].b != Graph<T>::none) live[nodes[k].b] = true;
+                    if (nodes[k].c != Graph<T>::none) live[nodes[k].c] = true;
+                }
+                auto name = [&](unsigned int k)
+                {
+                    if (nodes[k].op == Op::constant) return _literal(nodes[k].constant);
+                    if (nodes[k].op == Op::input) return "x[" + std::to_string(nodes[k].a) + "]";
+                    return "t" + std::to_string(k);
+                };
+                for (std::size_t k = 0; k < nodes.size(); ++k)
+                {
+                    const Node<T> &n = nodes[k];
+                    if (!live[k] || n.op == Op::constant || n.op == Op::input) continue;
+                    os << "    const " << _type<T>() << " t" << k << " = ";
+                    switch (n.op)
+                    {
+                    case Op::add: os << name(n.a) << " + " << name(n.b); break;
+                    case Op::sub: os << name(n.a) << " - " << name(n.b); break;
+                    case Op::mul: os << name(n.a) << " * " << name(n.b); break;
+                    case Op::div: os << name(n.a) << " / " << name(n.b); break;
+                    case Op::neg: os << "-" << name(n.a); break;
+                    case Op::sign: os << "std::copysign(" << _literal((T)1) << ", " << name(n.a) << ")"; break;
+                    case Op::step: os << "(" << name(n.a) << " > 0) ? " << _literal((T)1) << " : " << _literal((T)0); break;
+                    #define BD_CODEGEN_EMIT(f) case Op::f: os << "std::" #f "(" << name(n.a) << ")"; break;
+                    BD_CODEGEN_UNARY(BD_CODEGEN_EMIT)
+                    #undef BD_CODEGEN_EMIT
+                    #define BD_CODEGEN_EMIT(f) case Op::f: os << "std::" #f "(" << name(n.a) << ", " << name(n.b) << ")"; break;
+                    BD_CODEGEN_BINARY(BD_CODEGEN_EMIT)
+                    #undef BD_CODEGEN_EMIT
+                    #define BD_CODEGEN_EMIT(f) case Op::f: os << "std::" #f "(" << name(n.a) << ", " << name(n.b) << ", " << name(n.c) << ")"; break;
+                    BD_CODEGEN_TERNARY(BD_CODEGEN_EMIT)
+                    #undef BD_CODEGEN_EMIT
+                    default: break;
+                    }
+                    os << ";\n";
+                }
+                for (std::size_t i = 0; i < targets.size(); ++i) os << "    " << names[i] << " = " << name(targets[i]) << ";\n";
+            };
+
+        public:
+            ///Kernel of `inputs` variables
+            inline explicit Kernel(unsigned int inputs) { for (unsigned int i = 0; i < inputs; ++i) _inputs.push_back(_graph.input(i)); };
+            Kernel(const Kernel &other) = delete;
+            Kernel &operator=(const Kernel &other) = delete;
+
+            //Recording
+            inline Symbol<T> input(unsigned int i) noexcept { return Symbol<T>(&_graph, _inputs[i]); };
+            inline std::vector<Symbol<T>> inputs() { std::vector<Symbol<T>> x; for (unsigned int i = 0; i < _inputs.size(); ++i) x.push_back(input(i)); return x; };
+            ///Appends output, constants are allowed
+            inline void output(const Symbol<T> &y) { _outputs.push_back(y.node(_graph)); _jacobian.clear(); };
+
+            //Access
+            inline const Graph<T> &graph() const noexcept { return _graph; };
+            inline std::size_t inputs_size()  const noexcept { return _inputs.size(); };
+            inline std::size_t outputs_size() const noexcept { return _outputs.size(); };
+
+            ///Interprets the recorded function, `jacobian` is optional and row-major, outputs by inputs
+            inline void evaluate(const T *x, T *y, T *jacobian = nullptr)
+            {
+                if (jacobian != nullptr) _differentiate();
+                const std::vector<T> v = _graph.evaluate(x);
+                for (std::size_t r = 0; r < _outputs.size(); ++r) y[r] = v[_outputs[r]];
+                if (jacobian != nullptr) for (std::size_t k = 0; k < _jacobian.size(); ++k) jacobian[k] = v[_jacobian[k]];
+            };
+
+            ///C++ source of two functions: `void name(const T *x, T *y)` computing outputs,
+            ///and `void name_jacobian(const T *x, T *y, T *jacobian)` computing outputs and the row-major Jacobian.
+            ///Every node is computed once in each function, and nodes that neither function needs are left out.
+            inline std::string generate(const std::string &name)
+            {
+                _differentiate();
+                const char *type = _type<T>();
+                std::ostringstream os;
+                os << "//Generated by bd::codegen::Kernel::generate(), " << _inputs.size() << " inputs, " << _outputs.size() << " outputs\n";
+                os << "#include <cmath>\n#include <limits>\n\n";
+
+                std::vector<unsigned int> targets;
+                std::vector<std::string> names;
+                for (std::size_t r = 0; r < _outputs.size(); ++r) { targets.push_back(_outputs[r]); names.push_back("y[" + std::to_string(r) + "]"); }
+                os << "void " << name << "(const " << type << " *x, " << type << " *y) noexcept\n{\n";
+                _emit(os, targets, names);
+                os << "}\n\n";
+
+                for (std::size_t k = 0; k < _jacobian.size(); ++k) { targets.push_back(_jacobian[k]); names.push_back("jacobian[" + std::to_string(k) + "]"); }
+                os << "void " << name << "_jacobian(const " << type << " *x, " << type << " *y, " << type << " *jacobian) noexcept\n{\n";
+                _emit(os, targets, names);
+                os << "}\n";
+                return os.str();
+            };
+        };
+
+        ///Records `f` over `inputs` Symbol<T> inputs and returns C++ source of its kernel, see `Kernel::generate()`
+        ///@param f Function `std::vector<Symbol<T>>(const std::vector<Symbol<T>> &)`
+        template<class T, class F> inline std::string generate(const std::string &name, unsigned int inputs, const F &f)
+        {
+            Kernel<T> kernel(inputs);
+            for (const Symbol<T> &y : f(kernel.inputs())) kernel.output(y);
+            return kernel.generate(name);
+        };
+    }
+
+    ///Symbolic scalar, operations on it are recorded as nodes of a codegen::Graph instead of being computed.
+    ///Symbols converted from T are literal constants until combined with recorded ones.
+    ///Values are unknown while recording, so functions must not branch on them, and comparisons are not provided.
+    ///@tparam T Base type
+    template<class T>
+    class Symbol
+    {
+    public:
+        //Variables
+        codegen::Graph<T> *graph; //nullptr for literal constants
+        unsigned int index;       //node in graph
+        T constant;               //value of literal constant
+
+        //Constructors & assignment
+        inline explicit Symbol()                                    noexcept : graph(nullptr), index(0), constant(0)     {};
+        inline Symbol(const T &other)                               noexcept : graph(nullptr), index(0), constant(other) {};
+        inline Symbol(codegen::Graph<T> *graph, unsigned int index) noexcept : graph(graph),   index(index), constant(0) {};
+
+        ///Node of this symbol in `g`, literal constants are added to it
+        inline unsigned int node(codegen::Graph<T> &g) const { return (graph != nullptr) ? index : g.constant(constant); };
+
+        ///Records `op` applied to `a` and `b`, or folds it if both are literal constants
+        static inline Symbol apply(codegen::Op op, const Symbol &a, const Symbol &b)
+        {
+            codegen::Graph<T> *g = (a.graph != nullptr) ? a.graph : b.graph;
+            if (g == nullptr) return Symbol(codegen::Graph<T>::apply(op, a.constant, b.constant));
+            return Symbol(g, g->node(op, a.node(*g), b.node(*g)));
+        };
+        static inline Symbol apply(codegen::Op op, const Symbol &a)
+        {
+            if (a.graph == nullptr) return Symbol(codegen::Graph<T>::apply(op, a.constant));
+            return Symbol(a.graph, a.graph->node(op, a.index));
+        };
+        static inline Symbol apply(codegen::Op op, const Symbol &a, const Symbol &b, const Symbol &c)
+        {
+            codegen::Graph<T> *g = (a.graph != nullptr) ? a.graph : (b.graph != nullptr) ? b.graph : c.graph;
+            if (g == nullptr) return Symbol(codegen::Graph<T>::apply(op, a.constant, b.constant, c.constant));
+            return Symbol(g, g->node(op, a.node(*g), b.node(*g), c.node(*g)));
+        };
+
+        //Arithmetics
+        inline Symbol &operator+=(const Symbol &other) { return *this = apply(codegen::Op::add, *this, other); };
+        inline Symbol &operator-=(const Symbol &other) { return *this = apply(codegen::Op::sub, *this, other); };
+        inline Symbol &operator*=(const Symbol &other) { return *this = apply(codegen::Op::mul, *this, other); };
+        inline Symbol &operator/=(const Symbol &other) { return *this = apply(codegen::Op::div, *this, other); };
+
+        //Transformations
+        inline Symbol operator+() const { return *this; };
+        inline Symbol operator-() const { return apply(codegen::Op::neg, *this); };
+    };
+
+    //Basic arithmetics
+    template<class T> inline Symbol<T> operator+(const Symbol<T> &a, const Symbol<T> &b) { return Symbol<T>::apply(codegen::Op::add, a, b); };
+    template<class T> inline Symbol<T> operator-(const Symbol<T> &a, const Symbol<T> &b) { return Symbol<T>::apply(codegen::Op::sub, a, b); };
+    template<class T> inline Symbol<T> operator*(const Symbol<T> &a, const Symbol<T> &b) { return Symbol<T>::apply(codegen::Op::mul, a, b); };
+    template<class T> inline Symbol<T> operator/(const Symbol<T> &a, const Symbol<T> &b) { return Symbol<T>::apply(codegen::Op::div, a, b); };
+    template<class T> inline Symbol<T> operator+(const Symbol<T> &a, const typename _Constant<T>::type &b) { return Symbol<T>::apply(codegen::Op::add, a, b); };
+    template<class T> inline Symbol<T> operator-(const Symbol<T> &a, const typename _Constant<T>::type &b) { return Symbol<T>::apply(codegen::Op::sub, a, b); };
+    template<class T> inline Symbol<T> operator*(const Symbol<T> &a, const typename _Constant<T>::type &b) { return Symbol<T>::apply(codegen::Op::mul, a, b); };
+    template<class T> inline Symbol<T> operator/(const Symbol<T> &a, const typename _Constant<T>::type &b) { return Symbol<T>::apply(codegen::Op::div, a, b); };
+    template<class T> inline Symbol<T> operator+(const typename _Constant<T>::type &a, const Symbol<T> &b) { return Symbol<T>::apply(codegen::Op::add, a, b); };
+    template<class T> inline Symbol<T> operator-(const typename _Constant<T>::type &a, const Symbol<T> &b) { return Symbol<T>::apply(codegen::Op::sub, a, b); };
+    template<class T> inline Symbol<T> operator*(const typename _Constant<T>::type &a, const Symbol<T> &b) { return Symbol<T>::apply(codegen::Op::mul, a, b); };
+    template<class T> inline Symbol<T> operator/(const typename _Constant<T>::type &a, const Symbol<T> &b) { return Symbol<T>::apply(codegen::Op::div, a, b); };
+
+    //Functions
+    #define BD_CODEGEN_FUNCTION(f) template<class T> inline Symbol<T> f(const Symbol<T> &x) { return Symbol<T>::apply(codegen::Op::f, x); };
+    BD_CODEGEN_UNARY(BD_CODEGEN_FUNCTION)
+    #undef BD_CODEGEN_FUNCTION
+    #define BD_CODEGEN_FUNCTION(f) \
+        template<class T> inline Symbol<T> f(const Symbol<T> &a, const Symbol<T> &b)                    { return Symbol<T>::apply(codegen::Op::f, a, b); }; \
+        template<class T> inline Symbol<T> f(const Symbol<T> &a, const typename _Constant<T>::type &b) { return Symbol<T>::apply(codegen::Op::f, a, b); }; \
+        template<class T> inline Symbol<T> f(const typename _Constant<T>::type &a, const Symbol<T> &b) { return Symbol<T>::apply(codegen::Op::f, a, b); };
+    BD_CODEGEN_BINARY(BD_CODEGEN_FUNCTION)
+    #undef BD_CODEGEN_FUNCTION
+    #define BD_CODEGEN_FUNCTION(f) template<class T> inline Symbol<T> f(const Symbol<T> &a, const Symbol<T> &b, const Symbol<T> &c) { return Symbol<T>::apply(codegen::Op::f, a, b, c); };
+    BD_CODEGEN_TERNARY(BD_CODEGEN_FUNCTION)
+    #undef BD_CODEGEN_FUNCTION
+    template<class T> inline Symbol<T> abs(const Symbol<T> &x) { return fabs(x); };
+
+    //Defines
+    typedef Symbol<float> SFloat;
+    typedef Symbol<double> SDouble;
+    typedef Symbol<long double> SLongDouble;
+}
\ No newline at end of file
@@ -0,0 +1,152 @@
+#pragma once
+
+///Operation counters, enabled by defining `BD_INSTRUMENT` before including any header of the library.
+///`bd::Real` counts its arithmetics and functions, `bd::Differentiable` additionally counts iterations over derivatives.
+///Without `BD_INSTRUMENT` the hooks expand to nothing and this header declares nothing else.
+#ifndef BD_INSTRUMENT
+    #define BD_COUNT(operation, n) ((void)0)
+#else
+    #include <atomic>
+    #include <cstddef>
+    #include <cstdint>
+    #include <mutex>
+    #include <sstream>
+    #include <string>
+    #include <vector>
+
+    ///Adds `n` to the counter of `operation` of the calling thread
+    #define BD_COUNT(operation, n) (::bd::counters::_local().add(::bd::counters::Operation::operation, (std::uint64_t)(n)))
+
+    //List of counted operations
+    #define BD_OPERATIONS(X) \
+        X(add) X(sub) X(mul) X(div) \
+        X(cos) X(sin) X(tan) X(acos) X(asin) X(atan) X(atan2) \
+        X(cosh) X(sinh) X(tanh) X(acosh) X(asinh) X(atanh) \
+        X(exp) X(log) X(log10) X(exp2) X(expm1) X(log1p) X(log2) \
+        X(pow) X(sqrt) X(cbrt) X(hypot) X(fma) \
+        X(erf) X(erfc) X(tgamma) X(lgamma) \
+        X(derivative)
+
+    namespace bd
+    {
+        namespace counters
+        {
+            ///Counted operation, `derivative` counts single derivative updates of Differentiable
+            enum class Operation : unsigned int
+            {
+                #define BD_OPERATION(name) name,
+                BD_OPERATIONS(BD_OPERATION)
+                #undef BD_OPERATION
+            };
+            constexpr unsigned int operations = 0
+                #define BD_OPERATION(name) + 1
+                BD_OPERATIONS(BD_OPERATION)
+                #undef BD_OPERATION
+                ;
+
+            ///Name of `operation`, as used in JSON
+            inline const char *name(Operation operation) noexcept
+            {
+                static const char *const names[] =
+                {
+                    #define BD_OPERATION(name) #name,
+                    BD_OPERATIONS(BD_OPERATION)
+                    #undef BD_OPERATION
+                };
+                return names[(unsigned int)operation];
+            };
+
+            ///Plain copy of counters, result of snapshots, can be merged with `+=`
+            struct Counters
+            {
+                std::uint64_t count[operations] = {};
+
+                inline std::uint64_t &operator[](Operation operation)       noexcept { return count[(unsigned int)operation]; };
+                inline std::uint64_t operator[](Operation operation)  const noexcept { return count[(unsigned int)operation]; };
+                inline Counters &operator+=(const Counters &other) noexcept { for (unsigned int i = 0; i < operations; ++i) count[i] += other.count[i]; return *this; };
+                inline Counters &operator-=(const Counters &other) noexcept { for (unsigned int i = 0; i < operations; ++i) count[i] -= other.count[i]; return *this; };
+                inline Counters operator+(const Counters &other) const noexcept { Counters c = *this; return c += other; };
+                inline Counters operator-(const Counters &other) const noexcept { Counters c = *this; return c -= other; };
+
+                ///Flat JSON object `{"add": 1, ...}`, zero counters included so that dumps line up
+                inline std::string json() const
+                {
+                    std::ostringstream str;
+                    str << '{';
+                    for (unsigned int i = 0; i < operations; ++i) str << ((i == 0) ? "" : ", ") << '"' << name((Operation)i) << "\": " << count[i];
+                    str << '}';
+                    return str.str();
+                };
+            };
+
+            ///Counters of one thread. Only the owner writes, with relaxed load and store instead of atomic increments, so counting costs a plain add.
+            ///Other threads may read them at any time. The owner registers on first use and folds its counts into the retired total on exit.
+            class _Local
+            {
+            private:
+                std::atomic<std::uint64_t> _count[operations];
+
+            public:
+                ///All live threads and the sum of exited ones
+                struct Registry
+                {
+                    std::mutex mutex;
+                    std::vector<_Local*> live;
+                    Counters retired;
+                };
+                static inline Registry &registry() { static Registry r; return r; };
+
+                inline _Local()
+                {
+                    for (unsigned int i = 0; i < operations; ++i) _count[i].store(0, std::memory_order_relaxed);
+                    std::lock_guard<std::mutex> lock(registry().mutex);
+                    registry().live.push_back(this);
+                };
+                inline ~_Local()
+                {
+                    Registry &r = registry();
+                    std::lock_guard<std::mutex> lock(r.mutex);
+                    r.retired += get();
+                    for (std::size_t i = 0; i < r.live.size(); ++i) if (r.live[i] == this) { r.live[i] = r.live.back(); r.live.pop_back(); break; }
+                };
+
+                inline void add(Operation operation, std::uint64_t n) noexcept
+                {
+                    std::atomic<std::uint64_t> &c = _count[(unsigned int)operation];
+                    c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+                };
+                inline Counters get() const noexcept
+                {
+                    Counters c;
+                    for (unsigned int i = 0; i < operations; ++i) c.count[i] = _count[i].load(std::memory_order_relaxed);
+                    return c;
+                };
+                ///Only exact when called by the owner, a concurrent increment by the owner may be lost otherwise
+                inline void reset() noexcept { for (unsigned int i = 0; i < operations; ++i) _count[i].store(0, std::memory_order_relaxed); };
+            };
+            inline _Local &_local() { static thread_local _Local local; return local; };
+
+            ///Counters of the calling thread
+            inline Counters snapshot() { return _local().get(); };
+            ///Zeroes counters of the calling thread
+            inline void reset() { _local().reset(); };
+            ///Sum over all threads, including threads that have exited
+            inline Counters total()
+            {
+                _Local::Registry &r = _Local::registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                Counters c = r.retired;
+                for (const _Local *local : r.live) c += local->get();
+                return c;
+            };
+            ///Zeroes counters of all threads, call while no other thread is counting
+            inline void reset_total()
+            {
+                _Local::Registry &r = _Local::registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                r.retired = Counters();
+                for (_Local *local : r.live) local->reset();
+            };
+        }
+    }
+#endif
\ No newline at end of file
@@ -0,0 +1,194 @@
+#pragma once
+
+#include "differentiable.hpp"
+#include "real-batch.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+namespace bd
+{
+    //Predefine
+    template<class T, unsigned int N> class DifferentiableBatch;
+
+    ///Many values of Differentiable<T, N> stored as structure of arrays: one value plane followed by N derivative planes.
+    ///Arithmetics and functions apply lane-wise, derivative planes are updated with SIMD kernels.
+    ///Pays off for few derivatives, with many of them Differentiable<T, N> is already vectorized across derivatives.
+    ///Evaluate large inputs in chunks that fit in cache, every operation makes one pass over all planes.
+    ///@tparam T Base type
+    ///@tparam N Number of derivatives
+    template<class T, unsigned int N>
+    class DifferentiableBatch
+    {
+    public:
+        //Constants
+        static constexpr std::size_t block = 256; //lanes processed at once by functions, keeps partial derivatives in L1
+
+    private:
+        std::size_t _size;
+        std::size_t _stride;
+        simd::Buffer<T> _data; //(N + 1) planes of _stride elements
+
+    public:
+        //Kernels
+        ///Sets `v` to `f(x)` lane-wise, `f(x, dx)` returns value and writes the derivative to `dx`. `v` may be `x`.
+        template<class F> static inline void unary(DifferentiableBatch &v, const DifferentiableBatch &x, const F &f)
+        {
+            T d[block];
+            for (std::size_t k = 0; k < x._size; k += block)
+            {
+                const std::size_t m = (x._size - k < block) ? (x._size - k) : block;
+                for (std::size_t l = 0; l < m; ++l) v.value()[k + l] = f(x.value()[k + l], d[l]);
+                for (unsigned int i = 0; i < N; ++i) simd::mul(m, v.derivative(i) + k, x.derivative(i) + k, d);
+            }
+        };
+        ///Sets `v` to `f(a, b)` lane-wise, `f(a, b, da, db)` returns value and writes derivatives to `da` and `db`. `v` may be `a` or `b`.
+        template<class F> static inline void binary(DifferentiableBatch &v, const DifferentiableBatch &a, const DifferentiableBatch &b, const F &f)
+        {
+            assert(a._size == b._size);
+            T da[block], db[block];
+            for (std::size_t k = 0; k < a._size; k += block)
+            {
+                const std::size_t m = (a._size - k < block) ? (a._size - k) : block;
+                for (std::size_t l = 0; l < m; ++l) v.value()[k + l] = f(a.value()[k + l], b.value()[k + l], da[l], db[l]);
+                for (unsigned int i = 0; i < N; ++i) simd::combine(m, v.derivative(i) + k, a.derivative(i) + k, da, b.derivative(i) + k, db);
+            }
+        };
+
+        //Constructors & assignment
+        inline DifferentiableBatch()                                              noexcept : _size(0), _stride(0) {};
+        inline explicit DifferentiableBatch(std::size_t size)                              : _size(size), _stride(simd::stride<T>(size)), _data((N + 1) * _stride) {};
+        inline DifferentiableBatch(const DifferentiableBatch &other)                      = default;
+        inline DifferentiableBatch(DifferentiableBatch &&other)                   noexcept : _size(other._size), _stride(other._stride), _data(std::move(other._data)) { other._size = 0; other._stride = 0; };
+        inline DifferentiableBatch &operator=(const DifferentiableBatch &other)           = default;
+        inline DifferentiableBatch &operator=(DifferentiableBatch &&other)        noexcept { std::swap(_size, other._size); std::swap(_stride, other._stride); std::swap(_data, other._data); return *this; };
+        ///Batch of constants
+        inline explicit DifferentiableBatch(const RealBatch<T> &value)                     : DifferentiableBatch(value.size()) { std::copy(value.value(), value.value() + _size, this->value()); };
+        ///Batch over `size` lanes at `data` in the layout of `data()`, with planes `simd::stride<T>(size)` elements apart, e.g. data read by `io::BatchView`.
+        ///Nothing is copied and `data` stays owned by the caller: compound assignments and functions of moved views write to it, copies own their memory.
+        static inline DifferentiableBatch view(T *data, std::size_t size) noexcept
+        {
+            DifferentiableBatch v;
+            v._size = size;
+            v._stride = simd::stride<T>(size);
+            v._data = simd::Buffer<T>::wrap(data, (N + 1) * v._stride);
+            return v;
+        };
+
+        //Access
+        inline std::size_t size()                                           const noexcept { return _size; };
+        inline T *value()                                                         noexcept { return _data.data(); };
+        inline const T *value()                                             const noexcept { return _data.data(); };
+        inline T *derivative(unsigned int i)                                      noexcept { return _data.data() + (i + 1) * _stride; };
+        inline const T *derivative(unsigned int i)                          const noexcept { return _data.data() + (i + 1) * _stride; };
+        ///Value plane followed by N derivative planes, `stride()` elements apart
+        inline T *data()                                                          noexcept { return _data.data(); };
+        inline const T *data()                                              const noexcept { return _data.data(); };
+        inline std::size_t stride()                                         const noexcept { return _stride; };
+        inline Differentiable<T, N> get(std::size_t k)                      const noexcept
+        {
+            Differentiable<T, N> x;
+            x.value = value()[k];
+            for (unsigned int i = 0; i < N; ++i) x.derivative[i] = derivative(i)[k];
+            return x;
+        };
+        inline void set(std::size_t k, const Differentiable<T, N> &x)            noexcept
+        {
+            value()[k] = x.value;
+            for (unsigned int i = 0; i < N; ++i) derivative(i)[k] = x.derivative[i];
+        };
+
+        //Arithmetics, value and derivative planes are contiguous, so sums are a single kernel over all of them
+        inline DifferentiableBatch &operator+=(const DifferentiableBatch &other) noexcept { assert(_size == other._size); simd::add(_data.size(), _data.data(), _data.data(), other._data.data()); return *this; };
+        inline DifferentiableBatch &operator-=(const DifferentiableBatch &other) noexcept { assert(_size == other._size); simd::sub(_data.size(), _data.data(), _data.data(), other._data.data()); return *this; };
+        inline DifferentiableBatch &operator*=(const DifferentiableBatch &other) noexcept
+        {
+            assert(_size == other._size);
+            for (unsigned int i = 0; i < N; ++i) simd::combine(_size, derivative(i), derivative(i), other.value(), other.derivative(i), value());
+            simd::mul(_size, value(), value(), other.value());
+            return *this;
+        };
+        inline DifferentiableBatch &operator/=(const DifferentiableBatch &other) noexcept
+        {
+            binary(*this, *this, other, [](T a, T b, T &da, T &db) { const T r = 1 / b, v = a * r; da = r; db = -v * r; return v; });
+            return *this;
+        };
+
+        //Transformations
+        inline DifferentiableBatch operator+() const & { return *this; };
+        inline DifferentiableBatch operator+() &&      { return std::move(*this); };
+        inline DifferentiableBatch operator-() const & { DifferentiableBatch v = *this; return -std::move(v); };
+        inline DifferentiableBatch operator-() &&      { simd::scale(_data.size(), _data.data(), _data.data(), (T)-1); return std::move(*this); };
+    };
+
+    //Basic arithmetics, rvalue operands donate their buffers
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> operator+(DifferentiableBatch<T, N> a, const DifferentiableBatch<T, N> &b)  { return std::move(a += b); };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> operator+(const DifferentiableBatch<T, N> &a, DifferentiableBatch<T, N> &&b) { return std::move(b += a); };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> operator-(DifferentiableBatch<T, N> a, const DifferentiableBatch<T, N> &b)  { return std::move(a -= b); };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> operator-(const DifferentiableBatch<T, N> &a, DifferentiableBatch<T, N> &&b) { assert(a.size() == b.size()); simd::sub((N + 1) * b.stride(), b.data(), a.data(), b.data()); return std::move(b); };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> operator*(DifferentiableBatch<T, N> a, const DifferentiableBatch<T, N> &b)  { return std::move(a *= b); };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> operator*(const DifferentiableBatch<T, N> &a, DifferentiableBatch<T, N> &&b) { return std::move(b *= a); };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> operator/(DifferentiableBatch<T, N> a, const DifferentiableBatch<T, N> &b)  { return std::move(a /= b); };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> operator/(const DifferentiableBatch<T, N> &a, DifferentiableBatch<T, N> &&b) { DifferentiableBatch<T, N>::binary(b, a, b, [](T a, T b, T &da, T &db) { const T r = 1 / b, v = a * r; da = r; db = -v * r; return v; }); return std::move(b); };
+
+    //Trigonometric functions
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> cos  (DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::cos(x, d); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> sin  (DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::sin(x, d); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> tan  (DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::tan(x, d); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> acos (DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::acos(x, d); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> asin (DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::asin(x, d); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> atan (DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::atan(x, d); }); return x; };
+
+    //Hyperbolic functions
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> cosh (DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::cosh(x, d); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> sinh (DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::sinh(x, d); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> tanh (DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::tanh(x, d); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> acosh(DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::acosh(x, d); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> asinh(DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::asinh(x, d); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> atanh(DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::atanh(x, d); }); return x; };
+
+    //Exponential and logarithmic functions
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> exp  (DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::exp(x, d); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> log  (DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::log(x, d); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> log10(DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::log10(x, d); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> exp2 (DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::exp2(x, d); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> expm1(DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::expm1(x, d); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> log1p(DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::log1p(x, d); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> log2 (DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::log2(x, d); }); return x; };
+
+    //Power functions
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> pow  (DifferentiableBatch<T, N> base, const DifferentiableBatch<T, N> &exponent) { DifferentiableBatch<T, N>::binary(base, base, exponent, [](T a, T b, T &da, T &db) { return rules::pow(a, b, da, db); }); return base; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> sqrt (DifferentiableBatch<T, N> x)                                               { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::sqrt(x, d); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> cbrt (DifferentiableBatch<T, N> x)                                               { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::cbrt(x, d); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> hypot(DifferentiableBatch<T, N> x, const DifferentiableBatch<T, N> &y)           { DifferentiableBatch<T, N>::binary(x, x, y, [](T a, T b, T &da, T &db) { return rules::hypot(a, b, da, db); }); return x; };
+
+    //Error and gamma functions
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> erf   (DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::erf(x, d); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> erfc  (DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::erfc(x, d); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> tgamma(DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::tgamma(x, d); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> lgamma(DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::lgamma(x, d); }); return x; };
+
+    //Rounding and remainder functions
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> ceil     (DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { d = 0; return std::ceil     (x); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> floor    (DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { d = 0; return std::floor    (x); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> trunc    (DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { d = 0; return std::trunc    (x); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> round    (DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { d = 0; return std::round    (x); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> rint     (DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { d = 0; return std::rint     (x); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> nearbyint(DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { d = 0; return std::nearbyint(x); }); return x; };
+
+    //Minimum, maximum, difference functions
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> fdim(DifferentiableBatch<T, N> x, const DifferentiableBatch<T, N> &y) { DifferentiableBatch<T, N>::binary(x, x, y, [](T x, T y, T &dx, T &dy) { const bool p = x > y; dx = p ? 1 : 0; dy = p ? -1 : 0; return p ? (x - y) : (T)0; }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> fmax(DifferentiableBatch<T, N> x, const DifferentiableBatch<T, N> &y) { DifferentiableBatch<T, N>::binary(x, x, y, [](T x, T y, T &dx, T &dy) { const bool p = std::isnan(y) || (!std::isnan(x) && x > y); dx = p ? 1 : 0; dy = p ? 0 : 1; return p ? x : y; }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> fmin(DifferentiableBatch<T, N> x, const DifferentiableBatch<T, N> &y) { DifferentiableBatch<T, N>::binary(x, x, y, [](T x, T y, T &dx, T &dy) { const bool p = std::isnan(y) || (!std::isnan(x) && x < y); dx = p ? 1 : 0; dy = p ? 0 : 1; return p ? x : y; }); return x; };
+
+    //Other functions
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> fabs(DifferentiableBatch<T, N> x) { DifferentiableBatch<T, N>::unary(x, x, [](T x, T &d) { return rules::fabs(x, d); }); return x; };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> abs (DifferentiableBatch<T, N> x) { return fabs(std::move(x)); };
+    template<class T, unsigned int N> inline DifferentiableBatch<T, N> fma (DifferentiableBatch<T, N> x, const DifferentiableBatch<T, N> &y, const DifferentiableBatch<T, N> &z) { return std::move((x *= y) += z); };
+
+    //Defines
+    typedef DifferentiableBatch<float, 1> DFloatBatch;
+    typedef DifferentiableBatch<double, 1> DDoubleBatch;
+    typedef DifferentiableBatch<long double, 1> DLongDoubleBatch;
+}
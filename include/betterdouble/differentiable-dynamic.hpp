@@ -0,0 +1,295 @@
+#pragma once
+
+#include "differentiable.hpp"
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace bd
+{
+    ///Thread-local cache of heap buffers, grouped by power-of-two capacity.
+    ///Buffers released after the pool of the thread is destroyed (e.g. by static or thread-local values) are deleted directly.
+    ///@tparam T Element type
+    template<class T>
+    class BufferPool
+    {
+    public:
+        static constexpr unsigned int limit = 16; //buffers kept per capacity, further ones are deleted on release
+
+    private:
+        std::vector<T*> _free[sizeof(unsigned int) * 8];
+
+        static inline unsigned int _bucket(unsigned int capacity) noexcept { unsigned int b = 0; while ((1u << b) < capacity) ++b; return b; };
+        static inline BufferPool &_local() noexcept { static thread_local BufferPool pool; return pool; };
+        static inline bool &_destroyed() noexcept { static thread_local bool destroyed = false; return destroyed; };
+
+    public:
+        ///Returns buffer of at least `capacity` elements, `capacity` is updated to the actual size
+        static inline T *allocate(unsigned int &capacity)
+        {
+            const unsigned int bucket = _bucket(capacity);
+            capacity = 1u << bucket;
+            if (_destroyed()) return new T[capacity];
+            std::vector<T*> &list = _local()._free[bucket];
+            if (list.empty()) return new T[capacity];
+            T *data = list.back();
+            list.pop_back();
+            return data;
+        };
+
+        ///Returns buffer obtained with `allocate()` to the pool
+        static inline void release(T *data, unsigned int capacity) noexcept
+        {
+            if (_destroyed()) { delete[] data; return; }
+            std::vector<T*> &list = _local()._free[_bucket(capacity)];
+            if (list.size() >= limit) { delete[] data; return; }
+            try { list.push_back(data); }
+            catch (...) { delete[] data; }
+        };
+
+        ///Number of buffers of `capacity` kept by the pool of the calling thread
+        static inline std::size_t cached(unsigned int capacity) noexcept { return _destroyed() ? 0 : _local()._free[_bucket(capacity)].size(); };
+
+        inline ~BufferPool() { for (std::vector<T*> &list : _free) for (T *data : list) delete[] data; _destroyed() = true; };
+    };
+
+    ///Vector that stores up to S elements inline and larger sizes in pooled heap storage
+    ///@tparam T Element type
+    ///@tparam S Inline capacity
+    template<class T, unsigned int S = (64 / sizeof(T) > 0) ? (64 / sizeof(T)) : 1>
+    class SmallVector
+    {
+    private:
+        T *_data;
+        unsigned int _size;
+        unsigned int _capacity;
+        T _local[S];
+
+        inline void _release() noexcept { if (_data != _local) BufferPool<T>::release(_data, _capacity); _data = _local; _capacity = S; };
+
+    public:
+        //Constructors & assignment
+        inline SmallVector()                            noexcept : _data(_local), _size(0), _capacity(S) {};
+        inline explicit SmallVector(unsigned int size)           : SmallVector() { resize(size); };
+        inline SmallVector(const SmallVector &other)             : SmallVector() { *this = other; };
+        inline SmallVector(SmallVector &&other)         noexcept : SmallVector() { *this = std::move(other); };
+        inline ~SmallVector() { _release(); };
+        inline SmallVector &operator=(const SmallVector &other)
+        {
+            if (this == &other) return *this;
+            _size = 0;
+            reserve(other._size);
+            for (unsigned int i = 0; i < other._size; ++i) _data[i] = other._data[i];
+            _size = other._size;
+            return *this;
+        };
+        inline SmallVector &operator=(SmallVector &&other) noexcept
+        {
+            if (this == &other) return *this;
+            if (other._data == other._local)
+            {
+                for (unsigned int i = 0; i < other._size; ++i) _data[i] = other._local[i]; //capacity is never less than S
+                _size = other._size;
+            }
+            else
+            {
+                _release();
+                _data = other._data; _capacity = other._capacity; _size = other._size;
+                other._data = other._local; other._capacity = S;
+            }
+            other._size = 0;
+            return *this;
+        };
+
+        //Size
+        inline unsigned int size()     const noexcept { return _size; };
+        inline unsigned int capacity() const noexcept { return _capacity; };
+        inline void reserve(unsigned int capacity)
+        {
+            if (capacity <= _capacity) return;
+            T *data = BufferPool<T>::allocate(capacity);
+            for (unsigned int i = 0; i < _size; ++i) data[i] = _data[i];
+            _release();
+            _data = data; _capacity = capacity;
+        };
+        inline void resize(unsigned int size)
+        {
+            reserve(size);
+            for (unsigned int i = _size; i < size; ++i) _data[i] = 0;
+            _size = size;
+        };
+
+        //Access
+        inline       T &operator[](unsigned int i)       noexcept { return _data[i]; };
+        inline const T &operator[](unsigned int i) const noexcept { return _data[i]; };
+        inline       T *data()                           noexcept { return _data; };
+        inline const T *data()                     const noexcept { return _data; };
+    };
+
+    ///Same as double, but with overloaded operators, number of derivatives is chosen at runtime.
+    ///Constants have zero derivatives, variables of different sizes are padded with zeros.
+    ///@tparam T Base type
+    template<class T>
+    class Differentiable<T, Dynamic>
+    {
+    public:
+        //Variables
+        T value;
+        SmallVector<T> derivative;
+
+        //Constructors & assignment
+        inline explicit Differentiable()                                   noexcept : value(0)                                         {};
+        inline Differentiable(const T &other)                              noexcept : value(other)                                     {};
+        inline Differentiable(const T &other, unsigned int size)                    : value(other), derivative(size)                   {};
+        inline Differentiable(const Differentiable &other)                          : value(other.value), derivative(other.derivative) {};
+        inline Differentiable(Differentiable &&other)                      noexcept : value(other.value), derivative(std::move(other.derivative)) {};
+        inline Differentiable &operator=(const Differentiable &other)               { value = other.value; derivative = other.derivative; return *this; };
+        inline Differentiable &operator=(Differentiable &&other)           noexcept { value = other.value; derivative = std::move(other.derivative); return *this; };
+
+        //Kernels
+        ///Sets value and multiplies derivatives by `dthis`
+        inline Differentiable &scale(T value, T dthis) noexcept
+        {
+            this->value = value;
+            for (unsigned int i = 0; i < derivative.size(); ++i) derivative[i] *= dthis;
+            return *this;
+        };
+        ///Sets value and derivatives to `dthis * this' + dother * other'`
+        inline Differentiable &combine(T value, T dthis, const Differentiable &other, T dother)
+        {
+            this->value = value;
+            const unsigned int size = derivative.size(), other_size = other.derivative.size();
+            if (other_size > size) derivative.resize(other_size);
+            unsigned int i = 0;
+            for (; i < size && i < other_size; ++i) derivative[i] = dthis * derivative[i] + dother * other.derivative[i];
+            for (; i < size; ++i) derivative[i] *= dthis;
+            for (; i < other_size; ++i) derivative[i] = dother * other.derivative[i];
+            return *this;
+        };
+
+        //Increments/decrements
+        inline Differentiable &operator++()    noexcept { ++value; return *this; };
+        inline Differentiable &operator--()    noexcept { --value; return *this; };
+        inline Differentiable operator++ (int)          { Differentiable v = *this; ++value; return v; };
+        inline Differentiable operator-- (int)          { Differentiable v = *this; --value; return v; };
+
+        //Arithmetics
+        inline Differentiable &operator+=(const Differentiable &other)
+        {
+            value += other.value;
+            if (other.derivative.size() > derivative.size()) derivative.resize(other.derivative.size());
+            for (unsigned int i = 0; i < other.derivative.size(); ++i) derivative[i] += other.derivative[i];
+            return *this;
+        };
+        inline Differentiable &operator-=(const Differentiable &other)
+        {
+            value -= other.value;
+            if (other.derivative.size() > derivative.size()) derivative.resize(other.derivative.size());
+            for (unsigned int i = 0; i < other.derivative.size(); ++i) derivative[i] -= other.derivative[i];
+            return *this;
+        };
+        inline Differentiable &operator*=(const Differentiable &other) { return combine(value * other.value, other.value, other, value); };
+        inline Differentiable &operator/=(const Differentiable &other) { return combine(value / other.value, 1 / other.value, other, -value / (other.value * other.value)); };
+
+        //Transformations
+        inline Differentiable operator+() const & { return *this; };
+        inline Differentiable operator+() &&      { return std::move(*this); };
+        inline Differentiable operator-() const & { Differentiable v = *this; return std::move(v.scale(-value, -1)); };
+        inline Differentiable operator-() &&      { return std::move(scale(-value, -1)); };
+
+        //Cast
+        inline explicit operator T() const noexcept { return value; };
+    };
+
+    //Basic arithmetics, rvalue operands donate their buffers
+    template<class T> inline Differentiable<T, Dynamic> operator+(Differentiable<T, Dynamic> a, const Differentiable<T, Dynamic> &b)  { return std::move(a += b); };
+    template<class T> inline Differentiable<T, Dynamic> operator+(const Differentiable<T, Dynamic> &a, Differentiable<T, Dynamic> &&b) { return std::move(b += a); };
+    template<class T> inline Differentiable<T, Dynamic> operator-(Differentiable<T, Dynamic> a, const Differentiable<T, Dynamic> &b)  { return std::move(a -= b); };
+    template<class T> inline Differentiable<T, Dynamic> operator-(const Differentiable<T, Dynamic> &a, Differentiable<T, Dynamic> &&b) { return std::move(b.combine(a.value - b.value, -1, a, 1)); };
+    template<class T> inline Differentiable<T, Dynamic> operator*(Differentiable<T, Dynamic> a, const Differentiable<T, Dynamic> &b)  { return std::move(a *= b); };
+    template<class T> inline Differentiable<T, Dynamic> operator*(const Differentiable<T, Dynamic> &a, Differentiable<T, Dynamic> &&b) { return std::move(b *= a); };
+    template<class T> inline Differentiable<T, Dynamic> operator/(Differentiable<T, Dynamic> a, const Differentiable<T, Dynamic> &b)  { return std::move(a /= b); };
+    template<class T> inline Differentiable<T, Dynamic> operator/(const Differentiable<T, Dynamic> &a, Differentiable<T, Dynamic> &&b) { return std::move(b.combine(a.value / b.value, -a.value / (b.value * b.value), a, 1 / b.value)); };
+    template<class T> inline Differentiable<T, Dynamic> operator+(Differentiable<T, Dynamic> a, const typename _Constant<T>::type &b) { a.value += b; return a; };
+    template<class T> inline Differentiable<T, Dynamic> operator+(const typename _Constant<T>::type &a, Differentiable<T, Dynamic> b) { b.value += a; return b; };
+    template<class T> inline Differentiable<T, Dynamic> operator-(Differentiable<T, Dynamic> a, const typename _Constant<T>::type &b) { a.value -= b; return a; };
+    template<class T> inline Differentiable<T, Dynamic> operator-(const typename _Constant<T>::type &a, Differentiable<T, Dynamic> b) { return std::move(b.scale(a - b.value, -1)); };
+    template<class T> inline Differentiable<T, Dynamic> operator*(Differentiable<T, Dynamic> a, const typename _Constant<T>::type &b) { return std::move(a.scale(a.value * b, b)); };
+    template<class T> inline Differentiable<T, Dynamic> operator*(const typename _Constant<T>::type &a, Differentiable<T, Dynamic> b) { return std::move(b.scale(a * b.value, a)); };
+    template<class T> inline Differentiable<T, Dynamic> operator/(Differentiable<T, Dynamic> a, const typename _Constant<T>::type &b) { return std::move(a.scale(a.value / b, 1 / b)); };
+    template<class T> inline Differentiable<T, Dynamic> operator/(const typename _Constant<T>::type &a, Differentiable<T, Dynamic> b) { return std::move(b.scale(a / b.value, -a / (b.value * b.value))); };
+
+    //Trigonometric functions
+    template<class T> inline Differentiable<T, Dynamic> cos  (Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::cos(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Dynamic> sin  (Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::sin(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Dynamic> tan  (Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::tan(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Dynamic> acos (Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::acos(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Dynamic> asin (Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::asin(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Dynamic> atan (Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::atan(x.value, d); return std::move(x.scale(r, d)); };
+
+    //Hyperbolic functions
+    template<class T> inline Differentiable<T, Dynamic> cosh (Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::cosh(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Dynamic> sinh (Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::sinh(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Dynamic> tanh (Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::tanh(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Dynamic> acosh(Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::acosh(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Dynamic> asinh(Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::asinh(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Dynamic> atanh(Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::atanh(x.value, d); return std::move(x.scale(r, d)); };
+
+    //Exponential and logarithmic functions
+    template<class T> inline Differentiable<T, Dynamic> exp  (Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::exp(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Dynamic> log  (Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::log(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Dynamic> log10(Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::log10(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Dynamic> exp2 (Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::exp2(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Dynamic> expm1(Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::expm1(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Dynamic> log1p(Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::log1p(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Dynamic> log2 (Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::log2(x.value, d); return std::move(x.scale(r, d)); };
+
+    //Power functions
+    template<class T> inline Differentiable<T, Dynamic> pow  (Differentiable<T, Dynamic> base, const Differentiable<T, Dynamic> &exponent) { T da = 0, db = 0; const T r = rules::pow(base.value, exponent.value, da, db); return std::move(base.combine(r, da, exponent, db)); };
+    template<class T> inline Differentiable<T, Dynamic> sqrt (Differentiable<T, Dynamic> x)                                                  { T d = 0; const T r = rules::sqrt(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Dynamic> cbrt (Differentiable<T, Dynamic> x)                                                  { T d = 0; const T r = rules::cbrt(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Dynamic> hypot(Differentiable<T, Dynamic> x,    const Differentiable<T, Dynamic> &y)          { T da = 0, db = 0; const T r = rules::hypot(x.value, y.value, da, db); return std::move(x.combine(r, da, y, db)); };
+    template<class T> inline Differentiable<T, Dynamic> pow  (Differentiable<T, Dynamic> base, const typename _Constant<T>::type &exponent) { T da = 0, db = 0; const T r = rules::pow(base.value, exponent, da, db); return std::move(base.scale(r, da)); };
+    template<class T> inline Differentiable<T, Dynamic> pow  (const typename _Constant<T>::type &base, Differentiable<T, Dynamic> exponent) { T da = 0, db = 0; const T r = rules::pow(base, exponent.value, da, db); return std::move(exponent.scale(r, db)); };
+    template<class T> inline Differentiable<T, Dynamic> hypot(Differentiable<T, Dynamic> x,    const typename _Constant<T>::type &y)        { T da = 0, db = 0; const T r = rules::hypot(x.value, y, da, db); return std::move(x.scale(r, da)); };
+    template<class T> inline Differentiable<T, Dynamic> hypot(const typename _Constant<T>::type &x,    Differentiable<T, Dynamic> y)        { T da = 0, db = 0; const T r = rules::hypot(x, y.value, da, db); return std::move(y.scale(r, db)); };
+
+    //Error and gamma functions
+    template<class T> inline Differentiable<T, Dynamic> erf   (Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::erf(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Dynamic> erfc  (Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::erfc(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Dynamic> tgamma(Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::tgamma(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Dynamic> lgamma(Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::lgamma(x.value, d); return std::move(x.scale(r, d)); };
+
+    //Other functions
+    template<class T> inline Differentiable<T, Dynamic> fabs(Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::fabs(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Dynamic> abs (Differentiable<T, Dynamic> x) { T d = 0; const T r = rules::abs(x.value, d); return std::move(x.scale(r, d)); };
+
+    //Defines
+    typedef Differentiable<float, Dynamic> DFloatX;
+    typedef Differentiable<double, Dynamic> DDoubleX;
+    typedef Differentiable<long double, Dynamic> DLongDoubleX;
+}
+
+namespace std
+{
+    template<class C, class T> basic_ostream<C> &operator<<(basic_ostream<C> &os, const bd::Differentiable<T, bd::Dynamic> &x)
+    {
+        os << x.value;
+        for (unsigned int i = 0; i < x.derivative.size(); i++) { os << ' ' << x.derivative[i]; }
+        return os;
+    }
+
+    template<class T> std::string to_string(const bd::Differentiable<T, bd::Dynamic> &x)
+    {
+        std::stringstream str;
+        str << x;
+        return str.str();
+    }
+
+    template<class T> std::wstring to_wstring(const bd::Differentiable<T, bd::Dynamic> &x)
+    {
+        std::wstringstream str;
+        str << x;
+        return str.str();
+    }
+};
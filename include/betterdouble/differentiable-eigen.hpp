@@ -1,14 +1,16 @@
 #pragma once
 
 #include "differentiable.hpp"
+#include "differentiable-dynamic.hpp"
+#include "differentiable-sparse.hpp"
 #include <Eigen/Core>
 
-template<class T, unsigned int N> struct Eigen::NumTraits<bd::Differentiable<T, N>>
+template<class T, unsigned int N, class D> struct Eigen::NumTraits<bd::Differentiable<T, N, D>>
 {
-    typedef bd::Differentiable<T, N> Real;
-    typedef bd::Differentiable<T, N> NonInteger;
-    typedef bd::Differentiable<T, N> Literal;
-    typedef bd::Differentiable<T, N> Nested;
+    typedef bd::Differentiable<T, N, D> Real;
+    typedef bd::Differentiable<T, N, D> NonInteger;
+    typedef bd::Differentiable<T, N, D> Literal;
+    typedef bd::Differentiable<T, N, D> Nested;
 
     enum
     {
@@ -18,17 +20,107 @@ template<class T, unsigned int N> struct Eigen::NumTraits<bd::Differentiable<T,
         ReadCost = 1,
         AddCost = 3,
         MulCost = 3,
-        RequireInitialization = 0
+        RequireInitialization = (N == bd::Dynamic || N == bd::Sparse) ? 1 : 0 //dynamic and sparse derivatives own memory
     };
 
-    static constexpr inline bd::Differentiable<T, N> epsilon        () noexcept { return (bd::Differentiable<T, N>)std::numeric_limits<T>::epsilon(); }
-    static constexpr inline bd::Differentiable<T, N> dummy_precision() noexcept { return (bd::Differentiable<T, N>)std::numeric_limits<T>::epsilon(); }
-    static constexpr inline bd::Differentiable<T, N> highest        () noexcept { return (bd::Differentiable<T, N>)std::numeric_limits<T>::infinity(); }
-    static constexpr inline bd::Differentiable<T, N> lowest         () noexcept { return (bd::Differentiable<T, N>)-std::numeric_limits<T>::infinity(); }
+    static constexpr inline bd::Differentiable<T, N, D> epsilon        () noexcept { return (bd::Differentiable<T, N, D>)std::numeric_limits<T>::epsilon(); }
+    static constexpr inline bd::Differentiable<T, N, D> dummy_precision() noexcept { return (bd::Differentiable<T, N, D>)std::numeric_limits<T>::epsilon(); }
+    static constexpr inline bd::Differentiable<T, N, D> highest        () noexcept { return (bd::Differentiable<T, N, D>)std::numeric_limits<T>::infinity(); }
+    static constexpr inline bd::Differentiable<T, N, D> lowest         () noexcept { return (bd::Differentiable<T, N, D>)-std::numeric_limits<T>::infinity(); }
     static constexpr inline int                      digits         () noexcept { return std::numeric_limits<T>::digits; }
     static constexpr inline int                      digits10       () noexcept { return std::numeric_limits<T>::digits10; }
     static constexpr inline int                      min_exponent   () noexcept { return std::numeric_limits<T>::min_exponent; }
     static constexpr inline int                      max_exponent   () noexcept { return std::numeric_limits<T>::max_exponent; }
-    static constexpr inline bd::Differentiable<T, N> infinity       () noexcept { return (bd::Differentiable<T, N>)std::numeric_limits<T>::infinity(); }
-    static constexpr inline bd::Differentiable<T, N> quiet_NaN      () noexcept { return (bd::Differentiable<T, N>)std::numeric_limits<T>::quiet_NaN(); }
-};
\ No newline at end of file
+    static constexpr inline bd::Differentiable<T, N, D> infinity       () noexcept { return (bd::Differentiable<T, N, D>)std::numeric_limits<T>::infinity(); }
+    static constexpr inline bd::Differentiable<T, N, D> quiet_NaN      () noexcept { return (bd::Differentiable<T, N, D>)std::numeric_limits<T>::quiet_NaN(); }
+};
+
+//Mixed expressions with base type matrices use the mixed operators instead of promoting constants
+template<class T, unsigned int N, class D, class Op> struct Eigen::ScalarBinaryOpTraits<bd::Differentiable<T, N, D>, T, Op> { typedef bd::Differentiable<T, N, D> ReturnType; };
+template<class T, unsigned int N, class D, class Op> struct Eigen::ScalarBinaryOpTraits<T, bd::Differentiable<T, N, D>, Op> { typedef bd::Differentiable<T, N, D> ReturnType; };
+
+namespace bd
+{
+    //Products of base type matrices with Differentiable matrices, evaluated as one product of the base type matrix with value and derivative planes
+    //instead of a product rule per scalar. Dynamic and sparse derivatives are promoted instead.
+    template<unsigned int N, bool Left> using _PlaneSide = std::integral_constant<int, (N == Dynamic || N == Sparse) ? 0 : (Left ? 1 : 2)>;
+
+    ///Adds `alpha * lhs * rhs` to `dst`, promoting the base type operand
+    template<class T, unsigned int N, class Dest, class Lhs, class Rhs> void _plane_product(Dest &dst, const Lhs &lhs, const Rhs &rhs, const Differentiable<T, N> &alpha, std::integral_constant<int, 0>)
+    {
+        const Eigen::Matrix<Differentiable<T, N>, Eigen::Dynamic, Eigen::Dynamic> product = lhs.template cast<Differentiable<T, N>>() * rhs.template cast<Differentiable<T, N>>();
+        dst += alpha * product;
+    };
+
+    ///Adds `alpha * lhs * rhs` to `dst`, `lhs` is Differentiable and its derivatives are stacked vertically
+    template<class T, unsigned int N, class Dest, class Lhs, class Rhs> void _plane_product(Dest &dst, const Lhs &lhs, const Rhs &rhs, const Differentiable<T, N> &alpha, std::integral_constant<int, 1>)
+    {
+        const Eigen::Index rows = lhs.rows(), cols = lhs.cols();
+        Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> planes((N + 1) * rows, cols);
+        for (Eigen::Index c = 0; c < cols; ++c)
+            for (Eigen::Index r = 0; r < rows; ++r) { planes(r, c) = lhs(r, c).value; for (unsigned int i = 0; i < N; ++i) planes((i + 1) * rows + r, c) = lhs(r, c).derivative[i]; }
+        const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> product = planes * rhs;
+        for (Eigen::Index c = 0; c < product.cols(); ++c)
+            for (Eigen::Index r = 0; r < rows; ++r) { Differentiable<T, N> v = product(r, c); for (unsigned int i = 0; i < N; ++i) v.derivative[i] = product((i + 1) * rows + r, c); dst(r, c) += alpha * v; }
+    };
+
+    ///Adds `alpha * lhs * rhs` to `dst`, `rhs` is Differentiable and its derivatives are stacked horizontally
+    template<class T, unsigned int N, class Dest, class Lhs, class Rhs> void _plane_product(Dest &dst, const Lhs &lhs, const Rhs &rhs, const Differentiable<T, N> &alpha, std::integral_constant<int, 2>)
+    {
+        const Eigen::Index rows = rhs.rows(), cols = rhs.cols();
+        Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> planes(rows, (N + 1) * cols);
+        for (Eigen::Index c = 0; c < cols; ++c)
+            for (Eigen::Index r = 0; r < rows; ++r) { planes(r, c) = rhs(r, c).value; for (unsigned int i = 0; i < N; ++i) planes(r, (i + 1) * cols + c) = rhs(r, c).derivative[i]; }
+        const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> product = lhs * planes;
+        for (Eigen::Index c = 0; c < cols; ++c)
+            for (Eigen::Index r = 0; r < product.rows(); ++r) { Differentiable<T, N> v = product(r, c); for (unsigned int i = 0; i < N; ++i) v.derivative[i] = product(r, (i + 1) * cols + c); dst(r, c) += alpha * v; }
+    };
+}
+
+namespace Eigen
+{
+    namespace internal
+    {
+        //Matrix-vector products of plain matrices, other expressions take the generic mixed path
+        template<class T, unsigned int N, int R0, int C0, int O0, int MR0, int MC0, int R1, int C1, int O1, int MR1, int MC1>
+        struct generic_product_impl<Matrix<T, R0, C0, O0, MR0, MC0>, Matrix<bd::Differentiable<T, N>, R1, C1, O1, MR1, MC1>, DenseShape, DenseShape, GemvProduct>
+            : generic_product_impl_base<Matrix<T, R0, C0, O0, MR0, MC0>, Matrix<bd::Differentiable<T, N>, R1, C1, O1, MR1, MC1>, generic_product_impl<Matrix<T, R0, C0, O0, MR0, MC0>, Matrix<bd::Differentiable<T, N>, R1, C1, O1, MR1, MC1>, DenseShape, DenseShape, GemvProduct>>
+        {
+            template<class Dest> static inline void scaleAndAddTo(Dest &dst, const Matrix<T, R0, C0, O0, MR0, MC0> &lhs, const Matrix<bd::Differentiable<T, N>, R1, C1, O1, MR1, MC1> &rhs, const bd::Differentiable<T, N> &alpha) { bd::_plane_product(dst, lhs, rhs, alpha, bd::_PlaneSide<N, false>()); };
+        };
+        template<class T, unsigned int N, int R0, int C0, int O0, int MR0, int MC0, int R1, int C1, int O1, int MR1, int MC1>
+        struct generic_product_impl<Matrix<bd::Differentiable<T, N>, R0, C0, O0, MR0, MC0>, Matrix<T, R1, C1, O1, MR1, MC1>, DenseShape, DenseShape, GemvProduct>
+            : generic_product_impl_base<Matrix<bd::Differentiable<T, N>, R0, C0, O0, MR0, MC0>, Matrix<T, R1, C1, O1, MR1, MC1>, generic_product_impl<Matrix<bd::Differentiable<T, N>, R0, C0, O0, MR0, MC0>, Matrix<T, R1, C1, O1, MR1, MC1>, DenseShape, DenseShape, GemvProduct>>
+        {
+            template<class Dest> static inline void scaleAndAddTo(Dest &dst, const Matrix<bd::Differentiable<T, N>, R0, C0, O0, MR0, MC0> &lhs, const Matrix<T, R1, C1, O1, MR1, MC1> &rhs, const bd::Differentiable<T, N> &alpha) { bd::_plane_product(dst, lhs, rhs, alpha, bd::_PlaneSide<N, true>()); };
+        };
+
+        //Matrix-matrix products replace the blocked kernel, which has no mixed Differentiable packets, row-major results are transposed by Eigen into these
+        template<class Index, class T, unsigned int N, int LhsOrder, bool ConjugateLhs, int RhsOrder, bool ConjugateRhs, int ResInnerStride>
+        struct general_matrix_matrix_product<Index, T, LhsOrder, ConjugateLhs, bd::Differentiable<T, N>, RhsOrder, ConjugateRhs, ColMajor, ResInnerStride>
+        {
+            typedef gebp_traits<T, bd::Differentiable<T, N>> Traits;
+            static void run(Index rows, Index cols, Index depth, const T *lhs, Index lhsStride, const bd::Differentiable<T, N> *rhs, Index rhsStride, bd::Differentiable<T, N> *res, Index resIncr, Index resStride,
+                bd::Differentiable<T, N> alpha, level3_blocking<T, bd::Differentiable<T, N>> &, GemmParallelInfo<Index> * = 0)
+            {
+                const Map<const Matrix<T, Dynamic, Dynamic, LhsOrder>, 0, OuterStride<>> a(lhs, rows, depth, OuterStride<>(lhsStride));
+                const Map<const Matrix<bd::Differentiable<T, N>, Dynamic, Dynamic, RhsOrder>, 0, OuterStride<>> b(rhs, depth, cols, OuterStride<>(rhsStride));
+                Map<Matrix<bd::Differentiable<T, N>, Dynamic, Dynamic>, 0, Stride<Dynamic, Dynamic>> c(res, rows, cols, Stride<Dynamic, Dynamic>(resStride, resIncr));
+                bd::_plane_product(c, a, b, alpha, bd::_PlaneSide<N, false>());
+            };
+        };
+        template<class Index, class T, unsigned int N, int LhsOrder, bool ConjugateLhs, int RhsOrder, bool ConjugateRhs, int ResInnerStride>
+        struct general_matrix_matrix_product<Index, bd::Differentiable<T, N>, LhsOrder, ConjugateLhs, T, RhsOrder, ConjugateRhs, ColMajor, ResInnerStride>
+        {
+            typedef gebp_traits<bd::Differentiable<T, N>, T> Traits;
+            static void run(Index rows, Index cols, Index depth, const bd::Differentiable<T, N> *lhs, Index lhsStride, const T *rhs, Index rhsStride, bd::Differentiable<T, N> *res, Index resIncr, Index resStride,
+                bd::Differentiable<T, N> alpha, level3_blocking<bd::Differentiable<T, N>, T> &, GemmParallelInfo<Index> * = 0)
+            {
+                const Map<const Matrix<bd::Differentiable<T, N>, Dynamic, Dynamic, LhsOrder>, 0, OuterStride<>> a(lhs, rows, depth, OuterStride<>(lhsStride));
+                const Map<const Matrix<T, Dynamic, Dynamic, RhsOrder>, 0, OuterStride<>> b(rhs, depth, cols, OuterStride<>(rhsStride));
+                Map<Matrix<bd::Differentiable<T, N>, Dynamic, Dynamic>, 0, Stride<Dynamic, Dynamic>> c(res, rows, cols, Stride<Dynamic, Dynamic>(resStride, resIncr));
+                bd::_plane_product(c, a, b, alpha, bd::_PlaneSide<N, true>());
+            };
+        };
+    }
+}
\ No newline at end of file
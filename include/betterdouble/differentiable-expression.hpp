@@ -0,0 +1,185 @@
+#pragma once
+
+#include "differentiable.hpp"
+#include <type_traits>
+
+namespace bd
+{
+    ///Base of lazily evaluated expressions of differentiable values.
+    ///Nodes cache their value on construction, derivatives are evaluated slot by slot on conversion, so the whole expression takes one loop over N.
+    ///Nodes hold their subexpressions by value and variables by reference, do not store them in `auto` variables.
+    ///@tparam E Derived expression type
+    template<class E>
+    class Expression
+    {
+    public:
+        //Cast
+        template<class T, unsigned int N> constexpr inline operator Differentiable<T, N>() const noexcept
+        {
+            static_assert(std::is_same<T, typename E::Scalar>::value && N == E::size, "Expression type mismatch");
+            const E &self = static_cast<const E&>(*this);
+            Differentiable<T, N> v;
+            v.value = self.value;
+            for (unsigned int i = 0; i < N; ++i) v.derivative[i] = self.slot(i);
+            return v;
+        };
+    };
+
+    ///Leaf of expression, references a differentiable variable
+    template<class T, unsigned int N>
+    class Reference : public Expression<Reference<T, N>>
+    {
+    public:
+        typedef T Scalar;
+        static constexpr unsigned int size = N;
+        const Differentiable<T, N> &x;
+        T value;
+
+        constexpr inline explicit Reference(const Differentiable<T, N> &x) noexcept : x(x), value(x.value) {};
+        constexpr inline T slot(unsigned int i) const noexcept { return x.derivative[i]; };
+    };
+
+    ///Node `f(a)`, derivatives are `da * a'`
+    template<class A>
+    class Scaled : public Expression<Scaled<A>>
+    {
+    public:
+        typedef typename A::Scalar Scalar;
+        static constexpr unsigned int size = A::size;
+        A a;
+        Scalar value, da;
+
+        constexpr inline Scaled(const Scalar &value, const A &a, const Scalar &da) noexcept : a(a), value(value), da(da) {};
+        constexpr inline Scalar slot(unsigned int i) const noexcept { return da * a.slot(i); };
+    };
+
+    ///Node `a + b` or `a - b`
+    ///@tparam S Sign of `b`, `1` or `-1`
+    template<class A, class B, int S>
+    class Sum : public Expression<Sum<A, B, S>>
+    {
+    public:
+        static_assert(std::is_same<typename A::Scalar, typename B::Scalar>::value && A::size == B::size, "Expression type mismatch");
+        typedef typename A::Scalar Scalar;
+        static constexpr unsigned int size = A::size;
+        A a;
+        B b;
+        Scalar value;
+
+        constexpr inline Sum(const Scalar &value, const A &a, const B &b) noexcept : a(a), b(b), value(value) {};
+        constexpr inline Scalar slot(unsigned int i) const noexcept { return (S > 0) ? (a.slot(i) + b.slot(i)) : (a.slot(i) - b.slot(i)); };
+    };
+
+    ///Node `f(a, b)`, derivatives are `da * a' + db * b'`
+    template<class A, class B>
+    class Combined : public Expression<Combined<A, B>>
+    {
+    public:
+        static_assert(std::is_same<typename A::Scalar, typename B::Scalar>::value && A::size == B::size, "Expression type mismatch");
+        typedef typename A::Scalar Scalar;
+        static constexpr unsigned int size = A::size;
+        A a;
+        B b;
+        Scalar value, da, db;
+
+        constexpr inline Combined(const Scalar &value, const A &a, const Scalar &da, const B &b, const Scalar &db) noexcept : a(a), b(b), value(value), da(da), db(db) {};
+        constexpr inline Scalar slot(unsigned int i) const noexcept { return da * a.slot(i) + db * b.slot(i); };
+    };
+
+    //Operands
+    template<class T, unsigned int N> constexpr inline Reference<T, N> operand(const Differentiable<T, N> &x) noexcept { return Reference<T, N>(x); };
+    template<class E>                 constexpr inline const E        &operand(const Expression<E> &x)        noexcept { return static_cast<const E&>(x); };
+    template<class T, unsigned int N> std::integral_constant<bool, N != Dynamic && N != Sparse> is_operand(const Differentiable<T, N>*);
+    template<class E>                 std::true_type                                           is_operand(const Expression<E>*);
+                                      std::false_type                                          is_operand(...);
+    template<class X> struct IsOperand : decltype(is_operand((const X*)nullptr)) {};
+    template<class X> using Operand = typename std::decay<decltype(operand(std::declval<const X&>()))>::type;
+    template<class A, class B = A> using EnableOperands = typename std::enable_if<IsOperand<A>::value && IsOperand<B>::value>::type;
+
+    ///Lazy version of `Differentiable`, operations on it build expressions that are evaluated on assignment in one pass
+    ///@tparam T Base type
+    ///@tparam N Number of derivatives
+    template<class T, unsigned int N>
+    class Lazy : public Differentiable<T, N>
+    {
+    public:
+        //Constructors & assignment
+        using Differentiable<T, N>::Differentiable;
+        constexpr inline explicit Lazy() noexcept : Differentiable<T, N>() {};
+        constexpr inline Lazy(const Differentiable<T, N> &other) noexcept : Differentiable<T, N>(other) {};
+        template<class E> constexpr inline Lazy(const Expression<E> &expression) noexcept : Differentiable<T, N>() { *this = expression; };
+        template<class E> constexpr inline Lazy &operator=(const Expression<E> &expression) noexcept
+        {
+            static_assert(std::is_same<T, typename E::Scalar>::value && N == E::size, "Expression type mismatch");
+            const E &self = static_cast<const E&>(expression);
+            for (unsigned int i = 0; i < N; ++i) this->derivative[i] = self.slot(i); //each slot reads only slot i of variables, so aliasing is safe
+            this->value = self.value;
+            return *this;
+        };
+    };
+
+    ///Wraps variable into expression, so that the operations on it are fused
+    template<class T, unsigned int N> constexpr inline Reference<T, N> lazy(const Differentiable<T, N> &x) noexcept { return Reference<T, N>(x); };
+
+    //Basic arithmetics
+    template<class A, class B, class = EnableOperands<A, B>> constexpr inline Sum<Operand<A>, Operand<B>,  1> operator+(const A &a, const B &b) noexcept { return Sum<Operand<A>, Operand<B>,  1>(operand(a).value + operand(b).value, operand(a), operand(b)); };
+    template<class A, class B, class = EnableOperands<A, B>> constexpr inline Sum<Operand<A>, Operand<B>, -1> operator-(const A &a, const B &b) noexcept { return Sum<Operand<A>, Operand<B>, -1>(operand(a).value - operand(b).value, operand(a), operand(b)); };
+    template<class A, class B, class = EnableOperands<A, B>> constexpr inline Combined<Operand<A>, Operand<B>> operator*(const A &a, const B &b) noexcept { const auto x = operand(a).value, y = operand(b).value; return Combined<Operand<A>, Operand<B>>(x * y, operand(a), y, operand(b), x); };
+    template<class A, class B, class = EnableOperands<A, B>> constexpr inline Combined<Operand<A>, Operand<B>> operator/(const A &a, const B &b) noexcept { const auto x = operand(a).value, y = operand(b).value; return Combined<Operand<A>, Operand<B>>(x / y, operand(a), 1 / y, operand(b), -x / (y * y)); };
+    template<class E> constexpr inline Scaled<E> operator-(const Expression<E> &x) noexcept { return Scaled<E>(-operand(x).value, operand(x), -1); };
+
+    //Comparison
+    template<class A, class B, class = EnableOperands<A, B>> constexpr inline bool operator==(const A &a, const B &b) noexcept { return operand(a).value == operand(b).value; };
+    template<class A, class B, class = EnableOperands<A, B>> constexpr inline bool operator!=(const A &a, const B &b) noexcept { return operand(a).value != operand(b).value; };
+    template<class A, class B, class = EnableOperands<A, B>> constexpr inline bool operator> (const A &a, const B &b) noexcept { return operand(a).value >  operand(b).value; };
+    template<class A, class B, class = EnableOperands<A, B>> constexpr inline bool operator< (const A &a, const B &b) noexcept { return operand(a).value <  operand(b).value; };
+    template<class A, class B, class = EnableOperands<A, B>> constexpr inline bool operator>=(const A &a, const B &b) noexcept { return operand(a).value >= operand(b).value; };
+    template<class A, class B, class = EnableOperands<A, B>> constexpr inline bool operator<=(const A &a, const B &b) noexcept { return operand(a).value <= operand(b).value; };
+
+    //Trigonometric functions
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> cos  (const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::cos(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> sin  (const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::sin(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> tan  (const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::tan(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> acos (const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::acos(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> asin (const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::asin(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> atan (const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::atan(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+
+    //Hyperbolic functions
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> cosh (const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::cosh(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> sinh (const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::sinh(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> tanh (const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::tanh(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> acosh(const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::acosh(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> asinh(const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::asinh(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> atanh(const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::atanh(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+
+    //Exponential and logarithmic functions
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> exp  (const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::exp(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> log  (const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::log(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> log10(const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::log10(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> exp2 (const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::exp2(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> expm1(const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::expm1(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> log1p(const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::log1p(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> log2 (const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::log2(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+
+    //Power functions
+    template<class A, class B, class = EnableOperands<A, B>> constexpr inline Combined<Operand<A>, Operand<B>> pow(const A &a, const B &b) noexcept { typename Operand<A>::Scalar da = 0, db = 0; const auto r = rules::pow(operand(a).value, operand(b).value, da, db); return Combined<Operand<A>, Operand<B>>(r, operand(a), da, operand(b), db); };
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> sqrt (const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::sqrt(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> cbrt (const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::cbrt(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class B, class = EnableOperands<A, B>> constexpr inline Combined<Operand<A>, Operand<B>> hypot(const A &a, const B &b) noexcept { typename Operand<A>::Scalar da = 0, db = 0; const auto r = rules::hypot(operand(a).value, operand(b).value, da, db); return Combined<Operand<A>, Operand<B>>(r, operand(a), da, operand(b), db); };
+
+    //Error and gamma functions
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> erf   (const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::erf(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> erfc  (const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::erfc(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> tgamma(const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::tgamma(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> lgamma(const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::lgamma(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+
+    //Other functions
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> fabs(const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::fabs(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class = EnableOperands<A>> constexpr inline Scaled<Operand<A>> abs (const A &a) noexcept { typename Operand<A>::Scalar d = 0; const auto r = rules::abs(operand(a).value, d); return Scaled<Operand<A>>(r, operand(a), d); };
+    template<class A, class B, class C, class = EnableOperands<A, B>, class = EnableOperands<C>> constexpr inline auto fma(const A &a, const B &b, const C &c) noexcept { return a * b + c; };
+
+    //Defines
+    template<unsigned int N> using LFloat = Lazy<float, N>;
+    template<unsigned int N> using LDouble = Lazy<double, N>;
+    template<unsigned int N> using LLongDouble = Lazy<long double, N>;
+}
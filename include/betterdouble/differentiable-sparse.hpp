@@ -0,0 +1,269 @@
+#pragma once
+
+#include "differentiable-dynamic.hpp"
+#include <utility>
+
+namespace bd
+{
+    ///Same as double, but with overloaded operators, only nonzero derivatives are stored.
+    ///Derivatives are kept as sorted (index, value) pairs and switch to dense storage once there are at least `threshold` of them and they fill `1 / density` of their span,
+    ///so dense storage never holds more than `density` times the nonzeros.
+    ///@tparam T Base type
+    template<class T>
+    class Differentiable<T, Sparse>
+    {
+    public:
+        //Constants
+        static constexpr unsigned int density = 4;
+        static constexpr unsigned int threshold = 8;
+
+    private:
+        static inline bool _is_dense(unsigned int nonzeros, unsigned int span) noexcept { return nonzeros >= threshold && nonzeros * density > span; };
+
+    public:
+
+        //Variables
+        T value;
+        bool dense;                      //true if derivative[i] is derivative by i-th variable
+        SmallVector<unsigned int> index; //sorted indices of nonzero derivatives, empty if dense
+        SmallVector<T> derivative;       //derivatives at indices, or all derivatives if dense
+
+        //Constructors & assignment
+        inline explicit Differentiable()                                   noexcept : value(0),           dense(false)                                                                               {};
+        inline Differentiable(const T &other)                              noexcept : value(other),       dense(false)                                                                               {};
+        inline Differentiable(const Differentiable &other)                          : value(other.value), dense(other.dense), index(other.index),            derivative(other.derivative)            {};
+        inline Differentiable(Differentiable &&other)                      noexcept : value(other.value), dense(other.dense), index(std::move(other.index)), derivative(std::move(other.derivative)) {};
+        inline Differentiable &operator=(const Differentiable &other)               { value = other.value; dense = other.dense; index = other.index;            derivative = other.derivative;            return *this; };
+        inline Differentiable &operator=(Differentiable &&other)           noexcept { value = other.value; dense = other.dense; index = std::move(other.index); derivative = std::move(other.derivative); return *this; };
+
+        //Access
+        ///Number of derivatives that can be nonzero, one past the largest stored index
+        inline unsigned int span() const noexcept { return dense ? derivative.size() : (index.size() == 0 ? 0 : index[index.size() - 1] + 1); };
+        ///Number of stored derivatives
+        inline unsigned int nonzeros() const noexcept { return derivative.size(); };
+        ///Derivative by i-th variable
+        inline T get(unsigned int i) const noexcept
+        {
+            if (dense) return (i < derivative.size()) ? derivative[i] : (T)0;
+            unsigned int low = 0, high = index.size();
+            while (low < high) { const unsigned int middle = (low + high) / 2; if (index[middle] < i) low = middle + 1; else high = middle; }
+            return (low < index.size() && index[low] == i) ? derivative[low] : (T)0;
+        };
+        ///Sets derivative by i-th variable
+        inline void set(unsigned int i, const T &d)
+        {
+            if (!dense)
+            {
+                unsigned int low = 0, high = index.size();
+                while (low < high) { const unsigned int middle = (low + high) / 2; if (index[middle] < i) low = middle + 1; else high = middle; }
+                if (low < index.size() && index[low] == i) { derivative[low] = d; return; }
+                index.resize(index.size() + 1); derivative.resize(derivative.size() + 1);
+                for (unsigned int k = index.size() - 1; k > low; --k) { index[k] = index[k - 1]; derivative[k] = derivative[k - 1]; }
+                index[low] = i; derivative[low] = d;
+                if (_is_dense(derivative.size(), span())) densify();
+            }
+            else if (i < derivative.size() || _is_dense(derivative.size() + 1, i + 1))
+            {
+                if (i >= derivative.size()) derivative.resize(i + 1);
+                derivative[i] = d;
+            }
+            else
+            {
+                sparsify();
+                set(i, d);
+            }
+        };
+        ///Switches to dense storage
+        inline void densify()
+        {
+            if (dense) return;
+            SmallVector<T> values(span());
+            for (unsigned int k = 0; k < index.size(); ++k) values[index[k]] = derivative[k];
+            derivative = std::move(values);
+            index.resize(0);
+            dense = true;
+        };
+        ///Switches to sparse storage, zero derivatives are dropped
+        inline void sparsify()
+        {
+            if (!dense) return;
+            unsigned int count = 0;
+            for (unsigned int i = 0; i < derivative.size(); ++i) if (derivative[i] != 0) ++count;
+            SmallVector<unsigned int> indices(count);
+            SmallVector<T> values(count);
+            for (unsigned int i = 0, k = 0; i < derivative.size(); ++i) if (derivative[i] != 0) { indices[k] = i; values[k] = derivative[i]; ++k; }
+            index = std::move(indices);
+            derivative = std::move(values);
+            dense = false;
+        };
+
+        //Kernels
+        ///Sets value and multiplies derivatives by `dthis`
+        inline Differentiable &scale(T value, T dthis) noexcept
+        {
+            this->value = value;
+            for (unsigned int i = 0; i < derivative.size(); ++i) derivative[i] *= dthis;
+            return *this;
+        };
+        ///Sets value and derivatives to `dthis * this' + dother * other'`, merging nonzero patterns
+        inline Differentiable &combine(T value, T dthis, const Differentiable &other, T dother)
+        {
+            if (&other == this) return scale(value, dthis + dother);
+            this->value = value;
+            if (dense != other.dense)
+            {
+                //Merging into the dense pattern must not widen it beyond `density` times the nonzeros
+                const unsigned int dense_span = dense ? span() : other.span(), sparse_span = dense ? other.span() : span(), sparse_nonzeros = dense ? other.nonzeros() : nonzeros();
+                if (sparse_span > dense_span && !_is_dense(dense_span + sparse_nonzeros, sparse_span))
+                {
+                    if (dense) sparsify();
+                    else { Differentiable copy = other; copy.sparsify(); return combine(value, dthis, copy, dother); }
+                }
+            }
+            if (dense || other.dense)
+            {
+                densify();
+                const unsigned int size = derivative.size(), other_span = other.span();
+                if (other_span > size) derivative.resize(other_span);
+                for (unsigned int i = 0; i < size; ++i) derivative[i] *= dthis;
+                if (other.dense) for (unsigned int i = 0; i < other_span; ++i) derivative[i] += dother * other.derivative[i];
+                else for (unsigned int k = 0; k < other.index.size(); ++k) derivative[other.index[k]] += dother * other.derivative[k];
+                return *this;
+            }
+            const unsigned int size = index.size(), other_size = other.index.size();
+            SmallVector<unsigned int> merged_index;
+            SmallVector<T> merged_derivative;
+            merged_index.resize(size + other_size);
+            merged_derivative.resize(size + other_size);
+            unsigned int i = 0, j = 0, k = 0;
+            while (i < size && j < other_size)
+            {
+                if (index[i] < other.index[j])      { merged_index[k] = index[i];       merged_derivative[k] = dthis * derivative[i];                               ++i; }
+                else if (index[i] > other.index[j]) { merged_index[k] = other.index[j]; merged_derivative[k] = dother * other.derivative[j];                     ++j; }
+                else                                { merged_index[k] = index[i];       merged_derivative[k] = dthis * derivative[i] + dother * other.derivative[j]; ++i; ++j; }
+                ++k;
+            }
+            for (; i < size; ++i, ++k)       { merged_index[k] = index[i];       merged_derivative[k] = dthis * derivative[i]; }
+            for (; j < other_size; ++j, ++k) { merged_index[k] = other.index[j]; merged_derivative[k] = dother * other.derivative[j]; }
+            merged_index.resize(k);
+            merged_derivative.resize(k);
+            index = std::move(merged_index);
+            derivative = std::move(merged_derivative);
+            if (_is_dense(k, span())) densify();
+            return *this;
+        };
+
+        //Increments/decrements
+        inline Differentiable &operator++()    noexcept { ++value; return *this; };
+        inline Differentiable &operator--()    noexcept { --value; return *this; };
+        inline Differentiable operator++ (int)          { Differentiable v = *this; ++value; return v; };
+        inline Differentiable operator-- (int)          { Differentiable v = *this; --value; return v; };
+
+        //Arithmetics
+        inline Differentiable &operator+=(const Differentiable &other) { return combine(value + other.value, 1, other,  1); };
+        inline Differentiable &operator-=(const Differentiable &other) { return combine(value - other.value, 1, other, -1); };
+        inline Differentiable &operator*=(const Differentiable &other) { return combine(value * other.value, other.value, other, value); };
+        inline Differentiable &operator/=(const Differentiable &other) { return combine(value / other.value, 1 / other.value, other, -value / (other.value * other.value)); };
+
+        //Transformations
+        inline Differentiable operator+() const & { return *this; };
+        inline Differentiable operator+() &&      { return std::move(*this); };
+        inline Differentiable operator-() const & { Differentiable v = *this; return std::move(v.scale(-value, -1)); };
+        inline Differentiable operator-() &&      { return std::move(scale(-value, -1)); };
+
+        //Cast
+        inline explicit operator T() const noexcept { return value; };
+    };
+
+    //Basic arithmetics, rvalue operands donate their buffers
+    template<class T> inline Differentiable<T, Sparse> operator+(Differentiable<T, Sparse> a, const Differentiable<T, Sparse> &b)  { return std::move(a += b); };
+    template<class T> inline Differentiable<T, Sparse> operator+(const Differentiable<T, Sparse> &a, Differentiable<T, Sparse> &&b) { return std::move(b += a); };
+    template<class T> inline Differentiable<T, Sparse> operator-(Differentiable<T, Sparse> a, const Differentiable<T, Sparse> &b)  { return std::move(a -= b); };
+    template<class T> inline Differentiable<T, Sparse> operator-(const Differentiable<T, Sparse> &a, Differentiable<T, Sparse> &&b) { return std::move(b.combine(a.value - b.value, -1, a, 1)); };
+    template<class T> inline Differentiable<T, Sparse> operator*(Differentiable<T, Sparse> a, const Differentiable<T, Sparse> &b)  { return std::move(a *= b); };
+    template<class T> inline Differentiable<T, Sparse> operator*(const Differentiable<T, Sparse> &a, Differentiable<T, Sparse> &&b) { return std::move(b *= a); };
+    template<class T> inline Differentiable<T, Sparse> operator/(Differentiable<T, Sparse> a, const Differentiable<T, Sparse> &b)  { return std::move(a /= b); };
+    template<class T> inline Differentiable<T, Sparse> operator/(const Differentiable<T, Sparse> &a, Differentiable<T, Sparse> &&b) { return std::move(b.combine(a.value / b.value, -a.value / (b.value * b.value), a, 1 / b.value)); };
+    template<class T> inline Differentiable<T, Sparse> operator+(Differentiable<T, Sparse> a, const typename _Constant<T>::type &b) { a.value += b; return a; };
+    template<class T> inline Differentiable<T, Sparse> operator+(const typename _Constant<T>::type &a, Differentiable<T, Sparse> b) { b.value += a; return b; };
+    template<class T> inline Differentiable<T, Sparse> operator-(Differentiable<T, Sparse> a, const typename _Constant<T>::type &b) { a.value -= b; return a; };
+    template<class T> inline Differentiable<T, Sparse> operator-(const typename _Constant<T>::type &a, Differentiable<T, Sparse> b) { return std::move(b.scale(a - b.value, -1)); };
+    template<class T> inline Differentiable<T, Sparse> operator*(Differentiable<T, Sparse> a, const typename _Constant<T>::type &b) { return std::move(a.scale(a.value * b, b)); };
+    template<class T> inline Differentiable<T, Sparse> operator*(const typename _Constant<T>::type &a, Differentiable<T, Sparse> b) { return std::move(b.scale(a * b.value, a)); };
+    template<class T> inline Differentiable<T, Sparse> operator/(Differentiable<T, Sparse> a, const typename _Constant<T>::type &b) { return std::move(a.scale(a.value / b, 1 / b)); };
+    template<class T> inline Differentiable<T, Sparse> operator/(const typename _Constant<T>::type &a, Differentiable<T, Sparse> b) { return std::move(b.scale(a / b.value, -a / (b.value * b.value))); };
+
+    //Trigonometric functions
+    template<class T> inline Differentiable<T, Sparse> cos  (Differentiable<T, Sparse> x) { T d = 0; const T r = rules::cos(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Sparse> sin  (Differentiable<T, Sparse> x) { T d = 0; const T r = rules::sin(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Sparse> tan  (Differentiable<T, Sparse> x) { T d = 0; const T r = rules::tan(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Sparse> acos (Differentiable<T, Sparse> x) { T d = 0; const T r = rules::acos(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Sparse> asin (Differentiable<T, Sparse> x) { T d = 0; const T r = rules::asin(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Sparse> atan (Differentiable<T, Sparse> x) { T d = 0; const T r = rules::atan(x.value, d); return std::move(x.scale(r, d)); };
+
+    //Hyperbolic functions
+    template<class T> inline Differentiable<T, Sparse> cosh (Differentiable<T, Sparse> x) { T d = 0; const T r = rules::cosh(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Sparse> sinh (Differentiable<T, Sparse> x) { T d = 0; const T r = rules::sinh(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Sparse> tanh (Differentiable<T, Sparse> x) { T d = 0; const T r = rules::tanh(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Sparse> acosh(Differentiable<T, Sparse> x) { T d = 0; const T r = rules::acosh(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Sparse> asinh(Differentiable<T, Sparse> x) { T d = 0; const T r = rules::asinh(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Sparse> atanh(Differentiable<T, Sparse> x) { T d = 0; const T r = rules::atanh(x.value, d); return std::move(x.scale(r, d)); };
+
+    //Exponential and logarithmic functions
+    template<class T> inline Differentiable<T, Sparse> exp  (Differentiable<T, Sparse> x) { T d = 0; const T r = rules::exp(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Sparse> log  (Differentiable<T, Sparse> x) { T d = 0; const T r = rules::log(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Sparse> log10(Differentiable<T, Sparse> x) { T d = 0; const T r = rules::log10(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Sparse> exp2 (Differentiable<T, Sparse> x) { T d = 0; const T r = rules::exp2(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Sparse> expm1(Differentiable<T, Sparse> x) { T d = 0; const T r = rules::expm1(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Sparse> log1p(Differentiable<T, Sparse> x) { T d = 0; const T r = rules::log1p(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Sparse> log2 (Differentiable<T, Sparse> x) { T d = 0; const T r = rules::log2(x.value, d); return std::move(x.scale(r, d)); };
+
+    //Power functions
+    template<class T> inline Differentiable<T, Sparse> pow  (Differentiable<T, Sparse> base, const Differentiable<T, Sparse> &exponent) { T da = 0, db = 0; const T r = rules::pow(base.value, exponent.value, da, db); return std::move(base.combine(r, da, exponent, db)); };
+    template<class T> inline Differentiable<T, Sparse> sqrt (Differentiable<T, Sparse> x)                                                  { T d = 0; const T r = rules::sqrt(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Sparse> cbrt (Differentiable<T, Sparse> x)                                                  { T d = 0; const T r = rules::cbrt(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Sparse> hypot(Differentiable<T, Sparse> x,    const Differentiable<T, Sparse> &y)          { T da = 0, db = 0; const T r = rules::hypot(x.value, y.value, da, db); return std::move(x.combine(r, da, y, db)); };
+    template<class T> inline Differentiable<T, Sparse> pow  (Differentiable<T, Sparse> base, const typename _Constant<T>::type &exponent) { T da = 0, db = 0; const T r = rules::pow(base.value, exponent, da, db); return std::move(base.scale(r, da)); };
+    template<class T> inline Differentiable<T, Sparse> pow  (const typename _Constant<T>::type &base, Differentiable<T, Sparse> exponent) { T da = 0, db = 0; const T r = rules::pow(base, exponent.value, da, db); return std::move(exponent.scale(r, db)); };
+    template<class T> inline Differentiable<T, Sparse> hypot(Differentiable<T, Sparse> x,    const typename _Constant<T>::type &y)        { T da = 0, db = 0; const T r = rules::hypot(x.value, y, da, db); return std::move(x.scale(r, da)); };
+    template<class T> inline Differentiable<T, Sparse> hypot(const typename _Constant<T>::type &x,    Differentiable<T, Sparse> y)        { T da = 0, db = 0; const T r = rules::hypot(x, y.value, da, db); return std::move(y.scale(r, db)); };
+
+    //Error and gamma functions
+    template<class T> inline Differentiable<T, Sparse> erf   (Differentiable<T, Sparse> x) { T d = 0; const T r = rules::erf(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Sparse> erfc  (Differentiable<T, Sparse> x) { T d = 0; const T r = rules::erfc(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Sparse> tgamma(Differentiable<T, Sparse> x) { T d = 0; const T r = rules::tgamma(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Sparse> lgamma(Differentiable<T, Sparse> x) { T d = 0; const T r = rules::lgamma(x.value, d); return std::move(x.scale(r, d)); };
+
+    //Other functions
+    template<class T> inline Differentiable<T, Sparse> fabs(Differentiable<T, Sparse> x) { T d = 0; const T r = rules::fabs(x.value, d); return std::move(x.scale(r, d)); };
+    template<class T> inline Differentiable<T, Sparse> abs (Differentiable<T, Sparse> x) { T d = 0; const T r = rules::abs(x.value, d); return std::move(x.scale(r, d)); };
+
+    //Defines
+    typedef Differentiable<float, Sparse> DFloatS;
+    typedef Differentiable<double, Sparse> DDoubleS;
+    typedef Differentiable<long double, Sparse> DLongDoubleS;
+}
+
+namespace std
+{
+    template<class C, class T> basic_ostream<C> &operator<<(basic_ostream<C> &os, const bd::Differentiable<T, bd::Sparse> &x)
+    {
+        os << x.value;
+        for (unsigned int k = 0; k < x.derivative.size(); k++) { os << ' ' << (x.dense ? k : x.index[k]) << ':' << x.derivative[k]; }
+        return os;
+    }
+
+    template<class T> std::string to_string(const bd::Differentiable<T, bd::Sparse> &x)
+    {
+        std::stringstream str;
+        str << x;
+        return str.str();
+    }
+
+    template<class T> std::wstring to_wstring(const bd::Differentiable<T, bd::Sparse> &x)
+    {
+        std::wstringstream str;
+        str << x;
+        return str.str();
+    }
+};
@@ -6,33 +6,79 @@
 #include <istream>
 #include <sstream>
 #include <string>
+#include "rules.hpp"
+#include "simd.hpp"
+#include "counters.hpp"
+#include "real.hpp"
 
 namespace bd
 {
     //Predefine
-    template<class T, unsigned int N> class Differentiable;
+    template<class T, unsigned int N, class D = T> class Differentiable;
+
+    ///Number of derivatives chosen at runtime, see differentiable-dynamic.hpp
+    constexpr unsigned int Dynamic = std::numeric_limits<unsigned int>::max();
+
+    ///Only nonzero derivatives are stored, see differentiable-sparse.hpp
+    constexpr unsigned int Sparse = std::numeric_limits<unsigned int>::max() - 1;
+
+    ///Non-deducible T, so that constant operands of mixed operations convert to the base type, e.g. from int
+    template<class T> struct _Constant { typedef T type; };
 
     //Basic arithmetics
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> operator+(const Differentiable<T, N> &a, const Differentiable<T, N> &b) { Differentiable<T, N> v; v.value = a.value + b.value; for (unsigned int i = 0; i < N; ++i) v.derivative[i] = a.derivative[i] + b.derivative[i]; return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> operator-(const Differentiable<T, N> &a, const Differentiable<T, N> &b) { Differentiable<T, N> v; v.value = a.value - b.value; for (unsigned int i = 0; i < N; ++i) v.derivative[i] = a.derivative[i] - b.derivative[i]; return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> operator*(const Differentiable<T, N> &a, const Differentiable<T, N> &b) { Differentiable<T, N> v; v.value = a.value * b.value; for (unsigned int i = 0; i < N; ++i) v.derivative[i] = a.value * b.derivative[i] + b.value * a.derivative[i]; return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> operator/(const Differentiable<T, N> &a, const Differentiable<T, N> &b) { Differentiable<T, N> v; v.value = a.value / b.value; for (unsigned int i = 0; i < N; ++i) v.derivative[i] = (a.derivative[i] * b.value - a.value * b.derivative[i]) / (b.value * b.value); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> operator+(const Differentiable<T, N, D> &a, const Differentiable<T, N, D> &b) { BD_COUNT(add, 1); BD_COUNT(derivative, N); Differentiable<T, N, D> v; v.value = a.value + b.value; simd::add<Differentiable<T, N, D>::padded>(v.derivative, a.derivative, b.derivative); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> operator-(const Differentiable<T, N, D> &a, const Differentiable<T, N, D> &b) { BD_COUNT(sub, 1); BD_COUNT(derivative, N); Differentiable<T, N, D> v; v.value = a.value - b.value; simd::sub<Differentiable<T, N, D>::padded>(v.derivative, a.derivative, b.derivative); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> operator*(const Differentiable<T, N, D> &a, const Differentiable<T, N, D> &b) { BD_COUNT(mul, 1); Differentiable<T, N, D> v; v.combine(a.value * b.value, a, b.value, b, a.value); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> operator/(const Differentiable<T, N, D> &a, const Differentiable<T, N, D> &b) { BD_COUNT(div, 1); Differentiable<T, N, D> v; v.combine(a.value / b.value, a, 1 / b.value, b, -a.value / (b.value * b.value)); return v; };
+
+    //Mixed arithmetics, constant operands have no derivatives to combine
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> operator+(const Differentiable<T, N, D> &a, const typename _Constant<T>::type &b) { BD_COUNT(add, 1); Differentiable<T, N, D> v = a; v.value += b; return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> operator+(const typename _Constant<T>::type &a, const Differentiable<T, N, D> &b) { BD_COUNT(add, 1); Differentiable<T, N, D> v = b; v.value += a; return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> operator-(const Differentiable<T, N, D> &a, const typename _Constant<T>::type &b) { BD_COUNT(sub, 1); Differentiable<T, N, D> v = a; v.value -= b; return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> operator-(const typename _Constant<T>::type &a, const Differentiable<T, N, D> &b) { BD_COUNT(sub, 1); Differentiable<T, N, D> v; v.scale(a - b.value, b, -1); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> operator*(const Differentiable<T, N, D> &a, const typename _Constant<T>::type &b) { BD_COUNT(mul, 1); Differentiable<T, N, D> v; v.scale(a.value * b, a, b); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> operator*(const typename _Constant<T>::type &a, const Differentiable<T, N, D> &b) { BD_COUNT(mul, 1); Differentiable<T, N, D> v; v.scale(a * b.value, b, a); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> operator/(const Differentiable<T, N, D> &a, const typename _Constant<T>::type &b) { BD_COUNT(div, 1); Differentiable<T, N, D> v; v.scale(a.value / b, a, 1 / b); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> operator/(const typename _Constant<T>::type &a, const Differentiable<T, N, D> &b) { BD_COUNT(div, 1); Differentiable<T, N, D> v; v.scale(a / b.value, b, -a / (b.value * b.value)); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> operator+(const Differentiable<T, N, D> &a, const Real<T> &b) { return a + b.value; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> operator+(const Real<T> &a, const Differentiable<T, N, D> &b) { return a.value + b; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> operator-(const Differentiable<T, N, D> &a, const Real<T> &b) { return a - b.value; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> operator-(const Real<T> &a, const Differentiable<T, N, D> &b) { return a.value - b; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> operator*(const Differentiable<T, N, D> &a, const Real<T> &b) { return a * b.value; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> operator*(const Real<T> &a, const Differentiable<T, N, D> &b) { return a.value * b; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> operator/(const Differentiable<T, N, D> &a, const Real<T> &b) { return a / b.value; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> operator/(const Real<T> &a, const Differentiable<T, N, D> &b) { return a.value / b; };
 
     ///Same as double, but with overloaded operators
     ///@tparam T Base type
     ///@tparam N Number of derivatives
-    template<class T, unsigned int N>
+    ///@tparam D Type of derivatives, e.g. float derivatives of a double value halve their memory and double their SIMD width.
+    ///Derivatives are computed in T and rounded to D when stored.
+    template<class T, unsigned int N, class D>
     class Differentiable
     {
+        static_assert(N != Dynamic && N != Sparse, "Derivative type other than base type requires fixed number of derivatives");
+
     public:
+        //Constants
+        static constexpr unsigned int padded = simd::Layout<D, N>::size; //derivatives after N are padding
+
         //Variables
         T value;
-        T derivative[N];
+        alignas(simd::Layout<D, N>::alignment) D derivative[padded];
 
         //Constructors & assignment
-        constexpr inline explicit Differentiable()                         noexcept { this->value = 0;           for (unsigned int i = 0; i < N; ++i) derivative[i] = 0; };
-        constexpr inline Differentiable(const T &other)                    noexcept { this->value = other;       for (unsigned int i = 0; i < N; ++i) derivative[i] = 0; };
-        constexpr inline Differentiable(const Differentiable<T, N> &other) noexcept { this->value = other.value; for (unsigned int i = 0; i < N; ++i) derivative[i] = other.derivative[i]; };
+        constexpr inline explicit Differentiable()                            noexcept { this->value = 0;           simd::fill<padded>(derivative, (D)0); };
+        constexpr inline Differentiable(const T &other)                       noexcept { this->value = other;       simd::fill<padded>(derivative, (D)0); };
+        constexpr inline Differentiable(const Differentiable<T, N, D> &other) noexcept { this->value = other.value; simd::copy<padded>(derivative, other.derivative); };
+        ///Converts derivatives of other precision
+        template<class E> constexpr inline explicit Differentiable(const Differentiable<T, N, E> &other) noexcept { this->value = other.value; simd::fill<padded>(derivative, (D)0); for (unsigned int i = 0; i < N; ++i) derivative[i] = (D)other.derivative[i]; };
+
+        //Kernels
+        ///Sets value and derivatives to `dx * x'`
+        constexpr inline Differentiable &scale(T value, const Differentiable &x, T dx) noexcept { BD_COUNT(derivative, N); simd::scale<padded>(derivative, x.derivative, (D)dx); this->value = value; return *this; };
+        ///Sets value and derivatives to `da * a' + db * b'`
+        constexpr inline Differentiable &combine(T value, const Differentiable &a, T da, const Differentiable &b, T db) noexcept { BD_COUNT(derivative, N); simd::combine<padded>(derivative, a.derivative, (D)da, b.derivative, (D)db); this->value = value; return *this; };
 
         //Increments/decrements
         constexpr inline Differentiable &operator++()    noexcept { ++this->value; return *this; };
@@ -41,134 +87,167 @@ namespace bd
         constexpr inline Differentiable operator-- (int) noexcept { Differentiable v = *this; --v.value; return v; };
 
         //Arithmetics
-        constexpr inline Differentiable &operator+=(const Differentiable &other) noexcept { for (unsigned int i = 0; i < N; ++i) derivative[i] += other.derivative[i]; return *this; value += other.value; };
-        constexpr inline Differentiable &operator-=(const Differentiable &other) noexcept { for (unsigned int i = 0; i < N; ++i) derivative[i] -= other.derivative[i]; return *this; value -= other.value; };
-        constexpr inline Differentiable &operator*=(const Differentiable &other) noexcept { for (unsigned int i = 0; i < N; ++i) derivative[i] = derivative[i] * other.value + other.derivative[i] * value; value *= other.value; return *this; };
-        constexpr inline Differentiable &operator/=(const Differentiable &other) noexcept { for (unsigned int i = 0; i < N; ++i) derivative[i] = (derivative[i] * other.value - other.derivative[i] * value) / (other.value * other.value); value /= other.value; return *this; };
+        constexpr inline Differentiable &operator+=(const Differentiable &other) noexcept { BD_COUNT(add, 1); BD_COUNT(derivative, N); simd::add<padded>(derivative, derivative, other.derivative); value += other.value; return *this; };
+        constexpr inline Differentiable &operator-=(const Differentiable &other) noexcept { BD_COUNT(sub, 1); BD_COUNT(derivative, N); simd::sub<padded>(derivative, derivative, other.derivative); value -= other.value; return *this; };
+        constexpr inline Differentiable &operator*=(const Differentiable &other) noexcept { BD_COUNT(mul, 1); return combine(value * other.value, *this, other.value, other, value); };
+        constexpr inline Differentiable &operator/=(const Differentiable &other) noexcept { BD_COUNT(div, 1); return combine(value / other.value, *this, 1 / other.value, other, -value / (other.value * other.value)); };
+        constexpr inline Differentiable &operator+=(const T &other)              noexcept { BD_COUNT(add, 1); value += other; return *this; };
+        constexpr inline Differentiable &operator-=(const T &other)              noexcept { BD_COUNT(sub, 1); value -= other; return *this; };
+        constexpr inline Differentiable &operator*=(const T &other)              noexcept { BD_COUNT(mul, 1); return scale(value * other, *this, other); };
+        constexpr inline Differentiable &operator/=(const T &other)              noexcept { BD_COUNT(div, 1); return scale(value / other, *this, 1 / other); };
 
         //Transformations
         constexpr inline Differentiable operator+() const noexcept { return *this; };
-        constexpr inline Differentiable operator-() const noexcept { Differentiable v; v.value = -this->value; for (unsigned int i = 0; i < N; ++i) v.derivative[i] = -derivative[i]; return v; };
+        constexpr inline Differentiable operator-() const noexcept { Differentiable v; v.scale(-value, *this, -1); return v; };
 
         //Cast
-        constexpr inline explicit operator T() noexcept { return value; };
+        constexpr inline explicit operator T() const noexcept { return value; };
     };
 
     //Comparison
-    template<class T, unsigned int N> constexpr inline bool operator==(const Differentiable<T, N> &a, const Differentiable<T, N> &b) { return a.value == b.value; };
-    template<class T, unsigned int N> constexpr inline bool operator!=(const Differentiable<T, N> &a, const Differentiable<T, N> &b) { return a.value != b.value; };
-    template<class T, unsigned int N> constexpr inline bool operator> (const Differentiable<T, N> &a, const Differentiable<T, N> &b) { return a.value >  b.value; };
-    template<class T, unsigned int N> constexpr inline bool operator< (const Differentiable<T, N> &a, const Differentiable<T, N> &b) { return a.value <  b.value; };
-    template<class T, unsigned int N> constexpr inline bool operator>=(const Differentiable<T, N> &a, const Differentiable<T, N> &b) { return a.value >= b.value; };
-    template<class T, unsigned int N> constexpr inline bool operator<=(const Differentiable<T, N> &a, const Differentiable<T, N> &b) { return a.value <= b.value; };
+    template<class T, unsigned int N, class D> constexpr inline bool operator==(const Differentiable<T, N, D> &a, const Differentiable<T, N, D> &b) { return a.value == b.value; };
+    template<class T, unsigned int N, class D> constexpr inline bool operator!=(const Differentiable<T, N, D> &a, const Differentiable<T, N, D> &b) { return a.value != b.value; };
+    template<class T, unsigned int N, class D> constexpr inline bool operator> (const Differentiable<T, N, D> &a, const Differentiable<T, N, D> &b) { return a.value >  b.value; };
+    template<class T, unsigned int N, class D> constexpr inline bool operator< (const Differentiable<T, N, D> &a, const Differentiable<T, N, D> &b) { return a.value <  b.value; };
+    template<class T, unsigned int N, class D> constexpr inline bool operator>=(const Differentiable<T, N, D> &a, const Differentiable<T, N, D> &b) { return a.value >= b.value; };
+    template<class T, unsigned int N, class D> constexpr inline bool operator<=(const Differentiable<T, N, D> &a, const Differentiable<T, N, D> &b) { return a.value <= b.value; };
+    template<class T, unsigned int N, class D> constexpr inline bool operator==(const Differentiable<T, N, D> &a, const typename _Constant<T>::type &b) { return a.value == b; };
+    template<class T, unsigned int N, class D> constexpr inline bool operator==(const typename _Constant<T>::type &a, const Differentiable<T, N, D> &b) { return a == b.value; };
+    template<class T, unsigned int N, class D> constexpr inline bool operator!=(const Differentiable<T, N, D> &a, const typename _Constant<T>::type &b) { return a.value != b; };
+    template<class T, unsigned int N, class D> constexpr inline bool operator!=(const typename _Constant<T>::type &a, const Differentiable<T, N, D> &b) { return a != b.value; };
+    template<class T, unsigned int N, class D> constexpr inline bool operator> (const Differentiable<T, N, D> &a, const typename _Constant<T>::type &b) { return a.value >  b; };
+    template<class T, unsigned int N, class D> constexpr inline bool operator> (const typename _Constant<T>::type &a, const Differentiable<T, N, D> &b) { return a >  b.value; };
+    template<class T, unsigned int N, class D> constexpr inline bool operator< (const Differentiable<T, N, D> &a, const typename _Constant<T>::type &b) { return a.value <  b; };
+    template<class T, unsigned int N, class D> constexpr inline bool operator< (const typename _Constant<T>::type &a, const Differentiable<T, N, D> &b) { return a <  b.value; };
+    template<class T, unsigned int N, class D> constexpr inline bool operator>=(const Differentiable<T, N, D> &a, const typename _Constant<T>::type &b) { return a.value >= b; };
+    template<class T, unsigned int N, class D> constexpr inline bool operator>=(const typename _Constant<T>::type &a, const Differentiable<T, N, D> &b) { return a >= b.value; };
+    template<class T, unsigned int N, class D> constexpr inline bool operator<=(const Differentiable<T, N, D> &a, const typename _Constant<T>::type &b) { return a.value <= b; };
+    template<class T, unsigned int N, class D> constexpr inline bool operator<=(const typename _Constant<T>::type &a, const Differentiable<T, N, D> &b) { return a <= b.value; };
 
     //Trigonometric functions
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> cos  (const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::cos  (x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] = -x.derivative[i] * std::sin(x.value);       return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> sin  (const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::sin  (x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] =  x.derivative[i] * std::cos(x.value);       return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> tan  (const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::tan  (x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] =  x.derivative[i] * (v.value + 1);           return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> acos (const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::acos (x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] = -x.derivative[i] / sqrt(1 - x.value);       return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> asin (const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::asin (x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] =  x.derivative[i] / sqrt(1 - x.value);       return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> atan (const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::atan (x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] =  x.derivative[i] / (1 + x.value * x.value); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> cos  (const Differentiable<T, N, D> &x) noexcept { BD_COUNT(cos, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::cos(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> sin  (const Differentiable<T, N, D> &x) noexcept { BD_COUNT(sin, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::sin(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> tan  (const Differentiable<T, N, D> &x) noexcept { BD_COUNT(tan, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::tan(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> acos (const Differentiable<T, N, D> &x) noexcept { BD_COUNT(acos, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::acos(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> asin (const Differentiable<T, N, D> &x) noexcept { BD_COUNT(asin, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::asin(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> atan (const Differentiable<T, N, D> &x) noexcept { BD_COUNT(atan, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::atan(x.value, d); v.scale(r, x, d); return v; };
 
     //Hyperbolic functions
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> cosh (const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::cosh (x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] =  x.derivative[i] * std::sinh(v.value);                        return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> sinh (const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::sinh (x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] =  x.derivative[i] * std::cosh(v.value);                        return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> tanh (const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::tanh (x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] =  x.derivative[i] / (std::cosh(v.value) * std::cosh(v.value)); return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> acosh(const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::acosh(x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] =  x.derivative[i] / sqrt(x.value * x.value + 1);               return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> asinh(const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::asinh(x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] =  x.derivative[i] / sqrt(x.value * x.value - 1);               return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> atanh(const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::atanh(x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] =  x.derivative[i] / (1 - x.value * x.value);                   return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> cosh (const Differentiable<T, N, D> &x) noexcept { BD_COUNT(cosh, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::cosh(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> sinh (const Differentiable<T, N, D> &x) noexcept { BD_COUNT(sinh, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::sinh(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> tanh (const Differentiable<T, N, D> &x) noexcept { BD_COUNT(tanh, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::tanh(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> acosh(const Differentiable<T, N, D> &x) noexcept { BD_COUNT(acosh, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::acosh(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> asinh(const Differentiable<T, N, D> &x) noexcept { BD_COUNT(asinh, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::asinh(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> atanh(const Differentiable<T, N, D> &x) noexcept { BD_COUNT(atanh, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::atanh(x.value, d); v.scale(r, x, d); return v; };
     
     //Exponential and logarithmic functions
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> exp  (const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::exp  (x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] =  x.derivative[i] * v.value;                 return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> log  (const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::log  (x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] =  x.derivative[i] / v.value;                 return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> log10(const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::log10(x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] =  M_LOG10E * x.derivative[i] / v.value;      return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> exp2 (const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::exp2 (x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] =  M_LN2    * x.derivative[i] * v.value;      return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> expm1(const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::expm1(x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] =  x.derivative[i] * (v.value + 1);           return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> log1p(const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::log1p(x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] =  x.derivative[i] / (v.value + 1);           return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> log2 (const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::log2 (x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] =  M_LOG2E  * x.derivative[i] / v.value;      return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> exp  (const Differentiable<T, N, D> &x) noexcept { BD_COUNT(exp, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::exp(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> log  (const Differentiable<T, N, D> &x) noexcept { BD_COUNT(log, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::log(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> log10(const Differentiable<T, N, D> &x) noexcept { BD_COUNT(log10, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::log10(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> exp2 (const Differentiable<T, N, D> &x) noexcept { BD_COUNT(exp2, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::exp2(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> expm1(const Differentiable<T, N, D> &x) noexcept { BD_COUNT(expm1, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::expm1(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> log1p(const Differentiable<T, N, D> &x) noexcept { BD_COUNT(log1p, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::log1p(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> log2 (const Differentiable<T, N, D> &x) noexcept { BD_COUNT(log2, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::log2(x.value, d); v.scale(r, x, d); return v; };
 
     //Power functions
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> pow  (const Differentiable<T, N> &base, const Differentiable<T, N> &exponent) noexcept { Differentiable<T, N> v; v.value = std::pow(base.value, exponent.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] = exponent.value * std::pow(base.value, exponent.value - 1) * base.derivative[i] + std::log(base.value) * std::pow(base.value, exponent.value) * exponent.derivative[i]; return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> sqrt (const Differentiable<T, N> &x)                                          noexcept { Differentiable<T, N> v; v.value = std::sqrt(x.value);                   for (unsigned int i = 0; i < N; ++i) v.derivative[i] = x.derivative[i] / (2 * std::sqrt(v.value)); return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> cbrt (const Differentiable<T, N> &x)                                          noexcept { Differentiable<T, N> v; v.value = std::cbrt(x.value);                   for (unsigned int i = 0; i < N; ++i) v.derivative[i] = x.derivative[i] / (3 * std::cbrt(v.value) * std::cbrt(v.value)); return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> hypot(const Differentiable<T, N> &x,    const Differentiable<T, N> &y)        noexcept { Differentiable<T, N> v; v.value = std::hypot(x.value, y.value);         for (unsigned int i = 0; i < N; ++i) v.derivative[i] = (x.value * x.derivative[i] + y.value * y.derivative[i]) / v.value; return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> pow  (const Differentiable<T, N, D> &base, const Differentiable<T, N, D> &exponent) noexcept { BD_COUNT(pow, 1); Differentiable<T, N, D> v; T da = 0, db = 0; const T r = rules::pow(base.value, exponent.value, da, db); v.combine(r, base, da, exponent, db); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> sqrt (const Differentiable<T, N, D> &x)                                          noexcept { BD_COUNT(sqrt, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::sqrt(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> cbrt (const Differentiable<T, N, D> &x)                                          noexcept { BD_COUNT(cbrt, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::cbrt(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> hypot(const Differentiable<T, N, D> &x,    const Differentiable<T, N, D> &y)        noexcept { BD_COUNT(hypot, 1); Differentiable<T, N, D> v; T da = 0, db = 0; const T r = rules::hypot(x.value, y.value, da, db); v.combine(r, x, da, y, db); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> pow  (const Differentiable<T, N, D> &base, const typename _Constant<T>::type &exponent) noexcept { BD_COUNT(pow, 1); Differentiable<T, N, D> v; T da = 0, db = 0; const T r = rules::pow(base.value, exponent, da, db); v.scale(r, base, da); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> pow  (const typename _Constant<T>::type &base, const Differentiable<T, N, D> &exponent) noexcept { BD_COUNT(pow, 1); Differentiable<T, N, D> v; T da = 0, db = 0; const T r = rules::pow(base, exponent.value, da, db); v.scale(r, exponent, db); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> hypot(const Differentiable<T, N, D> &x,    const typename _Constant<T>::type &y)        noexcept { BD_COUNT(hypot, 1); Differentiable<T, N, D> v; T da = 0, db = 0; const T r = rules::hypot(x.value, y, da, db); v.scale(r, x, da); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> hypot(const typename _Constant<T>::type &x,    const Differentiable<T, N, D> &y)        noexcept { BD_COUNT(hypot, 1); Differentiable<T, N, D> v; T da = 0, db = 0; const T r = rules::hypot(x, y.value, da, db); v.scale(r, y, db); return v; };
 
     //Error and gamma functions
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> erf   (const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::erf   (x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] =  2 * x.derivative[i] * std::exp(-x.value * x.value) / M_PI;   return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> erfc  (const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::erfc  (x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] = -2 * x.derivative[i] * std::exp(-x.value * x.value) / M_PI;   return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> tgamma(const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::tgamma(x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] = std::numeric_limits<T>::quiet_NaN(); return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> lgamma(const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::lgamma(x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] = std::numeric_limits<T>::quiet_NaN(); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> erf   (const Differentiable<T, N, D> &x) noexcept { BD_COUNT(erf, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::erf(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> erfc  (const Differentiable<T, N, D> &x) noexcept { BD_COUNT(erfc, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::erfc(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> tgamma(const Differentiable<T, N, D> &x) noexcept { BD_COUNT(tgamma, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::tgamma(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> lgamma(const Differentiable<T, N, D> &x) noexcept { BD_COUNT(lgamma, 1); Differentiable<T, N, D> v; T d = 0; const T r = rules::lgamma(x.value, d); v.scale(r, x, d); return v; };
 
     //Rounding and remainder functions
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> ceil     (const Differentiable<T, N> &x) noexcept { return (Differentiable<T, N>)std::ceil     (x.value); };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> floor    (const Differentiable<T, N> &x) noexcept { return (Differentiable<T, N>)std::floor    (x.value); };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> fmod     (const Differentiable<T, N> &x) noexcept { return (Differentiable<T, N>)std::fmod     (x.value); };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> trunc    (const Differentiable<T, N> &x) noexcept { return (Differentiable<T, N>)std::trunc    (x.value); };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> round    (const Differentiable<T, N> &x) noexcept { return (Differentiable<T, N>)std::round    (x.value); };
-    template<class T, unsigned int N> constexpr inline long int             lround   (const Differentiable<T, N> &x) noexcept { return std::lround   (x.value); };
-    template<class T, unsigned int N> constexpr inline long long int        llround  (const Differentiable<T, N> &x) noexcept { return std::llround  (x.value); };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> rint     (const Differentiable<T, N> &x) noexcept { return (Differentiable<T, N>)std::rint     (x.value); };
-    template<class T, unsigned int N> constexpr inline long int             lrint    (const Differentiable<T, N> &x) noexcept { return std::lrint    (x.value); };
-    template<class T, unsigned int N> constexpr inline long long int        llrint   (const Differentiable<T, N> &x) noexcept { return std::llrint   (x.value); };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> nearbyint(const Differentiable<T, N> &x) noexcept { return (Differentiable<T, N>)std::nearbyint(x.value); };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> remainder(const Differentiable<T, N> &numer, const Differentiable<T, N> &denom)            noexcept { return (Differentiable<T, N>)std::remainder(numer.value, denom.value); };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> remquo   (const Differentiable<T, N> &numer, const Differentiable<T, N> &denom, int *quot) noexcept { return (Differentiable<T, N>)std::remquo   (numer.value, denom.value, quot); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> ceil     (const Differentiable<T, N, D> &x) noexcept { return (Differentiable<T, N, D>)std::ceil     (x.value); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> floor    (const Differentiable<T, N, D> &x) noexcept { return (Differentiable<T, N, D>)std::floor    (x.value); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> fmod     (const Differentiable<T, N, D> &x) noexcept { return (Differentiable<T, N, D>)std::fmod     (x.value); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> trunc    (const Differentiable<T, N, D> &x) noexcept { return (Differentiable<T, N, D>)std::trunc    (x.value); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> round    (const Differentiable<T, N, D> &x) noexcept { return (Differentiable<T, N, D>)std::round    (x.value); };
+    template<class T, unsigned int N, class D> constexpr inline long int             lround   (const Differentiable<T, N, D> &x) noexcept { return std::lround   (x.value); };
+    template<class T, unsigned int N, class D> constexpr inline long long int        llround  (const Differentiable<T, N, D> &x) noexcept { return std::llround  (x.value); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> rint     (const Differentiable<T, N, D> &x) noexcept { return (Differentiable<T, N, D>)std::rint     (x.value); };
+    template<class T, unsigned int N, class D> constexpr inline long int             lrint    (const Differentiable<T, N, D> &x) noexcept { return std::lrint    (x.value); };
+    template<class T, unsigned int N, class D> constexpr inline long long int        llrint   (const Differentiable<T, N, D> &x) noexcept { return std::llrint   (x.value); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> nearbyint(const Differentiable<T, N, D> &x) noexcept { return (Differentiable<T, N, D>)std::nearbyint(x.value); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> remainder(const Differentiable<T, N, D> &numer, const Differentiable<T, N, D> &denom)            noexcept { return (Differentiable<T, N, D>)std::remainder(numer.value, denom.value); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> remainder(const Differentiable<T, N, D> &numer, const typename _Constant<T>::type &denom)             noexcept { return (Differentiable<T, N, D>)std::remainder(numer.value, denom); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> remainder(const typename _Constant<T>::type &numer, const Differentiable<T, N, D> &denom)             noexcept { return (Differentiable<T, N, D>)std::remainder(numer, denom.value); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> remquo   (const Differentiable<T, N, D> &numer, const Differentiable<T, N, D> &denom, int *quot) noexcept { return (Differentiable<T, N, D>)std::remquo   (numer.value, denom.value, quot); };
 
     //Floating-point manipulation functions
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> copysign  (const Differentiable<T, N> &mag, const Differentiable<T, N> &sgn) noexcept { return (std::isnan(mag.value)) ? ((Differentiable<T, N>)(sgn.value > 0 - sgn.value < 0)) : ((std::signbit(mag.value) == std::signbit(sgn.value)) ? (mag) : (-mag)); };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> nan       (const char* tagp)                                                 noexcept { return (Differentiable<T, N>)std::nan       (tagp); };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> nextafter (const Differentiable<T, N> &x,   const Differentiable<T, N> &y)   noexcept { return (Differentiable<T, N>)std::nextafter (x.value, y.value); };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> nexttoward(const Differentiable<T, N> &x,   const Differentiable<T, N> &y)   noexcept { return (Differentiable<T, N>)std::nexttoward(x.value, y.value); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> copysign  (const Differentiable<T, N, D> &mag, const Differentiable<T, N, D> &sgn) noexcept { return (std::isnan(mag.value)) ? ((Differentiable<T, N, D>)((sgn.value > 0) - (sgn.value < 0))) : ((std::signbit(mag.value) == std::signbit(sgn.value)) ? (mag) : (-mag)); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> copysign  (const Differentiable<T, N, D> &mag, const typename _Constant<T>::type &sgn) noexcept { return (std::isnan(mag.value)) ? ((Differentiable<T, N, D>)((sgn > 0) - (sgn < 0))) : ((std::signbit(mag.value) == std::signbit(sgn)) ? (mag) : (-mag)); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> copysign  (const typename _Constant<T>::type &mag, const Differentiable<T, N, D> &sgn) noexcept { return (Differentiable<T, N, D>)std::copysign(mag, sgn.value); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> nan       (const char* tagp)                                                 noexcept { return (Differentiable<T, N, D>)std::nan       (tagp); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> nextafter (const Differentiable<T, N, D> &x,   const Differentiable<T, N, D> &y)   noexcept { return (Differentiable<T, N, D>)std::nextafter (x.value, y.value); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> nextafter (const Differentiable<T, N, D> &x,   const typename _Constant<T>::type &y) noexcept { return (Differentiable<T, N, D>)std::nextafter (x.value, y); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> nextafter (const typename _Constant<T>::type &x, const Differentiable<T, N, D> &y)   noexcept { return (Differentiable<T, N, D>)std::nextafter (x, y.value); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> nexttoward(const Differentiable<T, N, D> &x,   const Differentiable<T, N, D> &y)   noexcept { return (Differentiable<T, N, D>)std::nexttoward(x.value, y.value); };
     
     //Minimum, maximum, difference functions
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> fdim(const Differentiable<T, N> &x, const Differentiable<T, N> &y) noexcept { return (x > y) ? (x - y) : ((Differentiable<T, N>)0); };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> fmax(const Differentiable<T, N> &x, const Differentiable<T, N> &y) noexcept { if (std::isnan(x.value)) return y; if (std::isnan(y.value)) return x; return (x > y) ? (x) : (y); };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> fmin(const Differentiable<T, N> &x, const Differentiable<T, N> &y) noexcept { if (std::isnan(x.value)) return y; if (std::isnan(y.value)) return x; return (x < y) ? (x) : (y); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> fdim(const Differentiable<T, N, D> &x, const Differentiable<T, N, D> &y) noexcept { return (x > y) ? (x - y) : ((Differentiable<T, N, D>)0); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> fmax(const Differentiable<T, N, D> &x, const Differentiable<T, N, D> &y) noexcept { if (std::isnan(x.value)) return y; if (std::isnan(y.value)) return x; return (x > y) ? (x) : (y); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> fmin(const Differentiable<T, N, D> &x, const Differentiable<T, N, D> &y) noexcept { if (std::isnan(x.value)) return y; if (std::isnan(y.value)) return x; return (x < y) ? (x) : (y); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> fdim(const Differentiable<T, N, D> &x, const typename _Constant<T>::type &y) noexcept { return (x.value > y) ? (x - y) : ((Differentiable<T, N, D>)0); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> fdim(const typename _Constant<T>::type &x, const Differentiable<T, N, D> &y) noexcept { return (x > y.value) ? (x - y) : ((Differentiable<T, N, D>)0); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> fmax(const Differentiable<T, N, D> &x, const typename _Constant<T>::type &y) noexcept { if (std::isnan(x.value)) return y; if (std::isnan(y)) return x; return (x.value > y) ? (x) : ((Differentiable<T, N, D>)y); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> fmax(const typename _Constant<T>::type &x, const Differentiable<T, N, D> &y) noexcept { if (std::isnan(x)) return y; if (std::isnan(y.value)) return x; return (x > y.value) ? ((Differentiable<T, N, D>)x) : (y); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> fmin(const Differentiable<T, N, D> &x, const typename _Constant<T>::type &y) noexcept { if (std::isnan(x.value)) return y; if (std::isnan(y)) return x; return (x.value < y) ? (x) : ((Differentiable<T, N, D>)y); };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> fmin(const typename _Constant<T>::type &x, const Differentiable<T, N, D> &y) noexcept { if (std::isnan(x)) return y; if (std::isnan(y.value)) return x; return (x < y.value) ? ((Differentiable<T, N, D>)x) : (y); };
     
     //Other functions
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> fabs(const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::fabs(x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] = ((x.value == 0) ? (std::numeric_limits<T>::quiet_NaN()) : ((x.value > 0) ? (x.derivative[i]) : (-x.derivative[i]))); return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> abs (const Differentiable<T, N> &x) noexcept { Differentiable<T, N> v; v.value = std::abs (x.value); for (unsigned int i = 0; i < N; ++i) v.derivative[i] = ((x.value == 0) ? (std::numeric_limits<T>::quiet_NaN()) : ((x.value > 0) ? (x.derivative[i]) : (-x.derivative[i]))); return v; };
-    template<class T, unsigned int N> constexpr inline Differentiable<T, N> fma (const Differentiable<T, N> &x, const Differentiable<T, N> &y, const Differentiable<T, N> &z) noexcept { return x * y + z; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> fabs(const Differentiable<T, N, D> &x) noexcept { Differentiable<T, N, D> v; T d = 0; const T r = rules::fabs(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> abs (const Differentiable<T, N, D> &x) noexcept { Differentiable<T, N, D> v; T d = 0; const T r = rules::abs(x.value, d); v.scale(r, x, d); return v; };
+    template<class T, unsigned int N, class D> constexpr inline Differentiable<T, N, D> fma (const Differentiable<T, N, D> &x, const Differentiable<T, N, D> &y, const Differentiable<T, N, D> &z) noexcept { return x * y + z; };
 
     //Classification macro / functions
-    template<class T, unsigned int N> constexpr inline int  fpclassify(const Differentiable<T, N> &x) noexcept { return std::fpclassify(x.value); }
-    template<class T, unsigned int N> constexpr inline bool isfinite  (const Differentiable<T, N> &x) noexcept { return std::isfinite  (x.value); }
-    template<class T, unsigned int N> constexpr inline bool isinf     (const Differentiable<T, N> &x) noexcept { return std::isinf     (x.value); }
-    template<class T, unsigned int N> constexpr inline bool isnan     (const Differentiable<T, N> &x) noexcept { return std::isnan     (x.value); }
-    template<class T, unsigned int N> constexpr inline bool isnormal  (const Differentiable<T, N> &x) noexcept { return std::isnormal  (x.value); }
-    template<class T, unsigned int N> constexpr inline bool signbit   (const Differentiable<T, N> &x) noexcept { return std::signbit   (x.value); }
+    template<class T, unsigned int N, class D> constexpr inline int  fpclassify(const Differentiable<T, N, D> &x) noexcept { return std::fpclassify(x.value); }
+    template<class T, unsigned int N, class D> constexpr inline bool isfinite  (const Differentiable<T, N, D> &x) noexcept { return std::isfinite  (x.value); }
+    template<class T, unsigned int N, class D> constexpr inline bool isinf     (const Differentiable<T, N, D> &x) noexcept { return std::isinf     (x.value); }
+    template<class T, unsigned int N, class D> constexpr inline bool isnan     (const Differentiable<T, N, D> &x) noexcept { return std::isnan     (x.value); }
+    template<class T, unsigned int N, class D> constexpr inline bool isnormal  (const Differentiable<T, N, D> &x) noexcept { return std::isnormal  (x.value); }
+    template<class T, unsigned int N, class D> constexpr inline bool signbit   (const Differentiable<T, N, D> &x) noexcept { return std::signbit   (x.value); }
 
     //Comparison macro / functions
-    template<class T, unsigned int N> constexpr inline bool isgreater     (const Differentiable<T, N> &x, const Differentiable<T, N> &y) noexcept { return std::isgreater     (x.value, y.value); }
-    template<class T, unsigned int N> constexpr inline bool isgreaterequal(const Differentiable<T, N> &x, const Differentiable<T, N> &y) noexcept { return std::isgreaterequal(x.value, y.value); }
-    template<class T, unsigned int N> constexpr inline bool isless        (const Differentiable<T, N> &x, const Differentiable<T, N> &y) noexcept { return std::isless        (x.value, y.value); }
-    template<class T, unsigned int N> constexpr inline bool islessequal   (const Differentiable<T, N> &x, const Differentiable<T, N> &y) noexcept { return std::islessequal   (x.value, y.value); }
-    template<class T, unsigned int N> constexpr inline bool islessgreater (const Differentiable<T, N> &x, const Differentiable<T, N> &y) noexcept { return std::islessgreater (x.value, y.value); }
-    template<class T, unsigned int N> constexpr inline bool isunordered   (const Differentiable<T, N> &x, const Differentiable<T, N> &y) noexcept { return std::isunordered   (x.value, y.value); }
+    template<class T, unsigned int N, class D> constexpr inline bool isgreater     (const Differentiable<T, N, D> &x, const Differentiable<T, N, D> &y) noexcept { return std::isgreater     (x.value, y.value); }
+    template<class T, unsigned int N, class D> constexpr inline bool isgreaterequal(const Differentiable<T, N, D> &x, const Differentiable<T, N, D> &y) noexcept { return std::isgreaterequal(x.value, y.value); }
+    template<class T, unsigned int N, class D> constexpr inline bool isless        (const Differentiable<T, N, D> &x, const Differentiable<T, N, D> &y) noexcept { return std::isless        (x.value, y.value); }
+    template<class T, unsigned int N, class D> constexpr inline bool islessequal   (const Differentiable<T, N, D> &x, const Differentiable<T, N, D> &y) noexcept { return std::islessequal   (x.value, y.value); }
+    template<class T, unsigned int N, class D> constexpr inline bool islessgreater (const Differentiable<T, N, D> &x, const Differentiable<T, N, D> &y) noexcept { return std::islessgreater (x.value, y.value); }
+    template<class T, unsigned int N, class D> constexpr inline bool isunordered   (const Differentiable<T, N, D> &x, const Differentiable<T, N, D> &y) noexcept { return std::isunordered   (x.value, y.value); }
 
     //Defines
     typedef Differentiable<float, 1> DFloat;
     typedef Differentiable<double, 1> DDouble;
     typedef Differentiable<long double, 1> DLongDouble;
+    template<unsigned int N> using DDoubleF = Differentiable<double, N, float>;
 }
 
 namespace std
 {
-    template<class C, class T, unsigned int N> basic_ostream<C> &operator<<(basic_ostream<C> &os, const bd::Differentiable<T, N> &x)
+    template<class C, class T, unsigned int N, class D> basic_ostream<C> &operator<<(basic_ostream<C> &os, const bd::Differentiable<T, N, D> &x)
     {
         os << x.value;
         for (unsigned int i = 0; i < N; i++) { os << ' ' << x.derivative[i]; }
         return os;
     }
 
-    template<class C, class T, unsigned int N> basic_istream<C> &operator>>(basic_istream<C> &is, const bd::Differentiable<T, N> &x)
+    template<class C, class T, unsigned int N, class D> basic_istream<C> &operator>>(basic_istream<C> &is, const bd::Differentiable<T, N, D> &x)
     {
         is >> x.value;
         for (unsigned int i = 0; i < N; i++) { is >> ' ' >> x.derivative[i]; }
         return is;
     }
 
-    template<class T, unsigned int N> std::string to_string(const bd::Differentiable<T, N> &x)
+    template<class T, unsigned int N, class D> std::string to_string(const bd::Differentiable<T, N, D> &x)
     {
         std::stringstream str;
         str << x.value;
@@ -176,7 +255,7 @@ namespace std
         return str.str();
     }
 
-    template<class T, unsigned int N> std::wstring to_wstring(const bd::Differentiable<T, N> &x)
+    template<class T, unsigned int N, class D> std::wstring to_wstring(const bd::Differentiable<T, N, D> &x)
     {
         std::wstringstream str;
         str << x.value;
@@ -0,0 +1,562 @@
+#pragma once
+
+#include "real.hpp"
+#include "differentiable.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <limits>
+
+//`bd::fast::pow` is only faster than `std::pow` where its table lookups vectorize as gathers, so it forwards to `std::pow` unless AVX-512 is enabled.
+//Define `BD_FAST_POW` to 1 or 0 to override.
+#ifndef BD_FAST_POW
+    #ifdef __AVX512F__
+        #define BD_FAST_POW 1
+    #else
+        #define BD_FAST_POW 0
+    #endif
+#endif
+
+namespace bd
+{
+    ///Opt-in approximations of elementary functions for `float` and `double`, with `bd::Real` and `bd::Differentiable` overloads.
+    ///`exp`, `log`, `atan`, `tanh`, `erf` and `pow` are polynomials after branch-free range reduction or table lookup, so loops over arrays vectorize.
+    ///`sin` and `cos` branch only to forward arguments outside the reduction range to the standard library.
+    ///Error bounds are listed in `bd::fast::Ulp`. Range reduction relies on IEEE rounding, the functions are wrong under `-ffast-math`.
+    ///There is one accuracy tier: the compensated sums that keep `log` and `pow` within 1-2 ulp cost nothing measurable once loops vectorize,
+    ///and without vectorization dropping them does not make up for the scalar table lookups, so a looser tier would not be faster.
+    namespace fast
+    {
+        ///Maximum error in units in the last place, as measured against the standard library over the domains swept by the tests
+        ///@tparam T `float` or `double`
+        template<class T> struct Ulp;
+        template<> struct Ulp<float>  { enum : unsigned int { exp = 1, log = 1, sin = 1, cos = 1, atan = 2, tanh = 4, erf = 2, pow = 2 }; };
+        template<> struct Ulp<double> { enum : unsigned int { exp = 1, log = 1, sin = 2, cos = 2, atan = 2, tanh = 3, erf = 2, pow = 1 }; };
+
+        //Floating-point formats
+        template<class T> struct _Format;
+        template<> struct _Format<float>
+        {
+            typedef std::int32_t Int;
+            typedef std::uint32_t Bits;
+            static constexpr int mantissa = 23, bias = 127;
+            static constexpr float split()    noexcept { return 4097.0f; };
+            static constexpr float ln2_hi()   noexcept { return 6.93145751953125e-1f; };
+            static constexpr float ln2_lo()   noexcept { return 1.42860682030941723212e-6f; };
+            static constexpr float exp_max()  noexcept { return 88.7228391f; };
+            static constexpr float exp_min()  noexcept { return -103.972084f; };
+            static constexpr float trig_max() noexcept { return 1647099.0f; };
+            static constexpr float tanh_max() noexcept { return 10.0f; };
+        };
+        template<> struct _Format<double>
+        {
+            typedef std::int64_t Int;
+            typedef std::uint64_t Bits;
+            static constexpr int mantissa = 52, bias = 1023;
+            static constexpr double split()    noexcept { return 134217729.0; };
+            static constexpr double ln2_hi()   noexcept { return 6.93147180369123816490e-1; };
+            static constexpr double ln2_lo()   noexcept { return 1.90821492927058770002e-10; };
+            static constexpr double exp_max()  noexcept { return 709.782712893384; };
+            static constexpr double exp_min()  noexcept { return -745.1332191019412; };
+            static constexpr double trig_max() noexcept { return 1647099.0; };
+            static constexpr double tanh_max() noexcept { return 20.0; };
+        };
+        template<class T> using _Enable = typename std::enable_if<std::is_same<T, float>::value || std::is_same<T, double>::value, T>::type;
+
+        //Bit manipulation
+        template<class T> inline typename _Format<T>::Bits _bits(T x) noexcept { typename _Format<T>::Bits b; std::memcpy(&b, &x, sizeof(x)); return b; };
+        template<class T> inline T _real(typename _Format<T>::Bits b) noexcept { T x; std::memcpy(&x, &b, sizeof(x)); return x; };
+        template<class T> inline T _pow2(typename _Format<T>::Int k) noexcept { return _real<T>((typename _Format<T>::Bits)(k + _Format<T>::bias) << _Format<T>::mantissa); };
+        template<class T> inline T _ldexp(T x, typename _Format<T>::Int k) noexcept { const typename _Format<T>::Int h = k / 2; return x * _pow2<T>(h) * _pow2<T>(k - h); };
+
+        ///Nearest integer to `x`, valid for `|x| < 2^(mantissa - 1)`. The integer is read back from the mantissa bits.
+        template<class T> inline T _round(T x, typename _Format<T>::Int &k) noexcept
+        {
+            const T magic = (T)1.5 * _pow2<T>(_Format<T>::mantissa);
+            const T t = x + magic;
+            k = (typename _Format<T>::Int)(_bits(t) - _bits(magic));
+            return t - magic;
+        };
+
+        ///Inverse of `_round`, `(T)k` for `|k| < 2^(mantissa - 1)` without a conversion instruction, which could trap in predicated code
+        template<class T> inline T _unround(typename _Format<T>::Int k) noexcept
+        {
+            const T magic = (T)1.5 * _pow2<T>(_Format<T>::mantissa);
+            return _real<T>(_bits(magic) + (typename _Format<T>::Bits)k) - magic;
+        };
+
+        ///Rounding error of the product `p = a * b`, such that `a * b == p + error` exactly
+        template<class T> inline T _product_error(T a, T b, T p) noexcept
+        {
+            #ifdef __FMA__
+            return std::fma(a, b, -p);
+            #else
+            const T sa = a * _Format<T>::split(), ah = sa - (sa - a), al = a - ah;
+            const T sb = b * _Format<T>::split(), bh = sb - (sb - b), bl = b - bh;
+            return ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+            #endif
+        };
+
+        ///Rounding error of the sum `s = a + b`, such that `a + b == s + error` exactly
+        template<class T> inline T _sum_error(T a, T b, T s) noexcept { const T bb = s - a; return (a - (s - bb)) + (b - bb); };
+
+        ///Reciprocals of odd numbers `1 / (2n + 1)`, coefficients of the `atan` and `log` series
+        template<class T, int N> struct _Odd
+        {
+            T value[N + 1];
+            constexpr _Odd() noexcept : value() { for (int n = 0; n <= N; n++) value[n] = (T)1 / (T)(2 * n + 1); };
+        };
+
+        //Polynomials
+        ///`e^r - 1` for `|r| <= ln(2) / 2`
+        inline float  _expm1_poly(float r)  noexcept { return r * (1 + r * (1.0f / 2 + r * (1.0f / 6 + r * (1.0f / 24 + r * (1.0f / 120 + r * (1.0f / 720 + r * (1.0f / 5040))))))); };
+        inline double _expm1_poly(double r) noexcept
+        {
+            return r * (1 + r * (1.0 / 2 + r * (1.0 / 6 + r * (1.0 / 24 + r * (1.0 / 120 + r * (1.0 / 720 + r * (1.0 / 5040 + r * (1.0 / 40320
+                + r * (1.0 / 362880 + r * (1.0 / 3628800 + r * (1.0 / 39916800 + r * (1.0 / 479001600 + r * (1.0 / 6227020800.0)))))))))))));
+        };
+
+        ///`sin(r)` for `|r| <= pi / 4`, `z = r^2`
+        inline float  _sin_poly(float r, float z)   noexcept { return r + r * z * (-1.0f / 6 + z * (1.0f / 120 + z * (-1.0f / 5040 + z * (1.0f / 362880)))); };
+        inline double _sin_poly(double r, double z) noexcept
+        {
+            return r + r * z * (-1.0 / 6 + z * (1.0 / 120 + z * (-1.0 / 5040 + z * (1.0 / 362880 + z * (-1.0 / 39916800
+                + z * (1.0 / 6227020800.0 + z * (-1.0 / 1307674368000.0 + z * (1.0 / 355687428096000.0))))))));
+        };
+
+        ///`cos(r)` for `|r| <= pi / 4`, `z = r^2`. `1 - z / 2` is summed in two parts to keep the rounding error of the leading terms.
+        inline float  _cos_poly(float z)  noexcept
+        {
+            const float h = z / 2, w = 1 - h;
+            return w + (((1 - w) - h) + z * z * (1.0f / 24 + z * (-1.0f / 720 + z * (1.0f / 40320 + z * (-1.0f / 3628800)))));
+        };
+        inline double _cos_poly(double z) noexcept
+        {
+            const double h = z / 2, w = 1 - h;
+            return w + (((1 - w) - h) + z * z * (1.0 / 24 + z * (-1.0 / 720 + z * (1.0 / 40320 + z * (-1.0 / 3628800 + z * (1.0 / 479001600
+                + z * (-1.0 / 87178291200.0 + z * (1.0 / 20922789888000.0))))))));
+        };
+
+        ///`x - k * pi / 2` for the nearest integer `k`, with `pi / 2` split in three parts of 33 bits (Cody-Waite), exact for `|k| < 2^20`
+        inline double _reduce(double x, std::int64_t &k) noexcept
+        {
+            const double n = _round(x * M_2_PI, k);
+            return ((x - n * 1.57079632673412561417e+0) - n * 6.07710050630396597660e-11) - n * 2.02226624871116645580e-21;
+        };
+        inline float _reduce(float x, std::int32_t &k) noexcept
+        {
+            //Single precision is reduced in double precision, two parts are enough
+            std::int64_t k64;
+            const double n = _round((double)x * M_2_PI, k64);
+            k = (std::int32_t)k64;
+            return (float)(((double)x - n * 1.57079632673412561417e+0) - n * 6.07710050650619224932e-11);
+        };
+
+        ///`e^(hi + lo)` for a small correction `lo`, with specials selected after the evaluation.
+        ///Out of range arguments only clamp the exponent, a clamped argument would let the compiler split the loop body into predicated paths.
+        template<class T> inline T _exp(T hi, T lo) noexcept
+        {
+            typedef _Format<T> F;
+            typename F::Int k;
+            const T n = _round(hi * (T)M_LOG2E, k);
+            const T r = ((hi - n * F::ln2_hi()) - n * F::ln2_lo()) + lo;
+            k = (k > -F::bias - F::mantissa - 1) ? ((k < F::bias + 2) ? k : F::bias + 2) : -F::bias - F::mantissa - 1;
+            const T y = _ldexp(1 + _expm1_poly(r), k);
+            return (hi != hi) ? hi : ((hi > F::exp_max()) ? std::numeric_limits<T>::infinity() : ((hi < F::exp_min()) ? (T)0 : y));
+        };
+
+        ///`e^(hi + lo)`, table of `2^(j / 32)` in two parts, so the polynomial argument stays below ln(2) / 64
+        inline double _exp(double hi, double lo) noexcept
+        {
+            static constexpr double table[32][2] =
+            {
+                {1.0, 0.0},
+                {1.0218971486541166, 5.109225028973444e-17},
+                {1.0442737824274138, 8.551889705537965e-17},
+                {1.0671404006768237, -7.899853966841582e-17},
+                {1.0905077326652577, -3.046782079812471e-17},
+                {1.1143867425958924, 1.0410278456845571e-16},
+                {1.1387886347566916, 8.912812676025408e-17},
+                {1.1637248587775775, 3.8292048369240935e-17},
+                {1.189207115002721, 3.982015231465646e-17},
+                {1.215247359980469, -7.712630692681488e-17},
+                {1.241857812073484, 4.658027591836937e-17},
+                {1.2690509571917332, 2.667932131342186e-18},
+                {1.2968395546510096, 2.5382502794888315e-17},
+                {1.3252366431597413, -2.8587312100388614e-17},
+                {1.3542555469368927, 7.70094837980299e-17},
+                {1.383909881963832, -6.770511658794786e-17},
+                {1.4142135623730951, -9.667293313452913e-17},
+                {1.4451808069770467, -3.0237581349939873e-17},
+                {1.4768261459394993, -3.483994556892796e-17},
+                {1.5091644275934228, -1.016455327754295e-16},
+                {1.5422108254079407, 7.949834809697621e-17},
+                {1.5759808451078865, -1.0136916471278304e-17},
+                {1.6104903319492543, 2.4707192569797888e-17},
+                {1.645755478153965, -1.0125679913674773e-16},
+                {1.681792830507429, 8.199010020581497e-17},
+                {1.718619298122478, -1.851380418263111e-17},
+                {1.7562521603732995, 2.960140695448873e-17},
+                {1.7947090750031072, 1.8227458427912087e-17},
+                {1.8340080864093424, 3.283107224245627e-17},
+                {1.8741676341103, -6.122763413004143e-17},
+                {1.9152065613971474, -1.0619946056195963e-16},
+                {1.9571441241754002, 8.960767791036668e-17}
+            };
+            typedef _Format<double> F;
+            std::int64_t k;
+            const double n = _round(hi * (32 * M_LOG2E), k);
+            const double r = ((hi - n * (F::ln2_hi() / 32)) - n * (F::ln2_lo() / 32)) + lo;
+            k = (k > -32 * (F::bias + F::mantissa + 1)) ? ((k < 32 * (F::bias + 2)) ? k : 32 * (F::bias + 2)) : -32 * (F::bias + F::mantissa + 1);
+            const std::int64_t j = k & 31;
+            const double p = r + r * r * (1.0 / 2 + r * (1.0 / 6 + r * (1.0 / 24 + r * (1.0 / 120 + r * (1.0 / 720)))));
+            const double y = _ldexp(table[j][0] + (table[j][1] + table[j][0] * p), (k - j) / 32);
+            return (hi != hi) ? hi : ((hi > F::exp_max()) ? std::numeric_limits<double>::infinity() : ((hi < F::exp_min()) ? 0.0 : y));
+        };
+
+        ///`x = 2^k m` with `m` in `[3/4, 3/2)`, subnormals are scaled into the normal range first
+        template<class T> inline T _decompose(T x, T &k) noexcept
+        {
+            typedef _Format<T> F;
+            typedef typename F::Int Int;
+            typedef typename F::Bits Bits;
+            //Integer tests, no shared conditions and no conversions, the compiler would otherwise split the body into branches that cannot be if-converted
+            const Bits mask = ((Bits)1 << F::mantissa) - 1;
+            const T scale = ((_bits(x) >> F::mantissa) == 0) ? _pow2<T>(F::mantissa + 2) : (T)1;
+            const Bits b = _bits(x * scale);
+            const bool high = (b & mask) >= ((Bits)1 << (F::mantissa - 1));
+            const T m = _real<T>((b & mask) | ((Bits)F::bias << F::mantissa));
+            k = _unround<T>((Int)(b >> F::mantissa) - (Int)(_bits(scale) >> F::mantissa) + (high ? 1 : 0));
+            return high ? m / 2 : m;
+        };
+
+        ///`log(x) = hi + lo` for positive finite `x`, series of `atanh`
+        template<class T> inline T _log(T x, T &lo) noexcept
+        {
+            typedef _Format<T> F;
+            T k;
+            const T f = _decompose(x, k) - 1;
+
+            //log(1 + f) = 2 atanh(s) = f - f^2 / 2 + s (f^2 / 2 + R) with s = f / (2 + f)
+            static constexpr _Odd<T, 5> odd{};
+            const T u = 2 + f, s = f / u, z = s * s;
+            T r = 0;
+            for (int n = 5; n > 0; n--) r = z * (2 * odd.value[n] + r);
+            const T ff = f * f, h = ff / 2, hl = _product_error(f, f, ff) / 2;
+
+            //Rounding error of s, it enters s (h + R) directly and through R ~ s^2
+            const T q = s * u, sl = (((f - q) - _product_error(s, u, q)) - s * _sum_error((T)2, f, u)) / u;
+
+            //k ln(2) + f - h summed exactly, the remaining terms are small
+            const T a = k * F::ln2_hi(), s1 = a + f, s2 = s1 - h;
+            const T tail = _sum_error(a, f, s1) + _sum_error(s1, -h, s2) + (s * (h + r) + sl * (h + 3 * r) - hl + k * F::ln2_lo());
+            const T hi = s2 + tail;
+            lo = tail - (hi - s2);
+            return hi;
+        };
+
+        ///`log(x) = hi + lo` for positive finite `x`, table of `1 / c` and `log(c)` in two parts for `c = 1 + i / 128`.
+        ///Double precision keeps the polynomial argument below 1/192, so `pow` stays accurate for large `|b log(a)|`.
+        inline double _log(double x, double &lo) noexcept
+        {
+            static constexpr double table[97][3] =
+            {
+                {1.3333333333333333, -0.28768207245178085, -2.6071606164425637e-17},
+                {1.3195876288659794, -0.27731928541623435, 2.652724229158001e-17},
+                {1.3061224489795917, -0.26706278524904514, -2.3896107240262357e-17},
+                {1.292929292929293, -0.2569104137850273, 9.92419178127068e-19},
+                {1.28, -0.2468600779315258, -6.678539813576451e-18},
+                {1.2673267326732673, -0.23690974707835774, 1.3644270985951448e-17},
+                {1.2549019607843137, -0.22705745063534608, 4.326372045075968e-18},
+                {1.2427184466019416, -0.2173012756899813, 1.8526017065773163e-18},
+                {1.2307692307692308, -0.20763936477824455, -1.2053243216686127e-17},
+                {1.2190476190476192, -0.19806991376209387, -1.0681737386368664e-17},
+                {1.2075471698113207, -0.18859116980754997, -9.915070540571144e-18},
+                {1.1962616822429906, -0.17920142945771092, 2.111400074974391e-18},
+                {1.1851851851851851, -0.16989903679539742, 4.868008764439086e-19},
+                {1.1743119266055047, -0.16068238169047352, 3.650183553047839e-18},
+                {1.1636363636363636, -0.15154989812720088, -1.2105853272368787e-17},
+                {1.1531531531531531, -0.142500062607283, -9.155570001519129e-18},
+                {1.1428571428571428, -0.13353139262452257, 3.664457663660086e-18},
+                {1.1327433628318584, -0.12464244520727659, 5.8089126789409715e-18},
+                {1.1228070175438596, -0.11583181552512165, -4.3384843698080944e-18},
+                {1.1130434782608696, -0.10709813555636712, 3.4717745161358675e-18},
+                {1.103448275862069, -0.09844007281325251, 4.439009633675136e-18},
+                {1.0940170940170941, -0.08985632912186114, -2.84207093558465e-18},
+                {1.0847457627118644, -0.0813456394539524, -1.6076294039775555e-18},
+                {1.0756302521008403, -0.07290677080808773, -5.836204074304871e-18},
+                {1.0666666666666667, -0.06453852113757116, 6.470486661692933e-18},
+                {1.0578512396694215, -0.05623971832287611, 3.2835149805605617e-18},
+                {1.0491803278688525, -0.04800921918636066, 2.030356617224395e-18},
+                {1.0406504065040652, -0.03984590854719978, 1.3948242043384064e-18},
+                {1.032258064516129, -0.03174869831458027, -3.0382263084680854e-18},
+                {1.024, -0.023716526617316065, 1.5774243488668216e-18},
+                {1.0158730158730158, -0.015748356968139112, -1.0021578630528958e-18},
+                {1.0078740157480315, -0.007843177461025879, -2.764708154124903e-19},
+                {1.0, 0.0, 0.0},
+                {0.9922480620155039, 0.007782140442054963, -1.2819179123343749e-20},
+                {0.9846153846153847, 0.015504186535965199, -3.2783210228924137e-19},
+                {0.9770992366412213, 0.023167059281534418, -3.095927552179262e-19},
+                {0.9696969696969697, 0.03077165866675366, 1.0431732029005972e-18},
+                {0.9624060150375939, 0.03831886430213666, -2.3579961573512846e-18},
+                {0.9552238805970149, 0.04580953603129422, 1.6823639049745016e-19},
+                {0.9481481481481482, 0.05324451451881224, 1.803871134979952e-18},
+                {0.9411764705882353, 0.060624621816434854, 2.6424025938726934e-18},
+                {0.9343065693430657, 0.06795066190850778, 3.9239563038692484e-18},
+                {0.927536231884058, 0.07522342123758752, -4.195880720316434e-18},
+                {0.920863309352518, 0.08244366921107454, -4.707903082046854e-18},
+                {0.9142857142857143, 0.08961215868968717, -1.9573659817110993e-18},
+                {0.9078014184397163, 0.09672962645855114, -4.0291867005826106e-18},
+                {0.9014084507042254, 0.10379679368164355, -3.195893222617445e-18},
+                {0.8951048951048951, 0.11081436634029011, 2.0511100808140527e-18},
+                {0.8888888888888888, 0.11778303565638351, -1.1971685747593662e-18},
+                {0.8827586206896552, 0.12470347850095725, -4.6522609636496624e-18},
+                {0.8767123287671232, 0.13157635778871932, 1.112300087972959e-17},
+                {0.8707482993197279, 0.1384023228591192, -1.3766819196398948e-17},
+                {0.8648648648648649, 0.14518200984449783, 8.242418783022477e-18},
+                {0.8590604026845637, 0.151916042025842, 4.1233095848339465e-19},
+                {0.8533333333333334, 0.15860503017663852, 2.583386492298558e-18},
+                {0.847682119205298, 0.16524957289530717, -9.227573884334224e-18},
+                {0.8421052631578947, 0.17185025692665928, -6.022453821011369e-18},
+                {0.8366013071895425, 0.17840765747281825, 1.2720936612962572e-17},
+                {0.8311688311688312, 0.18492233849401193, -7.384679440503435e-18},
+                {0.8258064516129032, 0.19139485299962947, -1.126213516780448e-17},
+                {0.8205128205128205, 0.19782574332991992, -7.995487338741543e-18},
+                {0.8152866242038217, 0.20421554142869083, 7.9379985298027e-18},
+                {0.810126582278481, 0.21056476910734964, 1.136310596906137e-17},
+                {0.8050314465408805, 0.2168739383006143, 6.285749669211092e-18},
+                {0.8, 0.2231435513142097, -9.091270597324798e-18},
+                {0.7950310559006211, 0.2293741010648459, -5.684839459813236e-18},
+                {0.7901234567901234, 0.23556607131276697, -2.394337149518734e-18},
+                {0.7852760736196319, 0.24171993688714513, 1.323779871210866e-17},
+                {0.7804878048780488, 0.2478361639045812, 8.384472133019162e-18},
+                {0.7757575757575758, 0.25391520998096345, -7.180735656435798e-18},
+                {0.7710843373493976, 0.259957524436926, 2.4167516341742964e-17},
+                {0.7664670658682635, 0.2659635484971379, 1.35209848201012e-19},
+                {0.7619047619047619, 0.2719337154836418, 7.833196376974436e-19},
+                {0.757396449704142, 0.2778684510034563, 2.2502748630777633e-17},
+                {0.7529411764705882, 0.2837681731306446, -6.448868003452105e-18},
+                {0.7485380116959064, 0.2896332925830427, 2.0535953219858177e-17},
+                {0.7441860465116279, 0.2954642128938359, -7.768320796245443e-18},
+                {0.7398843930635838, 0.30126133057816185, -1.5120043309967385e-17},
+                {0.735632183908046, 0.3070250352949119, 1.5578716077124932e-18},
+                {0.7314285714285714, 0.3127557100038969, -1.3650721793001109e-17},
+                {0.7272727272727273, 0.3184537311185346, -6.407962483026777e-19},
+                {0.7231638418079096, 0.324119468654212, -4.488767429940198e-18},
+                {0.7191011235955056, 0.32975328637246804, -2.5633554999431966e-17},
+                {0.7150837988826816, 0.3353555419211378, -1.3746739934976202e-17},
+                {0.7111111111111111, 0.3409265869705932, -2.069678002794501e-17},
+                {0.7071823204419889, 0.3464667673462086, -3.591951952851805e-18},
+                {0.7032967032967034, 0.3519764231571781, 2.0005853013367377e-17},
+                {0.6994535519125683, 0.3574558889218038, -2.4269548334425144e-17},
+                {0.6956521739130435, 0.3629054936893685, 6.2632141603179415e-18},
+                {0.6918918918918919, 0.36832556115870757, 2.690672380132659e-17},
+                {0.6881720430107527, 0.373716409793584, -2.449917382477111e-18},
+                {0.6844919786096256, 0.3790783529349695, 1.8481479367349684e-17},
+                {0.6808510638297872, 0.38441169891033206, 8.164631656028572e-18},
+                {0.6772486772486772, 0.38971675114002524, 2.734172667856699e-17},
+                {0.6736842105263158, 0.394993808240869, 7.437680769362324e-18},
+                {0.6701570680628273, 0.40024316412701266, -1.655340963311913e-17},
+                {0.6666666666666666, 0.40546510810816444, -2.881138025962641e-18}
+            };
+            double k;
+            const double m = _decompose(x, k);
+            std::int64_t i;
+            _round((m - 1) * 128, i);
+            const double invc = table[i + 32][0], logc_hi = table[i + 32][1], logc_lo = table[i + 32][2];
+
+            //r = m / c - 1 in two parts, the high part is exact because m / c is close to 1
+            const double p = m * invc, rh = p - 1, rl = _product_error(m, invc, p);
+            const double rr = rh * rh, h = rr / 2, hl = _product_error(rh, rh, rr) / 2;
+            const double t = rr * rh * (1.0 / 3 + rh * (-1.0 / 4 + rh * (1.0 / 5 + rh * (-1.0 / 6 + rh * (1.0 / 7 + rh * (-1.0 / 8))))));
+
+            //k ln(2) + log(c) + r - r^2 / 2 summed exactly, the remaining terms are small
+            const double a = k * _Format<double>::ln2_hi(), s0 = a + logc_hi, s1 = s0 + rh, s2 = s1 - h;
+            const double tail = _sum_error(a, logc_hi, s0) + _sum_error(s0, rh, s1) + _sum_error(s1, -h, s2)
+                + (rl - rh * rl - hl + t + k * _Format<double>::ln2_lo() + logc_lo);
+            const double hi = s2 + tail;
+            lo = tail - (hi - s2);
+            return hi;
+        };
+
+        ///`e^x - 1` for `0 <= x <= 2 tanh_max`
+        template<class T> inline T _expm1(T x) noexcept
+        {
+            typedef _Format<T> F;
+            typename F::Int k;
+            const T n = _round(x * (T)M_LOG2E, k);
+            const T p = _expm1_poly((x - n * F::ln2_hi()) - n * F::ln2_lo()), t = _pow2<T>(k);
+            return t * p + (t - 1);
+        };
+
+        ///Sine and cosine from one range reduction
+        template<class T> inline void _sincos(T x, T &s, T &c) noexcept
+        {
+            typename _Format<T>::Int k;
+            const T r = _reduce(x, k), z = r * r, ps = _sin_poly(r, z), pc = _cos_poly(z);
+            const T vs = (k & 1) ? pc : ps, vc = (k & 1) ? ps : pc;
+            s = (k & 2) ? -vs : vs;
+            c = ((k + 1) & 2) ? -vc : vc;
+        };
+
+        //Exponential and logarithmic functions
+        template<class T> inline _Enable<T> exp(T x) noexcept { return _exp(x, (T)0); };
+        template<class T> inline _Enable<T> log(T x) noexcept
+        {
+            //Specials evaluate log(1) = 0 and add their result, so that the evaluation is not moved into a branch
+            const T inf = std::numeric_limits<T>::infinity();
+            const bool finite = (x > 0) & (x < inf);
+            T lo;
+            const T hi = _log(finite ? x : (T)1, lo);
+            return (hi + lo) + (finite ? (T)0 : ((x == 0) ? -inf : ((x == inf) ? inf : std::numeric_limits<T>::quiet_NaN())));
+        };
+
+        //Trigonometric functions
+        template<class T> inline _Enable<T> sin(T x) noexcept { if (!(std::fabs(x) < _Format<T>::trig_max())) return std::sin(x); T s, c; _sincos(x, s, c); return s; };
+        template<class T> inline _Enable<T> cos(T x) noexcept { if (!(std::fabs(x) < _Format<T>::trig_max())) return std::cos(x); T s, c; _sincos(x, s, c); return c; };
+        template<class T> inline _Enable<T> atan(T x) noexcept
+        {
+            //Reduction to |t| <= tan(pi / 16) around the nearest j pi / 8, offsets are atan of the rounded tangents in two parts
+            const bool single = std::is_same<T, float>::value;
+            const T a = std::fabs(x);
+            const int j = (a > (T)5.027339492125846) ? 4 : (a > (T)1.496605762665489) ? 3 : (a > (T)0.6681786379192989) ? 2 : (a > (T)0.198912367379658) ? 1 : 0;
+            const T c = (j == 3) ? (T)2.414213562373095 : (j == 2) ? (T)1 : (j == 1) ? (T)0.41421356237309503 : (T)0;
+            const T oh = single
+                ? ((j == 4) ? (T)1.5707963705062866 : (j == 3) ? (T)1.1780972480773926 : (j == 2) ? (T)0.7853981852531433 : (j == 1) ? (T)0.39269909262657166 : (T)0)
+                : ((j == 4) ? (T)1.5707963267948966 : (j == 3) ? (T)1.1780972450961724 : (j == 2) ? (T)0.7853981633974483 : (j == 1) ? (T)0.39269908169872414 : (T)0);
+            const T ol = single
+                ? ((j == 4) ? (T)-4.371138828673793e-08 : (j == 3) ? (T)1.0932094340887488e-08 : (j == 2) ? (T)-2.1855694143368964e-08 : (j == 1) ? (T)-6.148726860999432e-09 : (T)0)
+                : ((j == 4) ? (T)6.123233995736766e-17 : (j == 3) ? (T)2.7563998718653792e-17 : (j == 2) ? (T)3.061616997868383e-17 : (j == 1) ? (T)3.060132146563891e-18 : (T)0);
+            const T t = (j == 4) ? -1 / a : (a - c) / (1 + a * c), z = t * t;
+
+            //atan(t) = t - t^3 / 3 + t^5 / 5 - ...
+            constexpr int terms = std::is_same<T, float>::value ? 5 : 11;
+            static constexpr _Odd<T, terms> odd{};
+            T p = 0;
+            for (int n = terms; n > 0; n--) p = z * (((n & 1) ? -odd.value[n] : odd.value[n]) + p);
+            const T y = oh + (t + (t * p + ol));
+            return (x < 0) ? -y : ((x != x) ? x : y);
+        };
+
+        //Hyperbolic functions
+        template<class T> inline _Enable<T> tanh(T x) noexcept
+        {
+            //tanh(|x|) = expm1(2|x|) / (expm1(2|x|) + 2), without cancellation for small x
+            const T a = std::fabs(x), v = (a < _Format<T>::tanh_max()) ? a : _Format<T>::tanh_max();
+            const T e = _expm1(2 * v), y = e / (e + 2);
+            return (x < 0) ? -y : ((x != x) ? x : y);
+        };
+
+        //Error functions
+        ///Piecewise polynomials over `[k / 4, (k + 1) / 4)` in `a - centre`, the first two pieces share an odd polynomial in `a^2` so small arguments keep their relative accuracy
+        inline double erf(double x) noexcept
+        {
+            static constexpr double table[24][15] =
+            {
+                {1.1283791670955126, -0.37612638903183754, 0.11283791670955126, -0.026866170645131252, 0.0052239776254421845, -0.0008548327023449964, 0.00012055332981634293, -1.4925650340205444e-05, 1.646211290596319e-06, -1.636576423028907e-07, 1.4804193895772844e-08, -1.2218173566060898e-09, 8.395237372202741e-11, 1.0, 0.0},
+                {1.1283791670955126, -0.37612638903183754, 0.11283791670955126, -0.026866170645131252, 0.0052239776254421845, -0.0008548327023449964, 0.00012055332981634293, -1.4925650340205444e-05, 1.646211290596319e-06, -1.636576423028907e-07, 1.4804193895772844e-08, -1.2218173566060898e-09, 8.395237372202741e-11, 1.0, 0.0},
+                {0.623240882188418, 0.7634995357606049, -0.47718720985037805, -0.05567184114921896, 0.176459853642588, -0.027413411061691043, -0.041344833666110865, 0.013910007726235652, 0.006686168395313666, -0.0036332601781697005, -0.0007344857943171419, 0.0006729784054686272, 4.083565776443501e-05, 0.0, 0.625},
+                {0.7840750610598597, 0.5247450452901482, -0.4591519146288797, 0.09292360177012801, 0.1123965624351969, -0.06721587738212743, -0.010367785747131035, 0.018595726495997174, -0.0018461465870203105, -0.0032568339752216367, 0.0008981261711149112, 0.0003885789995762027, -0.0001914957233125074, 0.0, 0.875},
+                {0.8883882317017078, 0.3182739585007693, -0.35805820331336546, 0.1624523329847717, 0.027973297133857565, -0.06132368360774556, 0.015536835449309028, 0.00960689468237338, -0.006031260783511186, -0.0003602407245228533, 0.0011532567303776113, -0.00017445589955318624, -0.0001410143475942587, 0.0, 1.125},
+                {0.9481700727820903, 0.1703597736875156, -0.23424468882033395, 0.1579377068561377, -0.030500610523481967, -0.03060597627068895, 0.022161235263356446, -0.001419061973690616, -0.0042610335518899435, 0.0015778699415789116, 0.0003236032750692533, -0.00033698588286034905, 2.807621306730481e-05, 0.0, 1.375},
+                {0.9784437332399837, 0.08047225902251116, -0.13076742091158064, 0.1148406196467083, -0.04971886315909143, -0.00213492484042858, 0.014414781131532689, -0.00618426155397986, -0.0005765255286444421, 0.0014106891535859596, -0.0003559687310079311, -0.00012587609259645364, 8.743247491784707e-05, 0.0, 1.625},
+                {0.9919900576701199, 0.03354582842421608, -0.06289842829540514, 0.06744109256118269, -0.04225988151097526, 0.011462583365752841, 0.004105187133179265, -0.004928394100661886, 0.0014305016946735026, 0.0003622769821585308, -0.00039015836036430517, 7.267725285468327e-05, 3.61145575007309e-05, 0.0, 1.875},
+                {0.9973459706405177, 0.012340820614333696, -0.026224243805459103, 0.03303740518628846, -0.02636082840861216, 0.012495482591793543, -0.001821412593494177, -0.0018692573356977572, 0.0013833456583395199, -0.0002897714363392008, -0.00012277616587852056, 9.442226098481918e-05, -1.4761705352636231e-05, 0.0, 2.125},
+                {0.9992170617821089, 0.004006477861670219, -0.009515384921466771, 0.013730533505099238, -0.013133213563482644, 0.008357392833647682, -0.003114079043217469, 0.0001232696572042443, 0.0005941113258768193, -0.0003375309206565284, 5.4704270070575526e-05, 3.1766937264326596e-05, -2.0715331900915115e-05, 0.0, 2.375},
+                {0.9997946242638588, 0.0011478751258826748, -0.003013172205442022, 0.00489042631756299, -0.005414293806653689, 0.00421788060154194, -0.0022468338447001915, 0.0006808681359574568, 3.4644700142939484e-05, -0.0001526045426444633, 7.395683185827387e-05, -1.0115621696515753e-05, -6.721841312812088e-06, 0.0, 2.625},
+                {0.9999521451602562, 0.000290228282862498, -0.0008344063132296818, 0.0015025360060694898, -0.0018817600709815844, 0.0017132632797573321, -0.0011400746241888868, 0.0005285700524698934, -0.0001356080190619943, -1.6140239214804837e-05, 3.338879688415909e-05, -1.4751394663414937e-05, 2.0002238930702958e-06, 0.0, 2.875},
+                {0.9999901032653747, 6.475868323471299e-05, -0.00020237088510847805, 0.00040001978289772456, -0.000557573949074936, 0.0005769615014916136, -0.000452315177608304, 0.0002664810472948275, -0.00011126364188641665, 2.5451062488685827e-05, 3.873716812142389e-06, -6.386359064755835e-06, 2.719550930642742e-06, 0.0, 3.125},
+                {0.9999981847185726, 1.275174079976511e-05, -4.303712519920718e-05, 9.25829514315897e-05, -0.00014188802214112946, 0.0001637739444805414, -0.00014640888161779998, 0.00010218619240658254, -5.484627092611875e-05, 2.1265621981318463e-05, -4.603618763720443e-06, -6.782374392223531e-07, 1.0699849292788968e-06, 0.0, 3.375},
+                {0.9999997048598075, 2.2159202846331196e-06, -8.032711031795035e-06, 1.867374489861395e-05, -3.1168592284823824e-05, 3.959233535007346e-05, -3.952911393367193e-05, 3.151412002857888e-05, -2.0089147527603046e-05, 1.0055334820676358e-05, -3.7186709440692154e-06, 7.9753682181834e-07, 8.036293703327369e-08, 0.0, 3.625},
+                {0.999999957486056, 3.398223817809156e-07, -1.316811729401048e-06, 3.2884895070253717e-06, -5.9325111767270205e-06, 8.208845472006421e-06, -9.021089088156317e-06, 8.03314728927301e-06, -5.849020770883453e-06, 3.4746603161749737e-06, -1.6530523229012182e-06, 5.958438633906106e-07, -1.334801117013047e-07, 0.0, 3.875},
+                {0.9999999945765992, 4.5989958288459555e-08, -1.897085779398996e-07, 5.06368603240298e-07, -9.811490515329832e-07, 1.4669853531731005e-06, -1.7554651147207796e-06, 1.719658995114461e-06, -1.3972270497654922e-06, 9.463926338543762e-07, -5.323943142532848e-07, 2.4549073555776424e-07, -8.741962259758798e-08, 0.0, 4.125},
+                {0.9999999993875167, 5.492717228852925e-09, -2.4030637876233768e-08, 6.82584547303642e-08, -1.4130515709539372e-07, 2.2680648800287385e-07, -2.930780870403698e-07, 3.1234617264725975e-07, -2.788260881456296e-07, 2.1033535585080362e-07, -1.3448152353761463e-07, 7.314859369803843e-08, -3.2680919272882514e-08, 0.0, 4.375},
+                {0.9999999999387839, 5.789281366585668e-10, -2.6775426320466415e-09, 8.062780403581547e-09, -1.775266547196827e-08, 3.04235968361937e-08, -4.216900119231207e-08, 4.847964587312463e-08, -4.701834707779227e-08, 3.8893931295599224e-08, -2.7620256796153353e-08, 1.7060496581838507e-08, -8.884537764122645e-09, 0.0, 4.625},
+                {0.9999999999945866, 5.3848704920950125e-11, -2.6251243648982916e-10, 8.352158503646685e-10, -1.9483344896078915e-09, 3.5486874588057922e-09, -5.247061305121305e-09, 6.4634901912627e-09, -6.753001394599458e-09, 6.058005993806703e-09, -4.706535785199543e-09, 3.2293330676655576e-09, -1.8923742698820465e-09, 0.0, 4.875},
+                {0.9999999999995766, 4.420170869329977e-12, -2.265337570535589e-11, 7.592564338560215e-11, -1.8700833590871796e-10, 3.605893877030882e-10, -5.661379906121985e-10, 7.431348885038804e-10, -8.308249406277233e-10, 8.01533986725732e-10, -6.739669762913862e-10, 5.063208735282482e-10, -3.270225595072603e-10, 0.0, 5.125},
+                {0.9999999999999707, 3.201961038234127e-13, -1.721054058057347e-12, 6.060378342517877e-12, -1.571358210434326e-11, 3.1966086781901653e-11, -5.3082285119366654e-11, 7.390852264729487e-11, -8.793958802039795e-11, 9.063881725400061e-11, -8.181804831131837e-11, 6.661358740748412e-11, -4.67747548742943e-11, 0.0, 5.375},
+                {0.9999999999999982, 2.0469452084062556e-14, -1.151406679737318e-13, 4.2495435452136e-13, -1.1568038987405688e-12, 2.475322304672335e-12, -4.3327484854411766e-12, 6.374018699587506e-12, -8.034989520750475e-12, 8.800570008740435e-12, -8.47414377228372e-12, 7.419944952768327e-12, -5.608830437853518e-12, 0.0, 5.625},
+                {0.9999999999999999, 1.154807464331153e-15, -6.7844938530452e-15, 2.6187665137245715e-14, -7.466476831157967e-14, 1.6760588843757767e-13, -3.083176161110794e-13, 4.776308310439806e-13, -6.354491023296534e-13, 7.363302285569665e-13, -7.524315295948198e-13, 7.043043077118056e-13, -5.688762807409723e-13, 0.0, 5.875}
+            };
+            //min(|x|, 6) on the bit patterns, which order like the values, a floating compare would be threaded into a branch
+            const std::uint64_t b = _bits(std::fabs(x)), c = _bits(6.0);
+            const double a = _real<double>((b < c) ? b : c);
+            std::int64_t k;
+            _round(4 * a - 0.5, k);
+            k = (k < 23) ? k : 23;
+            //Columns 13 and 14 select the odd polynomial in a^2 or the polynomial in a - centre, so all pieces run the same code
+            const double w = table[k][13] * a + (1 - table[k][13]), u = a * w - table[k][14];
+            double h = table[k][12];
+            for (int n = 11; n >= 0; n--) h = h * u + table[k][n];
+            const double y = w * h;
+            return (x < 0) ? -y : ((x != x) ? x : y);
+        };
+        inline float erf(float x) noexcept { return (float)erf((double)x); };
+
+        //Power functions
+        template<class T> inline _Enable<T> pow(T a, T b) noexcept
+        {
+        #if BD_FAST_POW
+            //e^(b log|a|) with log|a| and the product in two parts, so the error does not grow with |b log(a)|
+            const T inf = std::numeric_limits<T>::infinity(), m = std::fabs(a);
+            const bool regular = (m > 0) & (m < inf) & (std::fabs(b) < inf);
+            const T x = regular ? m : (T)1, y = regular ? b : (T)0;
+            T lo;
+            const T hi = _log(x, lo), yh = y * hi, yl = _product_error(y, hi, yh) + y * lo;
+            const T r = _exp(yh, yl);
+
+            //Specials of std::pow selected after the evaluation. Every select gets its own constant, nested conditions would keep loops from vectorizing as a branch to std::pow does.
+            const bool integer = std::nearbyint(b) == b, odd = integer & (std::nearbyint(b / 2) != b / 2);
+            const T edge = ((m == 0) ^ (b < 0)) ? (T)0 : inf;  //|a| = 0 or inf
+            const T limit = ((m > 1) ^ (b > 0)) ? (T)0 : inf;  //|b| = inf
+            const T unsigned_value = regular ? r : ((std::fabs(b) == inf) ? ((m == 1) ? (T)1 : limit) : edge);
+            const T value = odd ? std::copysign(unsigned_value, a) : unsigned_value;
+            const bool nan = ((a < 0) & (m < inf) & !integer) | (a != a) | (b != b);
+            const T result = nan ? std::numeric_limits<T>::quiet_NaN() : value;
+            return ((b == 0) | (a == 1)) ? (T)1 : result;
+        #else
+            return std::pow(a, b);
+        #endif
+        };
+
+        ///Value and derivative rules with the same signatures as `bd::rules`, for the differentiable types
+        namespace rules
+        {
+            template<class T> inline T exp (T x, T &d) noexcept { const T e = fast::exp(x); d = e; return e; };
+            template<class T> inline T log (T x, T &d) noexcept { d = 1 / x; return fast::log(x); };
+            template<class T> inline T sin (T x, T &d) noexcept { if (!(std::fabs(x) < _Format<T>::trig_max())) return bd::rules::sin(x, d); T s, c; _sincos(x, s, c); d = c; return s; };
+            template<class T> inline T cos (T x, T &d) noexcept { if (!(std::fabs(x) < _Format<T>::trig_max())) return bd::rules::cos(x, d); T s, c; _sincos(x, s, c); d = -s; return c; };
+            template<class T> inline T atan(T x, T &d) noexcept { d = 1 / (1 + x * x); return fast::atan(x); };
+            template<class T> inline T tanh(T x, T &d) noexcept { const T t = fast::tanh(x); d = 1 - t * t; return t; };
+            template<class T> inline T erf (T x, T &d) noexcept { d = (T)M_2_SQRTPI * fast::exp(-x * x); return fast::erf(x); };
+            template<class T> inline T pow (T a, T b, T &da, T &db) noexcept
+            {
+                const T p = fast::pow(a, b);
+                da = (a != 0) ? (b * p / a) : (b * fast::pow(a, b - 1));
+                db = (p == 0) ? (T)0 : fast::log(a) * p;
+                return p;
+            };
+        }
+
+        //Real
+        template<class T> inline Real<T> exp (const Real<T> &x) noexcept { return (Real<T>)fast::exp (x.value); };
+        template<class T> inline Real<T> log (const Real<T> &x) noexcept { return (Real<T>)fast::log (x.value); };
+        template<class T> inline Real<T> sin (const Real<T> &x) noexcept { return (Real<T>)fast::sin (x.value); };
+        template<class T> inline Real<T> cos (const Real<T> &x) noexcept { return (Real<T>)fast::cos (x.value); };
+        template<class T> inline Real<T> atan(const Real<T> &x) noexcept { return (Real<T>)fast::atan(x.value); };
+        template<class T> inline Real<T> tanh(const Real<T> &x) noexcept { return (Real<T>)fast::tanh(x.value); };
+        template<class T> inline Real<T> erf (const Real<T> &x) noexcept { return (Real<T>)fast::erf (x.value); };
+        template<class T> inline Real<T> pow (const Real<T> &a, const Real<T> &b) noexcept { return (Real<T>)fast::pow(a.value, b.value); };
+
+        //Differentiable
+        template<class T, unsigned int N, class D> inline Differentiable<T, N, D> exp (const Differentiable<T, N, D> &x) noexcept { Differentiable<T, N, D> v; T d = 0; const T r = rules::exp (x.value, d); v.scale(r, x, d); return v; };
+        template<class T, unsigned int N, class D> inline Differentiable<T, N, D> log (const Differentiable<T, N, D> &x) noexcept { Differentiable<T, N, D> v; T d = 0; const T r = rules::log (x.value, d); v.scale(r, x, d); return v; };
+        template<class T, unsigned int N, class D> inline Differentiable<T, N, D> sin (const Differentiable<T, N, D> &x) noexcept { Differentiable<T, N, D> v; T d = 0; const T r = rules::sin (x.value, d); v.scale(r, x, d); return v; };
+        template<class T, unsigned int N, class D> inline Differentiable<T, N, D> cos (const Differentiable<T, N, D> &x) noexcept { Differentiable<T, N, D> v; T d = 0; const T r = rules::cos (x.value, d); v.scale(r, x, d); return v; };
+        template<class T, unsigned int N, class D> inline Differentiable<T, N, D> atan(const Differentiable<T, N, D> &x) noexcept { Differentiable<T, N, D> v; T d = 0; const T r = rules::atan(x.value, d); v.scale(r, x, d); return v; };
+        template<class T, unsigned int N, class D> inline Differentiable<T, N, D> tanh(const Differentiable<T, N, D> &x) noexcept { Differentiable<T, N, D> v; T d = 0; const T r = rules::tanh(x.value, d); v.scale(r, x, d); return v; };
+        template<class T, unsigned int N, class D> inline Differentiable<T, N, D> erf (const Differentiable<T, N, D> &x) noexcept { Differentiable<T, N, D> v; T d = 0; const T r = rules::erf (x.value, d); v.scale(r, x, d); return v; };
+        template<class T, unsigned int N, class D> inline Differentiable<T, N, D> pow (const Differentiable<T, N, D> &base, const Differentiable<T, N, D> &exponent) noexcept { Differentiable<T, N, D> v; T da = 0, db = 0; const T r = rules::pow(base.value, exponent.value, da, db); v.combine(r, base, da, exponent, db); return v; };
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "hyper-dual.hpp"
+#include <Eigen/Core>
+
+template<class T, unsigned int N> struct Eigen::NumTraits<bd::HyperDual<T, N>>
+{
+    typedef bd::HyperDual<T, N> Real;
+    typedef bd::HyperDual<T, N> NonInteger;
+    typedef bd::HyperDual<T, N> Literal;
+    typedef bd::HyperDual<T, N> Nested;
+
+    enum
+    {
+        IsComplex = 0,
+        IsInteger = 0,
+        IsSigned = 1,
+        ReadCost = 1,
+        AddCost = 3,
+        MulCost = 3,
+        RequireInitialization = 0
+    };
+
+    static constexpr inline bd::HyperDual<T, N> epsilon        () noexcept { return (bd::HyperDual<T, N>)std::numeric_limits<T>::epsilon(); }
+    static constexpr inline bd::HyperDual<T, N> dummy_precision() noexcept { return (bd::HyperDual<T, N>)std::numeric_limits<T>::epsilon(); }
+    static constexpr inline bd::HyperDual<T, N> highest        () noexcept { return (bd::HyperDual<T, N>)std::numeric_limits<T>::infinity(); }
+    static constexpr inline bd::HyperDual<T, N> lowest         () noexcept { return (bd::HyperDual<T, N>)-std::numeric_limits<T>::infinity(); }
+    static constexpr inline int                 digits         () noexcept { return std::numeric_limits<T>::digits; }
+    static constexpr inline int                 digits10       () noexcept { return std::numeric_limits<T>::digits10; }
+    static constexpr inline int                 min_exponent   () noexcept { return std::numeric_limits<T>::min_exponent; }
+    static constexpr inline int                 max_exponent   () noexcept { return std::numeric_limits<T>::max_exponent; }
+    static constexpr inline bd::HyperDual<T, N> infinity       () noexcept { return (bd::HyperDual<T, N>)std::numeric_limits<T>::infinity(); }
+    static constexpr inline bd::HyperDual<T, N> quiet_NaN      () noexcept { return (bd::HyperDual<T, N>)std::numeric_limits<T>::quiet_NaN(); }
+};
\ No newline at end of file
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include "rules.hpp"
+
+namespace bd
+{
+    //Predefine
+    template<class T, unsigned int N> class HyperDual;
+
+    //Basic arithmetics
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> operator+(const HyperDual<T, N> &a, const HyperDual<T, N> &b) { HyperDual<T, N> v; v.combine(a.value + b.value, a, 1, b, 1, 0, 0, 0); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> operator-(const HyperDual<T, N> &a, const HyperDual<T, N> &b) { HyperDual<T, N> v; v.combine(a.value - b.value, a, 1, b, -1, 0, 0, 0); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> operator*(const HyperDual<T, N> &a, const HyperDual<T, N> &b) { HyperDual<T, N> v; v.combine(a.value * b.value, a, b.value, b, a.value, 0, 1, 0); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> operator/(const HyperDual<T, N> &a, const HyperDual<T, N> &b)
+    {
+        HyperDual<T, N> v;
+        const T r = 1 / b.value, q = a.value * r;
+        v.combine(q, a, r, b, -q * r, 0, -r * r, 2 * q * r * r);
+        return v;
+    };
+
+    ///Same as double, but with first and second derivatives. Hyper-dual numbers, second-order forward mode.
+    ///The Hessian is symmetric, only its upper triangle is stored, packed row by row: N (N + 1) / 2 elements instead of N^2.
+    ///Every function applies its closed-form first and second derivative, `f'' x' x'^T + f' x''`, in one pass.
+    ///@tparam T Base type
+    ///@tparam N Number of variables
+    template<class T, unsigned int N>
+    class HyperDual
+    {
+    public:
+        //Constants
+        static constexpr unsigned int packed = N * (N + 1) / 2; //elements of the packed upper triangle
+
+        //Variables
+        T value;
+        T derivative[N];
+        T hessian[packed];
+
+        ///Position of the second derivative by variables `i` and `j` in `hessian`
+        static constexpr inline unsigned int index(unsigned int i, unsigned int j) noexcept { return (i <= j) ? (i * N - i * (i - 1) / 2 + (j - i)) : index(j, i); };
+
+        //Constructors & assignment
+        constexpr inline explicit HyperDual()                     noexcept : value(0), derivative(), hessian() {};
+        constexpr inline HyperDual(const T &other)                noexcept : value(other), derivative(), hessian() {};
+        constexpr inline HyperDual(const HyperDual<T, N> &other)  noexcept = default;
+        constexpr inline HyperDual &operator=(const HyperDual &other) noexcept = default;
+
+        //Access
+        ///Second derivative by variables `i` and `j`, in any order
+        constexpr inline T second(unsigned int i, unsigned int j) const noexcept { return hessian[index(i, j)]; };
+
+        //Kernels
+        ///Sets value and derivatives of `f(x)` from `d = f'(x)` and `dd = f''(x)`. `x` may be `*this`.
+        constexpr inline HyperDual &scale(T value, const HyperDual &x, T d, T dd) noexcept
+        {
+            //Hessian first, it reads the old gradient
+            unsigned int k = 0;
+            for (unsigned int i = 0; i < N; ++i)
+            {
+                const T gi = dd * x.derivative[i];
+                for (unsigned int j = i; j < N; ++j, ++k) hessian[k] = d * x.hessian[k] + gi * x.derivative[j];
+            }
+            for (unsigned int i = 0; i < N; ++i) derivative[i] = d * x.derivative[i];
+            this->value = value;
+            return *this;
+        };
+        ///Sets value and derivatives of `f(a, b)` from its first partial derivatives `da`, `db` and second `daa`, `dab`, `dbb`. `a` or `b` may be `*this`.
+        constexpr inline HyperDual &combine(T value, const HyperDual &a, T da, const HyperDual &b, T db, T daa, T dab, T dbb) noexcept
+        {
+            unsigned int k = 0;
+            if (daa == 0 && dab == 0 && dbb == 0)
+            {
+                for (; k < packed; ++k) hessian[k] = da * a.hessian[k] + db * b.hessian[k];
+            }
+            else for (unsigned int i = 0; i < N; ++i)
+            {
+                const T ai = daa * a.derivative[i] + dab * b.derivative[i], bi = dab * a.derivative[i] + dbb * b.derivative[i];
+                for (unsigned int j = i; j < N; ++j, ++k) hessian[k] = da * a.hessian[k] + db * b.hessian[k] + ai * a.derivative[j] + bi * b.derivative[j];
+            }
+            for (unsigned int i = 0; i < N; ++i) derivative[i] = da * a.derivative[i] + db * b.derivative[i];
+            this->value = value;
+            return *this;
+        };
+
+        //Increments/decrements
+        constexpr inline HyperDual &operator++()    noexcept { ++value; return *this; };
+        constexpr inline HyperDual &operator--()    noexcept { --value; return *this; };
+        constexpr inline HyperDual operator++ (int) noexcept { HyperDual v = *this; ++value; return v; };
+        constexpr inline HyperDual operator-- (int) noexcept { HyperDual v = *this; --value; return v; };
+
+        //Arithmetics
+        constexpr inline HyperDual &operator+=(const HyperDual &other) noexcept { return combine(value + other.value, *this, 1, other, 1, 0, 0, 0); };
+        constexpr inline HyperDual &operator-=(const HyperDual &other) noexcept { return combine(value - other.value, *this, 1, other, -1, 0, 0, 0); };
+        constexpr inline HyperDual &operator*=(const HyperDual &other) noexcept { return combine(value * other.value, *this, other.value, other, value, 0, 1, 0); };
+        constexpr inline HyperDual &operator/=(const HyperDual &other) noexcept { return *this = *this / other; };
+
+        //Transformations
+        constexpr inline HyperDual operator+() const noexcept { return *this; };
+        constexpr inline HyperDual operator-() const noexcept { HyperDual v; v.scale(-value, *this, -1, 0); return v; };
+
+        //Cast
+        constexpr inline explicit operator T() const noexcept { return value; };
+    };
+
+    //Comparison
+    template<class T, unsigned int N> constexpr inline bool operator==(const HyperDual<T, N> &a, const HyperDual<T, N> &b) { return a.value == b.value; };
+    template<class T, unsigned int N> constexpr inline bool operator!=(const HyperDual<T, N> &a, const HyperDual<T, N> &b) { return a.value != b.value; };
+    template<class T, unsigned int N> constexpr inline bool operator> (const HyperDual<T, N> &a, const HyperDual<T, N> &b) { return a.value >  b.value; };
+    template<class T, unsigned int N> constexpr inline bool operator< (const HyperDual<T, N> &a, const HyperDual<T, N> &b) { return a.value <  b.value; };
+    template<class T, unsigned int N> constexpr inline bool operator>=(const HyperDual<T, N> &a, const HyperDual<T, N> &b) { return a.value >= b.value; };
+    template<class T, unsigned int N> constexpr inline bool operator<=(const HyperDual<T, N> &a, const HyperDual<T, N> &b) { return a.value <= b.value; };
+
+    //Trigonometric functions
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> cos  (const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::cos(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> sin  (const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::sin(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> tan  (const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::tan(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> acos (const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::acos(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> asin (const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::asin(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> atan (const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::atan(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+
+    //Hyperbolic functions
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> cosh (const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::cosh(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> sinh (const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::sinh(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> tanh (const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::tanh(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> acosh(const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::acosh(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> asinh(const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::asinh(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> atanh(const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::atanh(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+
+    //Exponential and logarithmic functions
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> exp  (const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::exp(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> log  (const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::log(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> log10(const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::log10(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> exp2 (const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::exp2(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> expm1(const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::expm1(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> log1p(const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::log1p(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> log2 (const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::log2(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+
+    //Power functions
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> pow  (const HyperDual<T, N> &base, const HyperDual<T, N> &exponent) noexcept { HyperDual<T, N> v; T da = 0, db = 0, daa = 0, dab = 0, dbb = 0; const T r = rules::pow(base.value, exponent.value, da, db, daa, dab, dbb); v.combine(r, base, da, exponent, db, daa, dab, dbb); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> sqrt (const HyperDual<T, N> &x)                                     noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::sqrt(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> cbrt (const HyperDual<T, N> &x)                                     noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::cbrt(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> hypot(const HyperDual<T, N> &x,    const HyperDual<T, N> &y)        noexcept { HyperDual<T, N> v; T da = 0, db = 0, daa = 0, dab = 0, dbb = 0; const T r = rules::hypot(x.value, y.value, da, db, daa, dab, dbb); v.combine(r, x, da, y, db, daa, dab, dbb); return v; };
+
+    //Error and gamma functions
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> erf   (const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::erf(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> erfc  (const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::erfc(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> tgamma(const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::tgamma(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> lgamma(const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::lgamma(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+
+    //Rounding and remainder functions
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> ceil     (const HyperDual<T, N> &x) noexcept { return (HyperDual<T, N>)std::ceil     (x.value); };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> floor    (const HyperDual<T, N> &x) noexcept { return (HyperDual<T, N>)std::floor    (x.value); };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> trunc    (const HyperDual<T, N> &x) noexcept { return (HyperDual<T, N>)std::trunc    (x.value); };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> round    (const HyperDual<T, N> &x) noexcept { return (HyperDual<T, N>)std::round    (x.value); };
+    template<class T, unsigned int N> constexpr inline long int        lround   (const HyperDual<T, N> &x) noexcept { return std::lround   (x.value); };
+    template<class T, unsigned int N> constexpr inline long long int   llround  (const HyperDual<T, N> &x) noexcept { return std::llround  (x.value); };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> rint     (const HyperDual<T, N> &x) noexcept { return (HyperDual<T, N>)std::rint     (x.value); };
+    template<class T, unsigned int N> constexpr inline long int        lrint    (const HyperDual<T, N> &x) noexcept { return std::lrint    (x.value); };
+    template<class T, unsigned int N> constexpr inline long long int   llrint   (const HyperDual<T, N> &x) noexcept { return std::llrint   (x.value); };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> nearbyint(const HyperDual<T, N> &x) noexcept { return (HyperDual<T, N>)std::nearbyint(x.value); };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> remainder(const HyperDual<T, N> &numer, const HyperDual<T, N> &denom)            noexcept { return (HyperDual<T, N>)std::remainder(numer.value, denom.value); };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> remquo   (const HyperDual<T, N> &numer, const HyperDual<T, N> &denom, int *quot) noexcept { return (HyperDual<T, N>)std::remquo   (numer.value, denom.value, quot); };
+
+    //Floating-point manipulation functions
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> copysign  (const HyperDual<T, N> &mag, const HyperDual<T, N> &sgn) noexcept { return (std::isnan(mag.value)) ? ((HyperDual<T, N>)((sgn.value > 0) - (sgn.value < 0))) : ((std::signbit(mag.value) == std::signbit(sgn.value)) ? (mag) : (-mag)); };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> nextafter (const HyperDual<T, N> &x,   const HyperDual<T, N> &y)   noexcept { return (HyperDual<T, N>)std::nextafter (x.value, y.value); };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> nexttoward(const HyperDual<T, N> &x,   const HyperDual<T, N> &y)   noexcept { return (HyperDual<T, N>)std::nexttoward(x.value, y.value); };
+
+    //Minimum, maximum, difference functions
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> fdim(const HyperDual<T, N> &x, const HyperDual<T, N> &y) noexcept { return (x > y) ? (x - y) : ((HyperDual<T, N>)0); };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> fmax(const HyperDual<T, N> &x, const HyperDual<T, N> &y) noexcept { if (std::isnan(x.value)) return y; if (std::isnan(y.value)) return x; return (x > y) ? (x) : (y); };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> fmin(const HyperDual<T, N> &x, const HyperDual<T, N> &y) noexcept { if (std::isnan(x.value)) return y; if (std::isnan(y.value)) return x; return (x < y) ? (x) : (y); };
+
+    //Other functions
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> fabs(const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::fabs(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> abs (const HyperDual<T, N> &x) noexcept { HyperDual<T, N> v; T d = 0, dd = 0; const T r = rules::abs(x.value, d, dd); v.scale(r, x, d, dd); return v; };
+    template<class T, unsigned int N> constexpr inline HyperDual<T, N> fma (const HyperDual<T, N> &x, const HyperDual<T, N> &y, const HyperDual<T, N> &z) noexcept { return x * y + z; };
+
+    //Classification macro / functions
+    template<class T, unsigned int N> constexpr inline int  fpclassify(const HyperDual<T, N> &x) noexcept { return std::fpclassify(x.value); }
+    template<class T, unsigned int N> constexpr inline bool isfinite  (const HyperDual<T, N> &x) noexcept { return std::isfinite  (x.value); }
+    template<class T, unsigned int N> constexpr inline bool isinf     (const HyperDual<T, N> &x) noexcept { return std::isinf     (x.value); }
+    template<class T, unsigned int N> constexpr inline bool isnan     (const HyperDual<T, N> &x) noexcept { return std::isnan     (x.value); }
+    template<class T, unsigned int N> constexpr inline bool isnormal  (const HyperDual<T, N> &x) noexcept { return std::isnormal  (x.value); }
+    template<class T, unsigned int N> constexpr inline bool signbit   (const HyperDual<T, N> &x) noexcept { return std::signbit   (x.value); }
+
+    //Comparison macro / functions
+    template<class T, unsigned int N> constexpr inline bool isgreater     (const HyperDual<T, N> &x, const HyperDual<T, N> &y) noexcept { return std::isgreater     (x.value, y.value); }
+    template<class T, unsigned int N> constexpr inline bool isgreaterequal(const HyperDual<T, N> &x, const HyperDual<T, N> &y) noexcept { return std::isgreaterequal(x.value, y.value); }
+    template<class T, unsigned int N> constexpr inline bool isless        (const HyperDual<T, N> &x, const HyperDual<T, N> &y) noexcept { return std::isless        (x.value, y.value); }
+    template<class T, unsigned int N> constexpr inline bool islessequal   (const HyperDual<T, N> &x, const HyperDual<T, N> &y) noexcept { return std::islessequal   (x.value, y.value); }
+    template<class T, unsigned int N> constexpr inline bool islessgreater (const HyperDual<T, N> &x, const HyperDual<T, N> &y) noexcept { return std::islessgreater (x.value, y.value); }
+    template<class T, unsigned int N> constexpr inline bool isunordered   (const HyperDual<T, N> &x, const HyperDual<T, N> &y) noexcept { return std::isunordered   (x.value, y.value); }
+
+    //Defines
+    typedef HyperDual<float, 1> HFloat;
+    typedef HyperDual<double, 1> HDouble;
+    typedef HyperDual<long double, 1> HLongDouble;
+}
+
+namespace std
+{
+    template<class C, class T, unsigned int N> basic_ostream<C> &operator<<(basic_ostream<C> &os, const bd::HyperDual<T, N> &x)
+    {
+        os << x.value;
+        for (unsigned int i = 0; i < N; i++) { os << ' ' << x.derivative[i]; }
+        for (unsigned int k = 0; k < bd::HyperDual<T, N>::packed; k++) { os << ' ' << x.hessian[k]; }
+        return os;
+    }
+
+    template<class T, unsigned int N> std::string to_string(const bd::HyperDual<T, N> &x)
+    {
+        std::stringstream str;
+        str << x;
+        return str.str();
+    }
+
+    template<class T, unsigned int N> std::wstring to_wstring(const bd::HyperDual<T, N> &x)
+    {
+        std::wstringstream str;
+        str << x;
+        return str.str();
+    }
+};
\ No newline at end of file
@@ -0,0 +1,391 @@
+#pragma once
+
+#include "real.hpp"
+#include "real-batch.hpp"
+#include "differentiable.hpp"
+#include "differentiable-batch.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//Text formatting uses std::to_chars and std::from_chars where the standard library has them for floating point (C++17, GCC 11),
+//define `BD_TO_CHARS` to 0 to force the snprintf/strtod fallback, which runs in the C locale regardless of LC_NUMERIC
+#ifndef BD_TO_CHARS
+    #if __cplusplus >= 201703L && defined(__has_include)
+        #if __has_include(<charconv>)
+            #include <charconv>
+        #endif
+    #endif
+    #ifdef __cpp_lib_to_chars
+        #define BD_TO_CHARS 1
+    #else
+        #define BD_TO_CHARS 0
+    #endif
+#elif BD_TO_CHARS
+    #include <charconv>
+#endif
+#if !BD_TO_CHARS
+    #include <locale.h>
+    #ifdef __APPLE__
+        #include <xlocale.h>
+    #endif
+#endif
+
+namespace bd
+{
+    namespace io
+    {
+        //Binary format
+
+        ///Header of binary data, 64 bytes so that data after it keeps the alignment of a mapping.
+        ///Data is stored in native byte order, `order` tells readers on other machines to refuse it.
+        struct Header
+        {
+            char magic[8];                     //"bdouble" and terminating zero
+            std::uint32_t order;               //0x01020304 in writer's byte order
+            std::uint16_t version;
+            std::uint16_t layout;              //`records` or `planes`
+            std::uint16_t value_size;          //sizeof of base type
+            std::uint16_t value_digits;        //mantissa digits of base type, tells float from integers of same size
+            std::uint16_t derivative_size;
+            std::uint16_t derivative_digits;
+            std::uint32_t derivatives;         //number of derivatives, 0 for Real
+            std::uint32_t reserved;
+            std::uint64_t count;               //number of values, 0 if records run to the end of the stream
+            std::uint64_t stride;              //elements from one plane to the next, 0 for records
+            char padding[16];
+        };
+        static_assert(sizeof(Header) == 64, "Header must take one cache line");
+
+        ///Layouts: `records` stores every value followed by its derivatives, `planes` stores all values followed by every derivative plane, as in batches
+        constexpr std::uint16_t records = 0, planes = 1;
+
+        ///Value and derivative types of an element
+        template<class X> struct Format;
+        template<class T> struct Format<Real<T>>
+        {
+            typedef T Value;
+            typedef T Derivative;
+            static constexpr unsigned int derivatives = 0;
+            static inline       T &value(Real<T> &x)                     noexcept { return x.value; };
+            static inline const T &value(const Real<T> &x)               noexcept { return x.value; };
+            static inline       T *derivative(Real<T> &)                 noexcept { return nullptr; };
+            static inline const T *derivative(const Real<T> &)           noexcept { return nullptr; };
+        };
+        template<class T, unsigned int N, class D> struct Format<Differentiable<T, N, D>>
+        {
+            typedef T Value;
+            typedef D Derivative;
+            static constexpr unsigned int derivatives = N;
+            static inline       T &value(Differentiable<T, N, D> &x)       noexcept { return x.value; };
+            static inline const T &value(const Differentiable<T, N, D> &x) noexcept { return x.value; };
+            static inline       D *derivative(Differentiable<T, N, D> &x)       noexcept { return x.derivative; };
+            static inline const D *derivative(const Differentiable<T, N, D> &x) noexcept { return x.derivative; };
+        };
+
+        ///Header describing elements of type X
+        template<class X> inline Header header(std::uint16_t layout, std::uint64_t count, std::uint64_t stride) noexcept
+        {
+            typedef Format<X> F;
+            Header h;
+            std::memset(&h, 0, sizeof(h));
+            std::memcpy(h.magic, "bdouble", 8);
+            h.order = 0x01020304;
+            h.version = 1;
+            h.layout = layout;
+            h.value_size = sizeof(typename F::Value);
+            h.value_digits = std::numeric_limits<typename F::Value>::digits;
+            h.derivative_size = sizeof(typename F::Derivative);
+            h.derivative_digits = std::numeric_limits<typename F::Derivative>::digits;
+            h.derivatives = F::derivatives;
+            h.count = count;
+            h.stride = stride;
+            return h;
+        };
+
+        ///True if `h` was written for elements of type X in `layout` on a machine of same byte order
+        template<class X> inline bool matches(const Header &h, std::uint16_t layout) noexcept
+        {
+            const Header e = header<X>(layout, 0, 0);
+            return std::memcmp(h.magic, e.magic, 8) == 0 && h.order == e.order && h.version == e.version && h.layout == e.layout
+                && h.value_size == e.value_size && h.value_digits == e.value_digits
+                && (e.derivatives == 0 || (h.derivative_size == e.derivative_size && h.derivative_digits == e.derivative_digits))
+                && h.derivatives == e.derivatives;
+        };
+
+        ///Streaming writer of elements as records, buffers records and writes them in large blocks
+        ///@tparam X Element type, `Real<T>` or `Differentiable<T, N, D>`
+        template<class X>
+        class Writer
+        {
+        public:
+            //Constants
+            static constexpr std::size_t record = sizeof(typename Format<X>::Value) + Format<X>::derivatives * sizeof(typename Format<X>::Derivative);
+
+        private:
+            std::ostream &_os;
+            std::vector<char> _buffer;
+            std::size_t _used = 0;
+
+        public:
+            ///Writes header to `os`, `count` is the number of elements to follow or 0 if unknown
+            inline explicit Writer(std::ostream &os, std::uint64_t count = 0) : _os(os), _buffer((65536 / record + 1) * record)
+            {
+                const Header h = header<X>(records, count, 0);
+                _os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+            };
+            Writer(const Writer &other) = delete;
+            Writer &operator=(const Writer &other) = delete;
+            inline ~Writer() { try { flush(); } catch (...) {} };
+
+            inline void write(const X &x)
+            {
+                if (_used + record > _buffer.size()) flush();
+                std::memcpy(_buffer.data() + _used, &Format<X>::value(x), sizeof(typename Format<X>::Value));
+                if (Format<X>::derivatives != 0) std::memcpy(_buffer.data() + _used + sizeof(typename Format<X>::Value), Format<X>::derivative(x), record - sizeof(typename Format<X>::Value));
+                _used += record;
+            };
+            inline void write(const X *x, std::size_t n) { for (std::size_t k = 0; k < n; ++k) write(x[k]); };
+            ///Passes buffered records to the stream
+            inline void flush()
+            {
+                if (_used != 0) _os.write(_buffer.data(), (std::streamsize)_used);
+                _used = 0;
+            };
+        };
+
+        ///Streaming reader of elements written by Writer. A header of other type or byte order sets failbit of the stream and nothing is read.
+        ///@tparam X Element type, `Real<T>` or `Differentiable<T, N, D>`
+        template<class X>
+        class Reader
+        {
+        public:
+            //Constants
+            static constexpr std::size_t record = Writer<X>::record;
+
+        private:
+            std::istream &_is;
+            Header _header;
+            std::uint64_t _remaining;
+            std::vector<char> _buffer;
+
+        public:
+            ///Reads header from `is`
+            inline explicit Reader(std::istream &is) : _is(is), _remaining(0), _buffer((65536 / record + 1) * record)
+            {
+                std::memset(&_header, 0, sizeof(_header));
+                if (!_is.read(reinterpret_cast<char*>(&_header), sizeof(_header)) || !matches<X>(_header, records)) { _is.setstate(std::ios::failbit); return; }
+                _remaining = (_header.count != 0) ? _header.count : std::numeric_limits<std::uint64_t>::max();
+            };
+
+            inline const Header &header() const noexcept { return _header; };
+            ///False once the stream failed or all elements declared in the header were read
+            inline bool good() const noexcept { return _is.good() && _remaining != 0; };
+
+            ///Reads up to `n` elements, returns number of elements read
+            inline std::size_t read(X *x, std::size_t n)
+            {
+                std::size_t done = 0;
+                while (done < n && good())
+                {
+                    std::size_t m = _buffer.size() / record;
+                    if (m > n - done) m = n - done;
+                    if (m > _remaining) m = (std::size_t)_remaining;
+                    _is.read(_buffer.data(), (std::streamsize)(m * record));
+                    m = (std::size_t)_is.gcount() / record;
+                    for (std::size_t k = 0; k < m; ++k)
+                    {
+                        X &e = x[done + k];
+                        std::memcpy(&Format<X>::value(e), _buffer.data() + k * record, sizeof(typename Format<X>::Value));
+                        if (Format<X>::derivatives != 0) std::memcpy(Format<X>::derivative(e), _buffer.data() + k * record + sizeof(typename Format<X>::Value), record - sizeof(typename Format<X>::Value));
+                    }
+                    done += m;
+                    _remaining -= m;
+                }
+                return done;
+            };
+            inline bool read(X &x) { return read(&x, 1) == 1; };
+        };
+
+        ///Writes batch as value plane followed by N derivative planes, with the stride of the batch, so the data is a copy of the batch's memory
+        template<class T, unsigned int N> inline void write(std::ostream &os, const DifferentiableBatch<T, N> &batch)
+        {
+            const Header h = header<Differentiable<T, N>>(planes, batch.size(), batch.stride());
+            os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+            os.write(reinterpret_cast<const char*>(batch.data()), (std::streamsize)((N + 1) * batch.stride() * sizeof(T)));
+        };
+        template<class T> inline void write(std::ostream &os, const RealBatch<T> &batch)
+        {
+            const Header h = header<Real<T>>(planes, batch.size(), batch.size());
+            os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+            os.write(reinterpret_cast<const char*>(batch.value()), (std::streamsize)(batch.size() * sizeof(T)));
+        };
+
+        ///Reads batch written by `write()`, sets failbit of the stream on mismatch
+        template<class T, unsigned int N> inline bool read(std::istream &is, DifferentiableBatch<T, N> &batch)
+        {
+            Header h;
+            if (!is.read(reinterpret_cast<char*>(&h), sizeof(h)) || !matches<Differentiable<T, N>>(h, planes) || h.stride < h.count) { is.setstate(std::ios::failbit); return false; }
+            batch = DifferentiableBatch<T, N>((std::size_t)h.count);
+            for (unsigned int p = 0; p <= N; ++p)
+            {
+                is.read(reinterpret_cast<char*>(batch.data() + p * batch.stride()), (std::streamsize)(h.count * sizeof(T)));
+                is.ignore((std::streamsize)((h.stride - h.count) * sizeof(T)));
+            }
+            return (bool)is;
+        };
+        template<class T> inline bool read(std::istream &is, RealBatch<T> &batch)
+        {
+            Header h;
+            if (!is.read(reinterpret_cast<char*>(&h), sizeof(h)) || !matches<Real<T>>(h, planes)) { is.setstate(std::ios::failbit); return false; }
+            batch = RealBatch<T>((std::size_t)h.count);
+            is.read(reinterpret_cast<char*>(batch.value()), (std::streamsize)(h.count * sizeof(T)));
+            return (bool)is;
+        };
+
+        ///View of planes written by `write()`, e.g. of a memory-mapped file, nothing is copied.
+        ///The viewed memory must outlive the view and be aligned to at least `alignof(T)`. Views of writable memory also give a DifferentiableBatch over it.
+        ///@tparam T Base type
+        ///@tparam N Number of derivatives
+        template<class T, unsigned int N>
+        class BatchView
+        {
+        private:
+            const T *_data = nullptr;
+            T *_writable = nullptr;
+            std::size_t _size = 0;
+            std::size_t _stride = 0;
+
+        public:
+            inline BatchView() noexcept {};
+            ///View of `bytes` bytes at writable `data`, e.g. of a private mapping
+            inline BatchView(void *data, std::size_t bytes) noexcept : BatchView(static_cast<const void*>(data), bytes) { if (valid()) _writable = const_cast<T*>(_data); };
+            ///View of `bytes` bytes at `data`, invalid if the header does not match or the data is too short or misaligned
+            inline BatchView(const void *data, std::size_t bytes) noexcept
+            {
+                Header h;
+                if (bytes < sizeof(h)) return;
+                std::memcpy(&h, data, sizeof(h));
+                const T *planes_data = reinterpret_cast<const T*>(static_cast<const char*>(data) + sizeof(h));
+                if (!matches<Differentiable<T, N>>(h, planes) || h.stride < h.count || reinterpret_cast<std::uintptr_t>(planes_data) % alignof(T) != 0) return;
+                if ((bytes - sizeof(h)) / sizeof(T) < (N + 1) * h.stride) return;
+                _data = planes_data;
+                _size = (std::size_t)h.count;
+                _stride = (std::size_t)h.stride;
+            };
+
+            inline bool valid()                                 const noexcept { return _data != nullptr; };
+            inline std::size_t size()                           const noexcept { return _size; };
+            inline std::size_t stride()                         const noexcept { return _stride; };
+            inline const T *value()                             const noexcept { return _data; };
+            inline const T *derivative(unsigned int i)          const noexcept { return _data + (i + 1) * _stride; };
+            inline Differentiable<T, N> get(std::size_t k)      const noexcept
+            {
+                Differentiable<T, N> x;
+                x.value = value()[k];
+                for (unsigned int i = 0; i < N; ++i) x.derivative[i] = derivative(i)[k];
+                return x;
+            };
+            ///DifferentiableBatch over the viewed memory, see `DifferentiableBatch::view()`. Empty for read-only views and for data written with another stride than batches of this build have.
+            inline DifferentiableBatch<T, N> batch()            const noexcept
+            {
+                if (_writable == nullptr || _stride != simd::stride<T>(_size)) return DifferentiableBatch<T, N>();
+                return DifferentiableBatch<T, N>::view(_writable, _size);
+            };
+        };
+
+        //Text format
+
+    #if !BD_TO_CHARS
+        #ifdef _WIN32
+        ///C locale, so that text does not depend on LC_NUMERIC
+        inline _locale_t _c_locale() noexcept { static const _locale_t c = _create_locale(LC_ALL, "C"); return c; };
+        inline void _strto(const char *s, char **end, float &v)       noexcept { v = (float)_strtod_l(s, end, _c_locale()); };
+        inline void _strto(const char *s, char **end, double &v)      noexcept { v = _strtod_l(s, end, _c_locale()); };
+        inline void _strto(const char *s, char **end, long double &v) noexcept { v = _strtold_l(s, end, _c_locale()); };
+        #else
+        ///C locale, so that text does not depend on LC_NUMERIC
+        inline locale_t _c_locale() noexcept { static const locale_t c = newlocale(LC_ALL_MASK, "C", (locale_t)0); return c; };
+        inline void _strto(const char *s, char **end, float &v)       noexcept { v = strtof_l(s, end, _c_locale()); };
+        inline void _strto(const char *s, char **end, double &v)      noexcept { v = strtod_l(s, end, _c_locale()); };
+        inline void _strto(const char *s, char **end, long double &v) noexcept { v = strtold_l(s, end, _c_locale()); };
+        #endif
+    #endif
+
+        ///Writes text of `v` that reads back exactly, shortest with std::to_chars, `max_digits10` significant digits otherwise. Returns end of text or nullptr if it does not fit.
+        template<class T> inline char *_format(char *first, char *last, const T &v) noexcept
+        {
+        #if BD_TO_CHARS
+            const std::to_chars_result r = std::to_chars(first, last, v);
+            return (r.ec == std::errc()) ? r.ptr : nullptr;
+        #else
+            char buffer[64];
+        #ifdef _WIN32
+            const int n = _snprintf_l(buffer, sizeof(buffer), "%.*Lg", _c_locale(), std::numeric_limits<T>::max_digits10, (long double)v);
+        #else
+            const locale_t previous = uselocale(_c_locale());
+            const int n = std::snprintf(buffer, sizeof(buffer), "%.*Lg", std::numeric_limits<T>::max_digits10, (long double)v);
+            uselocale(previous);
+        #endif
+            if (n < 0 || n > last - first) return nullptr;
+            std::memcpy(first, buffer, (std::size_t)n);
+            return first + n;
+        #endif
+        };
+
+        ///Reads number at `first` after optional spaces, returns end of number or nullptr
+        template<class T> inline const char *_parse(const char *first, const char *last, T &v) noexcept
+        {
+            while (first < last && *first == ' ') ++first;
+        #if BD_TO_CHARS
+            const std::from_chars_result r = std::from_chars(first, last, v);
+            return (r.ec == std::errc()) ? r.ptr : nullptr;
+        #else
+            char buffer[64];
+            std::size_t n = 0;
+            while (first + n < last && n + 1 < sizeof(buffer) && first[n] != ' ' && first[n] != '\n') { buffer[n] = first[n]; ++n; }
+            buffer[n] = '\0';
+            char *end;
+            _strto(buffer, &end, v);
+            return (end == buffer) ? nullptr : first + (end - buffer);
+        #endif
+        };
+
+        ///Writes value and derivatives separated by spaces, as `operator<<` does, but without streams, in a form that reads back exactly.
+        ///Returns end of text, or nullptr if it does not fit in `[first, last)`.
+        template<class X> inline char *format(char *first, char *last, const X &x) noexcept
+        {
+            first = _format(first, last, Format<X>::value(x));
+            for (unsigned int i = 0; i < Format<X>::derivatives && first != nullptr; ++i)
+            {
+                if (first == last) return nullptr;
+                *first++ = ' ';
+                first = _format(first, last, Format<X>::derivative(x)[i]);
+            }
+            return first;
+        };
+
+        ///Reads text written by `format()`, returns end of parsed text or nullptr on error
+        template<class X> inline const char *parse(const char *first, const char *last, X &x) noexcept
+        {
+            first = _parse(first, last, Format<X>::value(x));
+            for (unsigned int i = 0; i < Format<X>::derivatives && first != nullptr; ++i) first = _parse(first, last, Format<X>::derivative(x)[i]);
+            return first;
+        };
+
+        ///Text of `format()` as string
+        template<class X> inline std::string to_string(const X &x)
+        {
+            char buffer[(Format<X>::derivatives + 1) * 64];
+            char *end = format(buffer, buffer + sizeof(buffer), x);
+            return std::string(buffer, end);
+        };
+    }
+}
\ No newline at end of file
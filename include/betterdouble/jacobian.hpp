@@ -0,0 +1,200 @@
+#pragma once
+
+#include "differentiable.hpp"
+#include "differentiable-eigen.hpp"
+#include "hyper-dual.hpp"
+#include "hyper-dual-eigen.hpp"
+#include "thread-pool.hpp"
+#include "tracer.hpp"
+#include "tracer-eigen.hpp"
+#include <cstddef>
+#include <vector>
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+
+namespace bd
+{
+    ///Jacobian of `f` at `x`. Inputs are seeded in chunks of C, every chunk is one call of `f` with Differentiable<T, C> inputs.
+    ///Chunks run in parallel on `pool`, so `f` must be safe to call concurrently.
+    ///@tparam C Chunk width, number of derivatives carried by one evaluation
+    ///@param f Function `Eigen::Matrix<Differentiable<T, C>, Eigen::Dynamic, 1>(const Eigen::Matrix<Differentiable<T, C>, Eigen::Dynamic, 1> &)`, usually a generic lambda
+    ///@param x Point of evaluation
+    ///@param value Optional output, receives `f(x)`
+    template<unsigned int C = 8, class F, class T>
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> jacobian(const F &f, const Eigen::Matrix<T, Eigen::Dynamic, 1> &x, Eigen::Matrix<T, Eigen::Dynamic, 1> *value = nullptr, ThreadPool &pool = ThreadPool::global())
+    {
+        typedef Eigen::Matrix<Differentiable<T, C>, Eigen::Dynamic, 1> Vector;
+        const std::size_t n = (std::size_t)x.size();
+        const std::size_t chunks = (n + C - 1) / C;
+        Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> result;
+        auto evaluate = [&](std::size_t chunk)
+        {
+            Vector input(x.size());
+            for (std::size_t i = 0; i < n; ++i) input(i) = x(i);
+            for (std::size_t j = 0; j < C && chunk * C + j < n; ++j) input(chunk * C + j).derivative[j] = 1;
+            const Vector output = f(input);
+            if (chunk == 0)
+            {
+                result.resize(output.size(), x.size());
+                if (value != nullptr) { value->resize(output.size()); for (Eigen::Index r = 0; r < output.size(); ++r) (*value)(r) = output(r).value; }
+            }
+            for (std::size_t j = 0; j < C && chunk * C + j < n; ++j)
+                for (Eigen::Index r = 0; r < output.size(); ++r) result(r, chunk * C + j) = output(r).derivative[j];
+        };
+        evaluate(0); //learns output size, the rest only fills columns
+        pool.parallel_for((chunks > 1) ? (chunks - 1) : 0, [&](std::size_t chunk) { evaluate(chunk + 1); });
+        return result;
+    };
+
+    ///Gradient of scalar `f` at `x`, see `jacobian()`
+    ///@param f Function `Differentiable<T, C>(const Eigen::Matrix<Differentiable<T, C>, Eigen::Dynamic, 1> &)`
+    template<unsigned int C = 8, class F, class T>
+    Eigen::Matrix<T, Eigen::Dynamic, 1> gradient(const F &f, const Eigen::Matrix<T, Eigen::Dynamic, 1> &x, T *value = nullptr, ThreadPool &pool = ThreadPool::global())
+    {
+        typedef Eigen::Matrix<Differentiable<T, C>, Eigen::Dynamic, 1> Vector;
+        Eigen::Matrix<T, Eigen::Dynamic, 1> v;
+        const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> j = jacobian<C>([&f](const Vector &input) { Vector output(1); output(0) = f(input); return output; }, x, (value != nullptr) ? &v : nullptr, pool);
+        if (value != nullptr) *value = v(0);
+        return j.row(0).transpose();
+    };
+
+    ///Evaluates `f` at `x` with HyperDual inputs S, chunk `I` of C inputs seeded to the first C variables and, if `J != I`, chunk `J` to the next C
+    template<class S, unsigned int C, class F, class T>
+    inline S _hessian_block(const F &f, const Eigen::Matrix<T, Eigen::Dynamic, 1> &x, std::size_t I, std::size_t J)
+    {
+        const std::size_t n = (std::size_t)x.size();
+        Eigen::Matrix<S, Eigen::Dynamic, 1> input(x.size());
+        for (std::size_t i = 0; i < n; ++i) input(i) = x(i);
+        for (std::size_t j = 0; j < C && I * C + j < n; ++j) input(I * C + j).derivative[j] = 1;
+        if (J != I) for (std::size_t j = 0; j < C && J * C + j < n; ++j) input(J * C + j).derivative[C + j] = 1;
+        return f(input);
+    };
+
+    ///Hessian of scalar `f` at `x`. Inputs are split in chunks of C, every pair of chunks `(I, J)` with `I < J` is one call of `f` with HyperDual<T, 2 C> inputs,
+    ///chunk I seeded to the first C variables and chunk J to the last C, the call yields block `(I, J)` of the Hessian. Diagonal blocks `(I, I)` need only C variables
+    ///and are calls with HyperDual<T, C> inputs. Blocks below the diagonal are mirrored.
+    ///Pairs run in parallel on `pool`, so `f` must be safe to call concurrently.
+    ///@tparam C Chunk width, one call carries up to 2 C variables and C (2 C + 1) second derivatives
+    ///@param f Function `HyperDual<T, K>(const Eigen::Matrix<HyperDual<T, K>, Eigen::Dynamic, 1> &)` for K = C and K = 2 C, usually a generic lambda
+    ///@param x Point of evaluation
+    ///@param value Optional output, receives `f(x)`
+    ///@param gradient Optional output, receives the gradient of `f` at `x`
+    template<unsigned int C = 4, class F, class T>
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> hessian(const F &f, const Eigen::Matrix<T, Eigen::Dynamic, 1> &x, T *value = nullptr, Eigen::Matrix<T, Eigen::Dynamic, 1> *gradient = nullptr, ThreadPool &pool = ThreadPool::global())
+    {
+        typedef HyperDual<T, C> Diagonal;
+        typedef HyperDual<T, 2 * C> Scalar;
+        const std::size_t n = (std::size_t)x.size();
+        const std::size_t chunks = (n + C - 1) / C;
+        Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> result(x.size(), x.size());
+        if (gradient != nullptr) gradient->resize(x.size());
+        if (value != nullptr && n == 0) *value = f(Eigen::Matrix<Diagonal, Eigen::Dynamic, 1>(0)).value;
+        pool.parallel_for(chunks * (chunks + 1) / 2, [&](std::size_t pair)
+        {
+            //Pair number to block (I, J), row I holds chunks - I pairs
+            std::size_t I = 0, J = pair;
+            while (J >= chunks - I) { J -= chunks - I; ++I; }
+            J += I;
+            if (J == I)
+            {
+                const Diagonal output = _hessian_block<Diagonal, C>(f, x, I, I);
+                for (std::size_t i = 0; i < C && I * C + i < n; ++i)
+                    for (std::size_t j = 0; j <= i; ++j)
+                        result(I * C + i, I * C + j) = result(I * C + j, I * C + i) = output.second((unsigned int)i, (unsigned int)j);
+                if (gradient != nullptr) for (std::size_t i = 0; i < C && I * C + i < n; ++i) (*gradient)(I * C + i) = output.derivative[i];
+                if (pair == 0 && value != nullptr) *value = output.value;
+                return;
+            }
+            const Scalar output = _hessian_block<Scalar, C>(f, x, I, J);
+            for (std::size_t i = 0; i < C && I * C + i < n; ++i)
+                for (std::size_t j = 0; j < C && J * C + j < n; ++j)
+                    result(I * C + i, J * C + j) = result(J * C + j, I * C + i) = output.second((unsigned int)i, C + (unsigned int)j);
+        });
+        return result;
+    };
+
+    ///Sparse Jacobian of a fixed function. The sparsity pattern is detected once by calling `f` with Tracer<T> inputs, then columns that share no row get the same color.
+    ///Every evaluation seeds one derivative per color instead of one per column, so a Jacobian with at most k nonzeros per row needs about k derivatives.
+    ///Colors are seeded in chunks of C, every chunk is one call of `f` with Differentiable<T, C> inputs, as in `jacobian()`.
+    ///@tparam T Base type
+    ///@tparam C Chunk width, number of colors carried by one evaluation
+    template<class T, unsigned int C = 8>
+    class SparseJacobian
+    {
+    private:
+        Eigen::SparseMatrix<T> _pattern;  //ones at detected nonzeros, column-major
+        std::vector<unsigned int> _color; //color of every column
+        unsigned int _colors = 0;
+
+    public:
+        ///Detects the sparsity pattern of `f` at `x` and colors columns greedily, every column takes the smallest color not used by a column sharing a row with it
+        ///@param f Function `Eigen::Matrix<S, Eigen::Dynamic, 1>(const Eigen::Matrix<S, Eigen::Dynamic, 1> &)` for both S = Tracer<T> and S = Differentiable<T, C>, usually a generic lambda
+        ///@param x Point of detection, the pattern holds as long as `f` takes the same branches
+        template<class F>
+        SparseJacobian(const F &f, const Eigen::Matrix<T, Eigen::Dynamic, 1> &x)
+        {
+            typedef Eigen::Matrix<Tracer<T>, Eigen::Dynamic, 1> Vector;
+            Vector input(x.size());
+            for (Eigen::Index i = 0; i < x.size(); ++i) input(i) = Tracer<T>::variable(x(i), (unsigned int)i);
+            const Vector output = f(input);
+            std::vector<Eigen::Triplet<T>> entries;
+            for (Eigen::Index r = 0; r < output.size(); ++r)
+                for (unsigned int k = 0; k < output(r).index.size(); ++k) entries.emplace_back((int)r, (int)output(r).index[k], (T)1);
+            _pattern.resize(output.size(), x.size());
+            _pattern.setFromTriplets(entries.begin(), entries.end());
+            _pattern.makeCompressed();
+
+            const Eigen::SparseMatrix<T, Eigen::RowMajor> rows = _pattern;
+            const unsigned int none = (unsigned int)-1;
+            std::vector<Eigen::Index> used; //used[c] == j if color c is taken by a neighbour of column j
+            _color.assign((std::size_t)x.size(), none);
+            for (Eigen::Index j = 0; j < _pattern.cols(); ++j)
+            {
+                for (typename Eigen::SparseMatrix<T>::InnerIterator r(_pattern, j); r; ++r)
+                    for (typename Eigen::SparseMatrix<T, Eigen::RowMajor>::InnerIterator k(rows, r.row()); k; ++k)
+                        if (_color[k.col()] != none) used[_color[k.col()]] = j;
+                unsigned int c = 0;
+                while (c < used.size() && used[c] == j) ++c;
+                if (c == used.size()) used.push_back(-1);
+                _color[j] = c;
+                if (c + 1 > _colors) _colors = c + 1;
+            }
+        };
+
+        ///Detected pattern, ones at nonzeros
+        inline const Eigen::SparseMatrix<T> &pattern() const noexcept { return _pattern; };
+        ///Number of colors, i.e. derivatives needed per evaluation
+        inline unsigned int colors() const noexcept { return _colors; };
+        ///Color of column `j`
+        inline unsigned int color(Eigen::Index j) const noexcept { return _color[j]; };
+
+        ///Jacobian of `f` at `x`, nonzeros of the detected pattern only. Chunks run in parallel on `pool`, so `f` must be safe to call concurrently.
+        ///@param f Same function as given to the constructor
+        ///@param x Point of evaluation
+        ///@param value Optional output, receives `f(x)`
+        template<class F>
+        Eigen::SparseMatrix<T> compute(const F &f, const Eigen::Matrix<T, Eigen::Dynamic, 1> &x, Eigen::Matrix<T, Eigen::Dynamic, 1> *value = nullptr, ThreadPool &pool = ThreadPool::global()) const
+        {
+            typedef Eigen::Matrix<Differentiable<T, C>, Eigen::Dynamic, 1> Vector;
+            const std::size_t chunks = (_colors > 0) ? ((_colors + C - 1) / C) : 1;
+            Eigen::SparseMatrix<T> result = _pattern;
+            pool.parallel_for(chunks, [&](std::size_t chunk)
+            {
+                Vector input(x.size());
+                for (Eigen::Index i = 0; i < x.size(); ++i)
+                {
+                    input(i) = x(i);
+                    if (_color[i] / C == chunk) input(i).derivative[_color[i] % C] = 1;
+                }
+                const Vector output = f(input);
+                if (chunk == 0 && value != nullptr) { value->resize(output.size()); for (Eigen::Index r = 0; r < output.size(); ++r) (*value)(r) = output(r).value; }
+                for (Eigen::Index j = 0; j < result.cols(); ++j)
+                {
+                    if (_color[j] / C != chunk) continue;
+                    for (typename Eigen::SparseMatrix<T>::InnerIterator e(result, j); e; ++e) e.valueRef() = output(e.row()).derivative[_color[j] % C];
+                }
+            });
+            return result;
+        };
+    };
+}
\ No newline at end of file
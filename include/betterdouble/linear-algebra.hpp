@@ -0,0 +1,275 @@
+#pragma once
+
+#include "differentiable.hpp"
+#include "differentiable-eigen.hpp"
+#include <complex>
+#include <Eigen/Core>
+#include <Eigen/LU>
+#include <Eigen/Cholesky>
+#include <Eigen/Eigenvalues>
+
+namespace bd
+{
+    ///Base type and number of derivatives of a fixed-size Differentiable
+    template<class D> struct DifferentiableTraits;
+    template<class T, unsigned int N> struct DifferentiableTraits<Differentiable<T, N>>
+    {
+        static_assert(N != Dynamic && N != Sparse, "Split-plane linear algebra requires fixed number of derivatives");
+        typedef T Scalar;
+        static constexpr unsigned int size = N;
+        typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> Plane;
+        typedef Eigen::Matrix<Differentiable<T, N>, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+    };
+
+    ///Splits `a` into value matrix and derivative matrices. Derivative `i` occupies rows `i * rows` to `(i + 1) * rows` of `derivative`, or columns if `vertical` is false.
+    template<class A> void split(const Eigen::MatrixBase<A> &a, typename DifferentiableTraits<typename A::Scalar>::Plane &value, typename DifferentiableTraits<typename A::Scalar>::Plane &derivative, bool vertical = true)
+    {
+        constexpr unsigned int N = DifferentiableTraits<typename A::Scalar>::size;
+        const Eigen::Index rows = a.rows(), cols = a.cols();
+        value.resize(rows, cols);
+        if (vertical) derivative.resize(N * rows, cols); else derivative.resize(rows, N * cols);
+        for (Eigen::Index c = 0; c < cols; ++c)
+        {
+            for (Eigen::Index r = 0; r < rows; ++r)
+            {
+                const typename A::Scalar x = a(r, c);
+                value(r, c) = x.value;
+                if (vertical) for (unsigned int i = 0; i < N; ++i) derivative(i * rows + r, c) = x.derivative[i];
+                else          for (unsigned int i = 0; i < N; ++i) derivative(r, i * cols + c) = x.derivative[i];
+            }
+        }
+    };
+
+    ///Inverse of `split()`, assembles Differentiable matrix from value matrix and stacked derivative matrices
+    template<class T, unsigned int N> Eigen::Matrix<Differentiable<T, N>, Eigen::Dynamic, Eigen::Dynamic> join(const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> &value, const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> &derivative, bool vertical = true)
+    {
+        const Eigen::Index rows = value.rows(), cols = value.cols();
+        Eigen::Matrix<Differentiable<T, N>, Eigen::Dynamic, Eigen::Dynamic> a(rows, cols);
+        for (Eigen::Index c = 0; c < cols; ++c)
+        {
+            for (Eigen::Index r = 0; r < rows; ++r)
+            {
+                Differentiable<T, N> x = value(r, c);
+                if (vertical) for (unsigned int i = 0; i < N; ++i) x.derivative[i] = derivative(i * rows + r, c);
+                else          for (unsigned int i = 0; i < N; ++i) x.derivative[i] = derivative(r, i * cols + c);
+                a(r, c) = x;
+            }
+        }
+        return a;
+    };
+
+    ///Matrix product of Differentiable matrices computed on planes: `value = Av * Bv`, `derivative = dA * Bv + Av * dB`.
+    ///Three products of base type matrices replace the generic scalar path.
+    template<class A, class B>
+    typename DifferentiableTraits<typename A::Scalar>::Matrix product(const Eigen::MatrixBase<A> &a, const Eigen::MatrixBase<B> &b)
+    {
+        typedef DifferentiableTraits<typename A::Scalar> Traits;
+        constexpr unsigned int N = Traits::size;
+        typename Traits::Plane av, da, bv, db;
+        split(a, av, da, true);  //dA stacked vertically, multiplied by Bv at once
+        split(b, bv, db, false); //dB stacked horizontally, multiplied by Av at once
+        const Eigen::Index rows = a.rows(), cols = b.cols();
+        typename Traits::Plane dc = av * db;
+        const typename Traits::Plane dab = da * bv;
+        for (unsigned int i = 0; i < N; ++i) dc.middleCols(i * cols, cols) += dab.middleRows(i * rows, rows);
+        return join<typename Traits::Scalar, N>(av * bv, dc, false);
+    };
+
+    ///Linear solver for Differentiable matrices by implicit differentiation. Value matrix is factored once with `S`,
+    ///derivatives are solutions of `Av dx = dB - dA x` with the same factorization, all derivatives in one multi-column solve.
+    ///Overdetermined systems are solved in least squares sense, with full column rank.
+    ///@tparam MatrixType Eigen matrix of Differentiable<T, N>
+    ///@tparam S Eigen decomposition of base type matrix, e.g. `Eigen::ColPivHouseholderQR<Eigen::MatrixXd>`
+    template<class MatrixType, class S = Eigen::PartialPivLU<typename DifferentiableTraits<typename MatrixType::Scalar>::Plane>>
+    class LinearSolver
+    {
+    public:
+        typedef DifferentiableTraits<typename MatrixType::Scalar> Traits;
+        typedef typename Traits::Plane Plane;
+        typedef typename Traits::Matrix Matrix;
+
+    private:
+        S _decomposition;
+        Plane _value;
+        Plane _derivative;
+
+    public:
+        //Constructors
+        inline LinearSolver() {};
+        template<class A> inline explicit LinearSolver(const Eigen::MatrixBase<A> &a) { compute(a); };
+
+        ///Factors value matrix of `a`
+        template<class A> LinearSolver &compute(const Eigen::MatrixBase<A> &a)
+        {
+            split(a, _value, _derivative, true);
+            _decomposition.compute(_value);
+            return *this;
+        };
+
+        ///Solution `x` of `A x = B`
+        template<class B> Matrix solve(const Eigen::MatrixBase<B> &b) const
+        {
+            constexpr unsigned int N = Traits::size;
+            Plane bv, db;
+            split(b, bv, db, false);
+            const Eigen::Index rows = _value.rows(), cols = b.cols();
+            const Plane xv = _decomposition.solve(bv), dax = _derivative * xv;
+            for (unsigned int i = 0; i < N; ++i) db.middleCols(i * cols, cols) -= dax.middleRows(i * rows, rows);
+            Plane dx = _decomposition.solve(db);
+            if (_value.rows() > _value.cols())
+            {
+                //Least squares: residual r = B - A x adds (Av^T Av)^-1 dA^T r
+                const Plane r = bv - _value * xv;
+                Plane w(_value.cols(), N * cols);
+                for (unsigned int i = 0; i < N; ++i) w.middleCols(i * cols, cols).noalias() = _derivative.middleRows(i * rows, rows).transpose() * r;
+                dx += (_value.transpose() * _value).ldlt().solve(w);
+            }
+            return join<typename Traits::Scalar, N>(xv, dx, false);
+        };
+
+        inline const S &decomposition() const noexcept { return _decomposition; };
+    };
+
+    ///Solution `x` of `A x = B` for Differentiable matrices with partial pivoting LU, see `LinearSolver`
+    template<class A, class B>
+    typename DifferentiableTraits<typename A::Scalar>::Matrix solve(const Eigen::MatrixBase<A> &a, const Eigen::MatrixBase<B> &b)
+    {
+        return LinearSolver<typename DifferentiableTraits<typename A::Scalar>::Matrix>(a).solve(b);
+    };
+
+    ///Eigendecomposition of symmetric Differentiable matrix. Value matrix is decomposed once,
+    ///derivatives follow from first-order perturbation: `dl_k = v_k^T dA v_k`, `dv_k = sum_j v_j (v_j^T dA v_k) / (l_k - l_j)`.
+    ///Eigenvalues must be distinct, `dA` is assumed symmetric.
+    ///@tparam MatrixType Eigen matrix of Differentiable<T, N>
+    template<class MatrixType>
+    class SelfAdjointEigenSolver
+    {
+    public:
+        typedef DifferentiableTraits<typename MatrixType::Scalar> Traits;
+        typedef typename Traits::Plane Plane;
+        typedef typename Traits::Matrix Matrix;
+        typedef Eigen::Matrix<typename MatrixType::Scalar, Eigen::Dynamic, 1> Vector;
+
+    private:
+        Eigen::SelfAdjointEigenSolver<Plane> _solver;
+        Vector _eigenvalues;
+        Matrix _eigenvectors;
+
+    public:
+        //Constructors
+        inline SelfAdjointEigenSolver() {};
+        template<class A> inline explicit SelfAdjointEigenSolver(const Eigen::MatrixBase<A> &a) { compute(a); };
+
+        template<class A> SelfAdjointEigenSolver &compute(const Eigen::MatrixBase<A> &a)
+        {
+            constexpr unsigned int N = Traits::size;
+            const Eigen::Index n = a.rows();
+            Plane av, da;
+            split(a, av, da, true);
+            _solver.compute(av);
+            if (_solver.info() != Eigen::Success) return *this;
+            const Plane &v = _solver.eigenvectors();
+            const auto &l = _solver.eigenvalues();
+            const Plane dav = da * v;
+            Plane h(n, N * n);
+            for (unsigned int i = 0; i < N; ++i) h.middleCols(i * n, n) = dav.middleRows(i * n, n);
+            Plane m = v.transpose() * h; //block i is V^T dA_i V
+            Plane dl(n, N);
+            for (unsigned int i = 0; i < N; ++i)
+            {
+                for (Eigen::Index k = 0; k < n; ++k)
+                {
+                    dl(k, i) = m(k, i * n + k);
+                    for (Eigen::Index j = 0; j < n; ++j) m(j, i * n + k) = (j == k) ? 0 : m(j, i * n + k) / (l(k) - l(j));
+                }
+            }
+            _eigenvectors = join<typename Traits::Scalar, N>(v, v * m, false);
+            _eigenvalues = join<typename Traits::Scalar, N>(l, dl, false);
+            return *this;
+        };
+
+        inline const Vector &eigenvalues()   const noexcept { return _eigenvalues; };
+        inline const Matrix &eigenvectors()  const noexcept { return _eigenvectors; };
+        inline Eigen::ComputationInfo info() const noexcept { return _solver.info(); };
+    };
+
+    ///Eigendecomposition of general Differentiable matrix. Value matrix is decomposed once, derivatives follow from
+    ///first-order perturbation with left eigenvectors `W = V^-1`: `dl_k = (W dA V)_kk`, `dV = V (F o W dA V)`, `F_jk = 1 / (l_k - l_j)`.
+    ///Eigenvectors keep unit norm as in Eigen. Eigenvalues must be distinct.
+    ///@tparam MatrixType Eigen matrix of Differentiable<T, N>
+    template<class MatrixType>
+    class EigenSolver
+    {
+    public:
+        typedef DifferentiableTraits<typename MatrixType::Scalar> Traits;
+        typedef typename Traits::Plane Plane;
+        typedef std::complex<typename MatrixType::Scalar> ComplexScalar;
+        typedef Eigen::Matrix<ComplexScalar, Eigen::Dynamic, 1> EigenvalueType;
+        typedef Eigen::Matrix<ComplexScalar, Eigen::Dynamic, Eigen::Dynamic> EigenvectorsType;
+
+    private:
+        Eigen::EigenSolver<Plane> _solver;
+        EigenvalueType _eigenvalues;
+        EigenvectorsType _eigenvectors;
+
+        ///Combines real and imaginary planes of value and stacked derivative matrices
+        static EigenvectorsType _join(const Eigen::Matrix<std::complex<typename Traits::Scalar>, Eigen::Dynamic, Eigen::Dynamic> &value, const Eigen::Matrix<std::complex<typename Traits::Scalar>, Eigen::Dynamic, Eigen::Dynamic> &derivative)
+        {
+            constexpr unsigned int N = Traits::size;
+            const typename Traits::Matrix re = join<typename Traits::Scalar, N>(value.real(), derivative.real(), false);
+            const typename Traits::Matrix im = join<typename Traits::Scalar, N>(value.imag(), derivative.imag(), false);
+            EigenvectorsType c(value.rows(), value.cols());
+            for (Eigen::Index j = 0; j < value.cols(); ++j) for (Eigen::Index r = 0; r < value.rows(); ++r) c(r, j) = ComplexScalar(re(r, j), im(r, j));
+            return c;
+        };
+
+    public:
+        //Constructors
+        inline EigenSolver() {};
+        template<class A> inline explicit EigenSolver(const Eigen::MatrixBase<A> &a) { compute(a); };
+
+        template<class A> EigenSolver &compute(const Eigen::MatrixBase<A> &a)
+        {
+            typedef std::complex<typename Traits::Scalar> C;
+            typedef Eigen::Matrix<C, Eigen::Dynamic, Eigen::Dynamic> Complex;
+            constexpr unsigned int N = Traits::size;
+            const Eigen::Index n = a.rows();
+            Plane av, da;
+            split(a, av, da, true);
+            _solver.compute(av);
+            if (_solver.info() != Eigen::Success) return *this;
+            const Complex v = _solver.eigenvectors();
+            const Complex l = _solver.eigenvalues();
+            const Complex dav = da.template cast<C>() * v;
+            Complex h(n, N * n);
+            for (unsigned int i = 0; i < N; ++i) h.middleCols(i * n, n) = dav.middleRows(i * n, n);
+            Complex m = v.partialPivLu().solve(h); //block i is W dA_i V
+            Complex dl(n, N);
+            for (unsigned int i = 0; i < N; ++i)
+            {
+                for (Eigen::Index k = 0; k < n; ++k)
+                {
+                    dl(k, i) = m(k, i * n + k);
+                    for (Eigen::Index j = 0; j < n; ++j) m(j, i * n + k) = (j == k) ? C(0) : C(m(j, i * n + k) / (l(k) - l(j)));
+                }
+            }
+            Complex dv = v * m;
+            for (unsigned int i = 0; i < N; ++i)
+            {
+                for (Eigen::Index k = 0; k < n; ++k)
+                {
+                    //Keeps |v_k| = 1: removes the component that changes the norm
+                    const typename Traits::Scalar s = std::real(v.col(k).dot(dv.col(i * n + k)));
+                    dv.col(i * n + k) -= s * v.col(k);
+                }
+            }
+            _eigenvectors = _join(v, dv);
+            _eigenvalues = _join(l, dl).col(0);
+            return *this;
+        };
+
+        inline const EigenvalueType &eigenvalues()    const noexcept { return _eigenvalues; };
+        inline const EigenvectorsType &eigenvectors() const noexcept { return _eigenvectors; };
+        inline Eigen::ComputationInfo info()          const noexcept { return _solver.info(); };
+    };
+}
@@ -0,0 +1,227 @@
+#pragma once
+
+#include "differentiable.hpp"
+#include "differentiable-eigen.hpp"
+#include "thread-pool.hpp"
+#include <cmath>
+#include <cstddef>
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/IterativeLinearSolvers>
+
+namespace bd
+{
+    template<class T, class F> class JacobianOperator;
+}
+
+namespace Eigen
+{
+    namespace internal
+    {
+        //Matrix-free operators pose as sparse matrices to Eigen's iterative solvers
+        template<class T, class F> struct traits<bd::JacobianOperator<T, F>> : public traits<Eigen::SparseMatrix<T>> {};
+    }
+}
+
+namespace bd
+{
+    ///Jacobian of `f` at a point as a matrix-free Eigen operator, for Eigen's iterative solvers such as `Eigen::BiCGSTAB` or `Eigen::GMRES` of unsupported/Eigen/IterativeSolvers.
+    ///`J * v` is one call of `f` with Differentiable<T, 1> inputs seeded with `v`, so the Jacobian is never formed.
+    ///`apply<K>(V)` multiplies K columns of `V` per call of `f` with Differentiable<T, K> inputs instead.
+    ///Solvers keep a pointer to the operator, and the operator keeps a pointer to `f`.
+    ///@tparam T Base type
+    ///@tparam F Function `Eigen::Matrix<Differentiable<T, K>, Eigen::Dynamic, 1>(const Eigen::Matrix<Differentiable<T, K>, Eigen::Dynamic, 1> &)`, usually a generic lambda,
+    ///only K = 1 is needed unless `apply<K>()` is used
+    template<class T, class F>
+    class JacobianOperator : public Eigen::EigenBase<JacobianOperator<T, F>>
+    {
+    public:
+        typedef T Scalar;
+        typedef T RealScalar;
+        typedef int StorageIndex;
+        typedef Eigen::Matrix<T, Eigen::Dynamic, 1> Vector;
+        typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+        enum { ColsAtCompileTime = Eigen::Dynamic, MaxColsAtCompileTime = Eigen::Dynamic, IsRowMajor = false };
+
+    private:
+        const F *_f;
+        Vector _x;
+        Vector _value;
+
+    public:
+        //Constructors
+        ///Operator of `f` at `x`, evaluates `f(x)` once
+        inline JacobianOperator(const F &f, const Vector &x) : _f(&f) { update(x); };
+
+        ///Moves the operator to `x`, evaluates `f(x)` once
+        inline JacobianOperator &update(const Vector &x)
+        {
+            typedef Eigen::Matrix<Differentiable<T, 1>, Eigen::Dynamic, 1> Input;
+            _x = x;
+            const Input output = (*_f)(Input(x.template cast<Differentiable<T, 1>>()));
+            _value.resize(output.size());
+            for (Eigen::Index r = 0; r < output.size(); ++r) _value(r) = output(r).value;
+            return *this;
+        };
+
+        //Access
+        inline Eigen::Index rows()   const noexcept { return _value.size(); };
+        inline Eigen::Index cols()   const noexcept { return _x.size(); };
+        inline const Vector &point() const noexcept { return _x; };
+        ///Value of `f` at `point()`
+        inline const Vector &value() const noexcept { return _value; };
+
+        ///Jacobian-vector product `J v`, one call of `f`
+        template<class V> Vector apply(const Eigen::MatrixBase<V> &v) const
+        {
+            typedef Eigen::Matrix<Differentiable<T, 1>, Eigen::Dynamic, 1> Input;
+            Input input(_x.size());
+            for (Eigen::Index i = 0; i < _x.size(); ++i) { input(i).value = _x(i); input(i).derivative[0] = v(i); }
+            const Input output = (*_f)(input);
+            Vector result(output.size());
+            for (Eigen::Index r = 0; r < output.size(); ++r) result(r) = output(r).derivative[0];
+            return result;
+        };
+
+        ///Products `J V` of many directions, K columns of `V` per call of `f`. Chunks run in parallel on `pool`, so `f` must be safe to call concurrently.
+        ///@tparam K Chunk width, number of directions carried by one evaluation
+        template<unsigned int K, class V> Matrix apply(const Eigen::MatrixBase<V> &v, ThreadPool &pool = ThreadPool::global()) const
+        {
+            typedef Eigen::Matrix<Differentiable<T, K>, Eigen::Dynamic, 1> Input;
+            const std::size_t n = (std::size_t)v.cols();
+            Matrix result(rows(), v.cols());
+            pool.parallel_for((n + K - 1) / K, [&](std::size_t chunk)
+            {
+                Input input(_x.size());
+                for (Eigen::Index i = 0; i < _x.size(); ++i)
+                {
+                    input(i) = _x(i);
+                    for (std::size_t j = 0; j < K && chunk * K + j < n; ++j) input(i).derivative[j] = v(i, (Eigen::Index)(chunk * K + j));
+                }
+                const Input output = (*_f)(input);
+                for (std::size_t j = 0; j < K && chunk * K + j < n; ++j)
+                    for (Eigen::Index r = 0; r < output.size(); ++r) result(r, (Eigen::Index)(chunk * K + j)) = output(r).derivative[j];
+            });
+            return result;
+        };
+
+        ///Eigen product expression, evaluated by `apply()`
+        template<class V> inline Eigen::Product<JacobianOperator, V, Eigen::AliasFreeProduct> operator*(const Eigen::MatrixBase<V> &v) const
+        {
+            return Eigen::Product<JacobianOperator, V, Eigen::AliasFreeProduct>(*this, v.derived());
+        };
+    };
+
+    ///Diagonal preconditioner of a JacobianOperator, exact for Jacobians with nonzeros only at `|r - c| < W`. The diagonal is probed with W directions in one call of `f`,
+    ///direction k sums unit vectors of columns `j % W == k`, so wider entries would be mistaken for diagonal ones.
+    ///Follows the preconditioner interface of Eigen's iterative solvers, which call `compute()` with the operator.
+    ///@tparam T Base type
+    ///@tparam W Number of probing directions, 2 for tridiagonal Jacobians
+    template<class T, unsigned int W = 3>
+    class ProbedDiagonalPreconditioner
+    {
+    private:
+        Eigen::Matrix<T, Eigen::Dynamic, 1> _inverse;
+
+    public:
+        //Constructors
+        inline ProbedDiagonalPreconditioner() {};
+        template<class M> inline explicit ProbedDiagonalPreconditioner(const M &op) { compute(op); };
+
+        template<class M> inline ProbedDiagonalPreconditioner &analyzePattern(const M &) { return *this; };
+        template<class M> inline ProbedDiagonalPreconditioner &factorize(const M &op) { return compute(op); };
+        template<class M> ProbedDiagonalPreconditioner &compute(const M &op)
+        {
+            Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> probe = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(op.cols(), W);
+            for (Eigen::Index j = 0; j < op.cols(); ++j) probe(j, j % W) = 1;
+            const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> jp = op.template apply<W>(probe);
+            _inverse.resize(op.rows());
+            for (Eigen::Index r = 0; r < op.rows(); ++r) _inverse(r) = (jp(r, r % W) != 0) ? 1 / jp(r, r % W) : (T)1;
+            return *this;
+        };
+
+        template<class B> inline Eigen::Matrix<T, Eigen::Dynamic, 1> solve(const Eigen::MatrixBase<B> &b) const { return _inverse.cwiseProduct(b); };
+        inline const Eigen::Matrix<T, Eigen::Dynamic, 1> &inverse() const noexcept { return _inverse; };
+        inline Eigen::ComputationInfo info() const noexcept { return Eigen::Success; };
+    };
+
+    ///Settings of `newton_krylov()`
+    template<class T>
+    struct NewtonKrylovSettings
+    {
+        T tolerance = (T)1e-10;        //stops when `|f(x)| <= tolerance`
+        unsigned int iterations = 50;  //Newton steps
+        T forcing = (T)1e-4;           //relative tolerance of every linear solve
+        unsigned int linear = 1000;    //iterations of every linear solve
+        unsigned int backtracks = 20;  //step halvings until `|f|` decreases
+    };
+
+    ///Outcome of `newton_krylov()`
+    template<class T>
+    struct NewtonKrylovResult
+    {
+        Eigen::ComputationInfo info = Eigen::NoConvergence;
+        unsigned int iterations = 0;        //Newton steps taken
+        unsigned int linear = 0;            //linear iterations of all steps
+        T residual = 0;                     //`|f(x)|` at the end
+    };
+
+    ///Solves `f(x) = 0` by Jacobian-free Newton-Krylov: every Newton step solves `J dx = -f(x)` with solver `S` over a JacobianOperator, so J is never formed,
+    ///then halves the step until `|f|` decreases. The preconditioner `P` is computed by the solver from the operator at every step, see ProbedDiagonalPreconditioner.
+    ///@tparam S Eigen iterative solver template `S<Matrix, Preconditioner>`, e.g. `Eigen::BiCGSTAB` or `Eigen::GMRES`
+    ///@tparam P Eigen preconditioner, `P::compute()` receives the JacobianOperator
+    ///@param f Function `Eigen::Matrix<Differentiable<T, 1>, Eigen::Dynamic, 1>(const Eigen::Matrix<Differentiable<T, 1>, Eigen::Dynamic, 1> &)`
+    ///@param x Initial guess, receives the solution
+    template<template<class, class> class S = Eigen::BiCGSTAB, class P = Eigen::IdentityPreconditioner, class F, class T>
+    NewtonKrylovResult<T> newton_krylov(const F &f, Eigen::Matrix<T, Eigen::Dynamic, 1> &x, const NewtonKrylovSettings<T> &settings = NewtonKrylovSettings<T>())
+    {
+        typedef JacobianOperator<T, F> Operator;
+        NewtonKrylovResult<T> result;
+        Operator op(f, x);
+        S<Operator, P> solver;
+        solver.setTolerance(settings.forcing);
+        solver.setMaxIterations((Eigen::Index)settings.linear);
+        result.residual = op.value().norm();
+        for (; result.iterations < settings.iterations; ++result.iterations)
+        {
+            if (result.residual <= settings.tolerance) { result.info = Eigen::Success; return result; }
+            solver.compute(op);
+            if (solver.info() != Eigen::Success) { result.info = solver.info(); return result; }
+            const typename Operator::Vector dx = solver.solve(-op.value());
+            result.linear += (unsigned int)solver.iterations();
+            if (solver.info() == Eigen::NumericalIssue) { result.info = Eigen::NumericalIssue; return result; }
+
+            //Backtracking, the operator is moved to every trial point
+            const typename Operator::Vector x0 = x;
+            const T residual = result.residual;
+            T step = 1;
+            for (unsigned int k = 0;; ++k)
+            {
+                x = x0 + step * dx;
+                op.update(x);
+                result.residual = op.value().norm();
+                if (result.residual < residual) break;
+                if (k == settings.backtracks) { result.info = Eigen::NoConvergence; return result; }
+                step /= 2;
+            }
+        }
+        result.info = (result.residual <= settings.tolerance) ? Eigen::Success : Eigen::NoConvergence;
+        return result;
+    };
+}
+
+namespace Eigen
+{
+    namespace internal
+    {
+        //Products of JacobianOperator with dense vectors, as used by iterative solvers
+        template<class T, class F, class V>
+        struct generic_product_impl<bd::JacobianOperator<T, F>, V, SparseShape, DenseShape, GemvProduct> : generic_product_impl_base<bd::JacobianOperator<T, F>, V, generic_product_impl<bd::JacobianOperator<T, F>, V>>
+        {
+            template<class Dest> static void scaleAndAddTo(Dest &dst, const bd::JacobianOperator<T, F> &lhs, const V &rhs, const T &alpha)
+            {
+                dst.noalias() += alpha * lhs.apply(rhs);
+            };
+        };
+    }
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "real.hpp"
+#include "simd.hpp"
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+namespace bd
+{
+    //Predefine
+    template<class T> class RealBatch;
+
+    ///Many values of Real<T> stored contiguously, arithmetics and functions apply lane-wise
+    ///@tparam T Base type
+    template<class T = double>
+    class RealBatch
+    {
+    private:
+        simd::Buffer<T> _data;
+
+    public:
+        //Constructors & assignment
+        inline RealBatch()                                          noexcept {};
+        inline explicit RealBatch(std::size_t size)                          : _data(size) {};
+        inline RealBatch(std::size_t size, const T &value)                   : _data(size) { simd::fill(size, _data.data(), value); };
+
+        //Access
+        inline std::size_t size()                             const noexcept { return _data.size(); };
+        inline T *value()                                           noexcept { return _data.data(); };
+        inline const T *value()                               const noexcept { return _data.data(); };
+        inline T &operator[](std::size_t k)                         noexcept { return _data[k]; };
+        inline const T &operator[](std::size_t k)             const noexcept { return _data[k]; };
+        inline Real<T> get(std::size_t k)                     const noexcept { return _data[k]; };
+        inline void set(std::size_t k, const Real<T> &x)            noexcept { _data[k] = x.value; };
+
+        //Kernels
+        ///Sets `v` to `f(x)` lane-wise, `v` may be `x`
+        template<class F> static inline void unary(RealBatch &v, const RealBatch &x, const F &f)
+        {
+            for (std::size_t k = 0; k < x.size(); ++k) v._data[k] = f(x._data[k]);
+        };
+        ///Sets `v` to `f(a, b)` lane-wise, `v` may be `a` or `b`
+        template<class F> static inline void binary(RealBatch &v, const RealBatch &a, const RealBatch &b, const F &f)
+        {
+            assert(a.size() == b.size());
+            for (std::size_t k = 0; k < a.size(); ++k) v._data[k] = f(a._data[k], b._data[k]);
+        };
+
+        //Arithmetics
+        inline RealBatch &operator+=(const RealBatch &other) noexcept { assert(size() == other.size()); simd::add(size(), value(), value(), other.value()); return *this; };
+        inline RealBatch &operator-=(const RealBatch &other) noexcept { assert(size() == other.size()); simd::sub(size(), value(), value(), other.value()); return *this; };
+        inline RealBatch &operator*=(const RealBatch &other) noexcept { assert(size() == other.size()); simd::mul(size(), value(), value(), other.value()); return *this; };
+        inline RealBatch &operator/=(const RealBatch &other) noexcept { binary(*this, *this, other, [](T a, T b) { return a / b; }); return *this; };
+
+        //Transformations
+        inline RealBatch operator+() const & { return *this; };
+        inline RealBatch operator+() &&      { return std::move(*this); };
+        inline RealBatch operator-() const & { RealBatch v = *this; return -std::move(v); };
+        inline RealBatch operator-() &&      { simd::scale(size(), value(), value(), (T)-1); return std::move(*this); };
+    };
+
+    //Basic arithmetics, rvalue operands donate their buffers
+    template<class T> inline RealBatch<T> operator+(RealBatch<T> a, const RealBatch<T> &b)  { return std::move(a += b); };
+    template<class T> inline RealBatch<T> operator+(const RealBatch<T> &a, RealBatch<T> &&b) { return std::move(b += a); };
+    template<class T> inline RealBatch<T> operator-(RealBatch<T> a, const RealBatch<T> &b)  { return std::move(a -= b); };
+    template<class T> inline RealBatch<T> operator-(const RealBatch<T> &a, RealBatch<T> &&b) { assert(a.size() == b.size()); simd::sub(b.size(), b.value(), a.value(), b.value()); return std::move(b); };
+    template<class T> inline RealBatch<T> operator*(RealBatch<T> a, const RealBatch<T> &b)  { return std::move(a *= b); };
+    template<class T> inline RealBatch<T> operator*(const RealBatch<T> &a, RealBatch<T> &&b) { return std::move(b *= a); };
+    template<class T> inline RealBatch<T> operator/(RealBatch<T> a, const RealBatch<T> &b)  { return std::move(a /= b); };
+    template<class T> inline RealBatch<T> operator/(const RealBatch<T> &a, RealBatch<T> &&b) { RealBatch<T>::binary(b, a, b, [](T a, T b) { return a / b; }); return std::move(b); };
+
+    //Trigonometric functions
+    template<class T> inline RealBatch<T> cos  (RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::cos  (x); }); return x; };
+    template<class T> inline RealBatch<T> sin  (RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::sin  (x); }); return x; };
+    template<class T> inline RealBatch<T> tan  (RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::tan  (x); }); return x; };
+    template<class T> inline RealBatch<T> acos (RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::acos (x); }); return x; };
+    template<class T> inline RealBatch<T> asin (RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::asin (x); }); return x; };
+    template<class T> inline RealBatch<T> atan (RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::atan (x); }); return x; };
+    template<class T> inline RealBatch<T> atan2(RealBatch<T> y, const RealBatch<T> &x) { RealBatch<T>::binary(y, y, x, [](T y, T x) { return std::atan2(y, x); }); return y; };
+
+    //Hyperbolic functions
+    template<class T> inline RealBatch<T> cosh (RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::cosh (x); }); return x; };
+    template<class T> inline RealBatch<T> sinh (RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::sinh (x); }); return x; };
+    template<class T> inline RealBatch<T> tanh (RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::tanh (x); }); return x; };
+    template<class T> inline RealBatch<T> acosh(RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::acosh(x); }); return x; };
+    template<class T> inline RealBatch<T> asinh(RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::asinh(x); }); return x; };
+    template<class T> inline RealBatch<T> atanh(RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::atanh(x); }); return x; };
+
+    //Exponential and logarithmic functions
+    template<class T> inline RealBatch<T> exp  (RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::exp  (x); }); return x; };
+    template<class T> inline RealBatch<T> log  (RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::log  (x); }); return x; };
+    template<class T> inline RealBatch<T> log10(RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::log10(x); }); return x; };
+    template<class T> inline RealBatch<T> exp2 (RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::exp2 (x); }); return x; };
+    template<class T> inline RealBatch<T> expm1(RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::expm1(x); }); return x; };
+    template<class T> inline RealBatch<T> log1p(RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::log1p(x); }); return x; };
+    template<class T> inline RealBatch<T> log2 (RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::log2 (x); }); return x; };
+    template<class T> inline RealBatch<T> logb (RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::logb (x); }); return x; };
+
+    //Power functions
+    template<class T> inline RealBatch<T> pow  (RealBatch<T> base, const RealBatch<T> &exponent) { RealBatch<T>::binary(base, base, exponent, [](T b, T e) { return std::pow(b, e); }); return base; };
+    template<class T> inline RealBatch<T> sqrt (RealBatch<T> x)                                  { RealBatch<T>::unary(x, x, [](T x) { return std::sqrt(x); }); return x; };
+    template<class T> inline RealBatch<T> cbrt (RealBatch<T> x)                                  { RealBatch<T>::unary(x, x, [](T x) { return std::cbrt(x); }); return x; };
+    template<class T> inline RealBatch<T> hypot(RealBatch<T> x, const RealBatch<T> &y)           { RealBatch<T>::binary(x, x, y, [](T x, T y) { return std::hypot(x, y); }); return x; };
+
+    //Error and gamma functions
+    template<class T> inline RealBatch<T> erf   (RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::erf   (x); }); return x; };
+    template<class T> inline RealBatch<T> erfc  (RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::erfc  (x); }); return x; };
+    template<class T> inline RealBatch<T> tgamma(RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::tgamma(x); }); return x; };
+    template<class T> inline RealBatch<T> lgamma(RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::lgamma(x); }); return x; };
+
+    //Rounding and remainder functions
+    template<class T> inline RealBatch<T> ceil     (RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::ceil     (x); }); return x; };
+    template<class T> inline RealBatch<T> floor    (RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::floor    (x); }); return x; };
+    template<class T> inline RealBatch<T> trunc    (RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::trunc    (x); }); return x; };
+    template<class T> inline RealBatch<T> round    (RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::round    (x); }); return x; };
+    template<class T> inline RealBatch<T> rint     (RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::rint     (x); }); return x; };
+    template<class T> inline RealBatch<T> nearbyint(RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::nearbyint(x); }); return x; };
+    template<class T> inline RealBatch<T> fmod     (RealBatch<T> numer, const RealBatch<T> &denom) { RealBatch<T>::binary(numer, numer, denom, [](T n, T d) { return std::fmod     (n, d); }); return numer; };
+    template<class T> inline RealBatch<T> remainder(RealBatch<T> numer, const RealBatch<T> &denom) { RealBatch<T>::binary(numer, numer, denom, [](T n, T d) { return std::remainder(n, d); }); return numer; };
+
+    //Floating-point manipulation functions
+    template<class T> inline RealBatch<T> copysign (RealBatch<T> x, const RealBatch<T> &y) { RealBatch<T>::binary(x, x, y, [](T x, T y) { return std::copysign (x, y); }); return x; };
+    template<class T> inline RealBatch<T> nextafter(RealBatch<T> x, const RealBatch<T> &y) { RealBatch<T>::binary(x, x, y, [](T x, T y) { return std::nextafter(x, y); }); return x; };
+
+    //Minimum, maximum, difference functions
+    template<class T> inline RealBatch<T> fdim(RealBatch<T> x, const RealBatch<T> &y) { RealBatch<T>::binary(x, x, y, [](T x, T y) { return std::fdim(x, y); }); return x; };
+    template<class T> inline RealBatch<T> fmax(RealBatch<T> x, const RealBatch<T> &y) { RealBatch<T>::binary(x, x, y, [](T x, T y) { return std::fmax(x, y); }); return x; };
+    template<class T> inline RealBatch<T> fmin(RealBatch<T> x, const RealBatch<T> &y) { RealBatch<T>::binary(x, x, y, [](T x, T y) { return std::fmin(x, y); }); return x; };
+
+    //Other functions
+    template<class T> inline RealBatch<T> fabs(RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::fabs(x); }); return x; };
+    template<class T> inline RealBatch<T> abs (RealBatch<T> x) { RealBatch<T>::unary(x, x, [](T x) { return std::abs (x); }); return x; };
+    template<class T> inline RealBatch<T> fma (RealBatch<T> x, const RealBatch<T> &y, const RealBatch<T> &z) { return std::move((x *= y) += z); };
+
+    //Defines
+    typedef RealBatch<float> FloatBatch;
+    typedef RealBatch<double> DoubleBatch;
+    typedef RealBatch<long double> LongDoubleBatch;
+}
@@ -31,4 +31,110 @@ template<class T> struct Eigen::NumTraits<bd::Real<T>>
     static constexpr inline int         max_exponent   () noexcept { return std::numeric_limits<T>::max_exponent; }
     static constexpr inline bd::Real<T> infinity       () noexcept { return (bd::Real<T>)std::numeric_limits<T>::infinity(); }
     static constexpr inline bd::Real<T> quiet_NaN      () noexcept { return (bd::Real<T>)std::numeric_limits<T>::quiet_NaN(); }
-};
\ No newline at end of file
+};
+
+#if !defined(BD_NO_SIMD) && defined(EIGEN_VECTORIZE_SSE2)
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wignored-attributes" //vector types as template arguments, as in Eigen
+#endif
+namespace bd
+{
+    ///Eigen packet of Real<T>, same registers as native Eigen packet `P` of T
+    ///@tparam P Native Eigen packet, e.g. `Eigen::internal::Packet4d`
+    template<class P> struct RealPacket
+    {
+        P v;
+    };
+
+    //Functions called by Eigen without qualification, found by argument-dependent lookup
+    template<class P, int N> inline void ptranspose(Eigen::internal::PacketBlock<RealPacket<P>, N> &kernel)
+    {
+        Eigen::internal::PacketBlock<P, N> k;
+        for (int i = 0; i < N; i++) k.packet[i] = kernel.packet[i].v;
+        Eigen::internal::ptranspose(k);
+        for (int i = 0; i < N; i++) kernel.packet[i].v = k.packet[i];
+    };
+
+    template<class P> inline typename std::conditional<Eigen::internal::unpacket_traits<P>::size % 8 == 0, RealPacket<typename Eigen::internal::unpacket_traits<P>::half>, RealPacket<P>>::type predux_half_dowto4(const RealPacket<P> &a)
+    {
+        return { Eigen::internal::predux_half_dowto4(a.v) };
+    };
+}
+
+namespace Eigen
+{
+    namespace internal
+    {
+        template<class T> struct RealPacketTraits : default_packet_traits
+        {
+            static_assert(sizeof(bd::Real<T>) == sizeof(T) && alignof(bd::Real<T>) == alignof(T), "Real<T> must have layout of T");
+            typedef bd::RealPacket<typename packet_traits<T>::type> type;
+            typedef bd::RealPacket<typename packet_traits<T>::half> half;
+            enum
+            {
+                Vectorizable = 1,
+                AlignedOnScalar = 1,
+                size = packet_traits<T>::size,
+                HasHalfPacket = packet_traits<T>::HasHalfPacket,
+                HasSetLinear = 0,
+                HasDiv = 1,
+                HasSqrt = 1
+            };
+        };
+        template<> struct packet_traits<bd::Real<float>>  : RealPacketTraits<float>  {};
+        template<> struct packet_traits<bd::Real<double>> : RealPacketTraits<double> {};
+
+        template<class P> struct unpacket_traits<bd::RealPacket<P>> : unpacket_traits<P>
+        {
+            typedef bd::Real<typename unpacket_traits<P>::type> type;
+            typedef bd::RealPacket<typename unpacket_traits<P>::half> half;
+        };
+
+        //Every operation forwards to the native packet
+        #define BD_EIGEN_REAL_PACKET(P) \
+            template<> EIGEN_STRONG_INLINE bd::RealPacket<P> pset1    <bd::RealPacket<P>>(const bd::Real<unpacket_traits<P>::type> &a)    { return { pset1    <P>(a.value) }; } \
+            template<> EIGEN_STRONG_INLINE bd::RealPacket<P> pload    <bd::RealPacket<P>>(const bd::Real<unpacket_traits<P>::type> *from) { return { pload    <P>(reinterpret_cast<const unpacket_traits<P>::type*>(from)) }; } \
+            template<> EIGEN_STRONG_INLINE bd::RealPacket<P> ploadu   <bd::RealPacket<P>>(const bd::Real<unpacket_traits<P>::type> *from) { return { ploadu   <P>(reinterpret_cast<const unpacket_traits<P>::type*>(from)) }; } \
+            template<> EIGEN_STRONG_INLINE bd::RealPacket<P> ploaddup <bd::RealPacket<P>>(const bd::Real<unpacket_traits<P>::type> *from) { return { ploaddup <P>(reinterpret_cast<const unpacket_traits<P>::type*>(from)) }; } \
+            template<> EIGEN_STRONG_INLINE bd::RealPacket<P> ploadquad<bd::RealPacket<P>>(const bd::Real<unpacket_traits<P>::type> *from) { return { ploadquad<P>(reinterpret_cast<const unpacket_traits<P>::type*>(from)) }; } \
+            template<> EIGEN_STRONG_INLINE void pstore <bd::Real<unpacket_traits<P>::type>, bd::RealPacket<P>>(bd::Real<unpacket_traits<P>::type> *to, const bd::RealPacket<P> &from) { pstore (reinterpret_cast<unpacket_traits<P>::type*>(to), from.v); } \
+            template<> EIGEN_STRONG_INLINE void pstoreu<bd::Real<unpacket_traits<P>::type>, bd::RealPacket<P>>(bd::Real<unpacket_traits<P>::type> *to, const bd::RealPacket<P> &from) { pstoreu(reinterpret_cast<unpacket_traits<P>::type*>(to), from.v); } \
+            template<> EIGEN_STRONG_INLINE bd::RealPacket<P> pgather<bd::Real<unpacket_traits<P>::type>, bd::RealPacket<P>>(const bd::Real<unpacket_traits<P>::type> *from, Index stride) { return { pgather<unpacket_traits<P>::type, P>(reinterpret_cast<const unpacket_traits<P>::type*>(from), stride) }; } \
+            template<> EIGEN_STRONG_INLINE void pscatter<bd::Real<unpacket_traits<P>::type>, bd::RealPacket<P>>(bd::Real<unpacket_traits<P>::type> *to, const bd::RealPacket<P> &from, Index stride) { pscatter<unpacket_traits<P>::type, P>(reinterpret_cast<unpacket_traits<P>::type*>(to), from.v, stride); } \
+            template<> EIGEN_STRONG_INLINE bd::RealPacket<P> padd   <bd::RealPacket<P>>(const bd::RealPacket<P> &a, const bd::RealPacket<P> &b) { return { padd(a.v, b.v) }; } \
+            template<> EIGEN_STRONG_INLINE bd::RealPacket<P> psub   <bd::RealPacket<P>>(const bd::RealPacket<P> &a, const bd::RealPacket<P> &b) { return { psub(a.v, b.v) }; } \
+            template<> EIGEN_STRONG_INLINE bd::RealPacket<P> pmul   <bd::RealPacket<P>>(const bd::RealPacket<P> &a, const bd::RealPacket<P> &b) { return { pmul(a.v, b.v) }; } \
+            template<> EIGEN_STRONG_INLINE bd::RealPacket<P> pdiv   <bd::RealPacket<P>>(const bd::RealPacket<P> &a, const bd::RealPacket<P> &b) { return { pdiv(a.v, b.v) }; } \
+            template<> EIGEN_STRONG_INLINE bd::RealPacket<P> pmin   <bd::RealPacket<P>>(const bd::RealPacket<P> &a, const bd::RealPacket<P> &b) { return { pmin(a.v, b.v) }; } \
+            template<> EIGEN_STRONG_INLINE bd::RealPacket<P> pmax   <bd::RealPacket<P>>(const bd::RealPacket<P> &a, const bd::RealPacket<P> &b) { return { pmax(a.v, b.v) }; } \
+            template<> EIGEN_STRONG_INLINE bd::RealPacket<P> pmadd  <bd::RealPacket<P>>(const bd::RealPacket<P> &a, const bd::RealPacket<P> &b, const bd::RealPacket<P> &c) { return { pmadd(a.v, b.v, c.v) }; } \
+            template<> EIGEN_STRONG_INLINE bd::RealPacket<P> pnegate<bd::RealPacket<P>>(const bd::RealPacket<P> &a) { return { pnegate(a.v) }; } \
+            template<> EIGEN_STRONG_INLINE bd::RealPacket<P> pconj  <bd::RealPacket<P>>(const bd::RealPacket<P> &a) { return a; } \
+            template<> EIGEN_STRONG_INLINE bd::RealPacket<P> pabs   <bd::RealPacket<P>>(const bd::RealPacket<P> &a) { return { pabs(a.v) }; } \
+            template<> EIGEN_STRONG_INLINE bd::RealPacket<P> psqrt  <bd::RealPacket<P>>(const bd::RealPacket<P> &a) { return { psqrt(a.v) }; } \
+            template<> EIGEN_STRONG_INLINE bd::RealPacket<P> preverse<bd::RealPacket<P>>(const bd::RealPacket<P> &a) { return { preverse(a.v) }; } \
+            template<> EIGEN_STRONG_INLINE bd::RealPacket<P> pzero  <bd::RealPacket<P>>(const bd::RealPacket<P> &a) { return { pzero(a.v) }; } \
+            template<> EIGEN_STRONG_INLINE bd::Real<unpacket_traits<P>::type> pfirst    <bd::RealPacket<P>>(const bd::RealPacket<P> &a) { return pfirst    (a.v); } \
+            template<> EIGEN_STRONG_INLINE bd::Real<unpacket_traits<P>::type> predux    <bd::RealPacket<P>>(const bd::RealPacket<P> &a) { return predux    (a.v); } \
+            template<> EIGEN_STRONG_INLINE bd::Real<unpacket_traits<P>::type> predux_mul<bd::RealPacket<P>>(const bd::RealPacket<P> &a) { return predux_mul(a.v); } \
+            template<> EIGEN_STRONG_INLINE bd::Real<unpacket_traits<P>::type> predux_min<bd::RealPacket<P>>(const bd::RealPacket<P> &a) { return predux_min(a.v); } \
+            template<> EIGEN_STRONG_INLINE bd::Real<unpacket_traits<P>::type> predux_max<bd::RealPacket<P>>(const bd::RealPacket<P> &a) { return predux_max(a.v); }
+
+        BD_EIGEN_REAL_PACKET(Packet4f)
+        BD_EIGEN_REAL_PACKET(Packet2d)
+        #ifdef EIGEN_VECTORIZE_AVX
+        BD_EIGEN_REAL_PACKET(Packet8f)
+        BD_EIGEN_REAL_PACKET(Packet4d)
+        #endif
+        #ifdef EIGEN_VECTORIZE_AVX512
+        BD_EIGEN_REAL_PACKET(Packet16f)
+        BD_EIGEN_REAL_PACKET(Packet8d)
+        #endif
+        #undef BD_EIGEN_REAL_PACKET
+    }
+}
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+#endif
@@ -5,6 +5,7 @@
 #include <ostream>
 #include <istream>
 #include <string>
+#include "counters.hpp"
 
 namespace bd
 {
@@ -12,10 +13,10 @@ namespace bd
     template<class T> class Real;
 
     //Basic arithmetics
-    template<class T> constexpr inline Real<T> operator+ (const Real<T> &x, const Real<T> &y) { return x.value + y.value; };
-    template<class T> constexpr inline Real<T> operator- (const Real<T> &x, const Real<T> &y) { return x.value - y.value; };
-    template<class T> constexpr inline Real<T> operator* (const Real<T> &x, const Real<T> &y) { return x.value * y.value; };
-    template<class T> constexpr inline Real<T> operator/ (const Real<T> &x, const Real<T> &y) { return x.value / y.value; };
+    template<class T> constexpr inline Real<T> operator+ (const Real<T> &x, const Real<T> &y) { BD_COUNT(add, 1); return x.value + y.value; };
+    template<class T> constexpr inline Real<T> operator- (const Real<T> &x, const Real<T> &y) { BD_COUNT(sub, 1); return x.value - y.value; };
+    template<class T> constexpr inline Real<T> operator* (const Real<T> &x, const Real<T> &y) { BD_COUNT(mul, 1); return x.value * y.value; };
+    template<class T> constexpr inline Real<T> operator/ (const Real<T> &x, const Real<T> &y) { BD_COUNT(div, 1); return x.value / y.value; };
 
     ///Same as double, but with overloaded operators
     ///@tparam T Base type
@@ -38,17 +39,17 @@ namespace bd
         constexpr inline Real operator-- (int) noexcept { Real v = *this; --value; return v; };
 
         //Arithmetics
-        constexpr inline Real &operator+=(const Real &other) noexcept { value += other.value; return *this; };
-        constexpr inline Real &operator-=(const Real &other) noexcept { value -= other.value; return *this; };
-        constexpr inline Real &operator*=(const Real &other) noexcept { value *= other.value; return *this; };
-        constexpr inline Real &operator/=(const Real &other) noexcept { value /= other.value; return *this; };
+        constexpr inline Real &operator+=(const Real &other) noexcept { BD_COUNT(add, 1); value += other.value; return *this; };
+        constexpr inline Real &operator-=(const Real &other) noexcept { BD_COUNT(sub, 1); value -= other.value; return *this; };
+        constexpr inline Real &operator*=(const Real &other) noexcept { BD_COUNT(mul, 1); value *= other.value; return *this; };
+        constexpr inline Real &operator/=(const Real &other) noexcept { BD_COUNT(div, 1); value /= other.value; return *this; };
 
         //Transformations
         constexpr inline Real operator+() const noexcept { return  value; };
         constexpr inline Real operator-() const noexcept { return -value; };
 
         //Cast
-        constexpr inline explicit operator T() noexcept { return value; };
+        constexpr inline explicit operator T() const noexcept { return value; };
     };
     
     //Comparison
@@ -60,46 +61,46 @@ namespace bd
     template<class T> constexpr inline bool operator<=(const Real<T> &x, const Real<T> &y) noexcept { return x.value <= y.value; };
     
     //Trigonometric functions
-    template<class T> constexpr inline Real<T> cos  (const Real<T> &x) noexcept { return (Real<T>)std::cos  (x.value); };
-    template<class T> constexpr inline Real<T> sin  (const Real<T> &x) noexcept { return (Real<T>)std::sin  (x.value); };
-    template<class T> constexpr inline Real<T> tan  (const Real<T> &x) noexcept { return (Real<T>)std::tan  (x.value); };
-    template<class T> constexpr inline Real<T> acos (const Real<T> &x) noexcept { return (Real<T>)std::acos (x.value); };
-    template<class T> constexpr inline Real<T> asin (const Real<T> &x) noexcept { return (Real<T>)std::asin (x.value); };
-    template<class T> constexpr inline Real<T> atan (const Real<T> &x) noexcept { return (Real<T>)std::atan (x.value); };
-    template<class T> constexpr inline Real<T> atan2(const Real<T> &y, const Real<T> &x) noexcept { return (Real<T>)std::atan2(y.value, x.value); };
+    template<class T> constexpr inline Real<T> cos  (const Real<T> &x) noexcept { BD_COUNT(cos, 1); return (Real<T>)std::cos  (x.value); };
+    template<class T> constexpr inline Real<T> sin  (const Real<T> &x) noexcept { BD_COUNT(sin, 1); return (Real<T>)std::sin  (x.value); };
+    template<class T> constexpr inline Real<T> tan  (const Real<T> &x) noexcept { BD_COUNT(tan, 1); return (Real<T>)std::tan  (x.value); };
+    template<class T> constexpr inline Real<T> acos (const Real<T> &x) noexcept { BD_COUNT(acos, 1); return (Real<T>)std::acos (x.value); };
+    template<class T> constexpr inline Real<T> asin (const Real<T> &x) noexcept { BD_COUNT(asin, 1); return (Real<T>)std::asin (x.value); };
+    template<class T> constexpr inline Real<T> atan (const Real<T> &x) noexcept { BD_COUNT(atan, 1); return (Real<T>)std::atan (x.value); };
+    template<class T> constexpr inline Real<T> atan2(const Real<T> &y, const Real<T> &x) noexcept { BD_COUNT(atan2, 1); return (Real<T>)std::atan2(y.value, x.value); };
 
     //Hyperbolic functions
-    template<class T> constexpr inline Real<T> cosh (const Real<T> &x) noexcept { return (Real<T>)std::cosh (x.value); };
-    template<class T> constexpr inline Real<T> sinh (const Real<T> &x) noexcept { return (Real<T>)std::sinh (x.value); };
-    template<class T> constexpr inline Real<T> tanh (const Real<T> &x) noexcept { return (Real<T>)std::tanh (x.value); };
-    template<class T> constexpr inline Real<T> acosh(const Real<T> &x) noexcept { return (Real<T>)std::acosh(x.value); };
-    template<class T> constexpr inline Real<T> asinh(const Real<T> &x) noexcept { return (Real<T>)std::asinh(x.value); };
-    template<class T> constexpr inline Real<T> atanh(const Real<T> &x) noexcept { return (Real<T>)std::atanh(x.value); };
+    template<class T> constexpr inline Real<T> cosh (const Real<T> &x) noexcept { BD_COUNT(cosh, 1); return (Real<T>)std::cosh (x.value); };
+    template<class T> constexpr inline Real<T> sinh (const Real<T> &x) noexcept { BD_COUNT(sinh, 1); return (Real<T>)std::sinh (x.value); };
+    template<class T> constexpr inline Real<T> tanh (const Real<T> &x) noexcept { BD_COUNT(tanh, 1); return (Real<T>)std::tanh (x.value); };
+    template<class T> constexpr inline Real<T> acosh(const Real<T> &x) noexcept { BD_COUNT(acosh, 1); return (Real<T>)std::acosh(x.value); };
+    template<class T> constexpr inline Real<T> asinh(const Real<T> &x) noexcept { BD_COUNT(asinh, 1); return (Real<T>)std::asinh(x.value); };
+    template<class T> constexpr inline Real<T> atanh(const Real<T> &x) noexcept { BD_COUNT(atanh, 1); return (Real<T>)std::atanh(x.value); };
     
     //Exponential and logarithmic functions
-    template<class T> constexpr inline Real<T> exp    (const Real<T> &x) noexcept { return (Real<T>)std::exp  (x.value); };
-    template<class T> constexpr inline Real<T> log    (const Real<T> &x) noexcept { return (Real<T>)std::log  (x.value); };
-    template<class T> constexpr inline Real<T> log10  (const Real<T> &x) noexcept { return (Real<T>)std::log10(x.value); };
-    template<class T> constexpr inline Real<T> exp2   (const Real<T> &x) noexcept { return (Real<T>)std::exp2 (x.value); };
-    template<class T> constexpr inline Real<T> expm1  (const Real<T> &x) noexcept { return (Real<T>)std::expm1(x.value); };
+    template<class T> constexpr inline Real<T> exp    (const Real<T> &x) noexcept { BD_COUNT(exp, 1); return (Real<T>)std::exp  (x.value); };
+    template<class T> constexpr inline Real<T> log    (const Real<T> &x) noexcept { BD_COUNT(log, 1); return (Real<T>)std::log  (x.value); };
+    template<class T> constexpr inline Real<T> log10  (const Real<T> &x) noexcept { BD_COUNT(log10, 1); return (Real<T>)std::log10(x.value); };
+    template<class T> constexpr inline Real<T> exp2   (const Real<T> &x) noexcept { BD_COUNT(exp2, 1); return (Real<T>)std::exp2 (x.value); };
+    template<class T> constexpr inline Real<T> expm1  (const Real<T> &x) noexcept { BD_COUNT(expm1, 1); return (Real<T>)std::expm1(x.value); };
     template<class T> constexpr inline Real<T> ilogb  (const Real<T> &x) noexcept { return (Real<T>)std::ilogb(x.value); };
-    template<class T> constexpr inline Real<T> log1p  (const Real<T> &x) noexcept { return (Real<T>)std::log1p(x.value); };
-    template<class T> constexpr inline Real<T> log2   (const Real<T> &x) noexcept { return (Real<T>)std::log2 (x.value); };
+    template<class T> constexpr inline Real<T> log1p  (const Real<T> &x) noexcept { BD_COUNT(log1p, 1); return (Real<T>)std::log1p(x.value); };
+    template<class T> constexpr inline Real<T> log2   (const Real<T> &x) noexcept { BD_COUNT(log2, 1); return (Real<T>)std::log2 (x.value); };
     template<class T> constexpr inline Real<T> logb   (const Real<T> &x) noexcept { return (Real<T>)std::logb (x.value); };
     template<class T> constexpr inline Real<T> scalbn (const Real<T> &x, int n)      noexcept { return (Real<T>)std::scalbn (x, n); };
     template<class T> constexpr inline Real<T> scalbln(const Real<T> &x, long int n) noexcept { return (Real<T>)std::scalbln(x, n); };
     
     //Power functions
-    template<class T> constexpr inline Real<T> pow  (const Real<T> &base, const Real<T> &exponent) noexcept { return (Real<T>)std::pow  (base.value, exponent.value); };
-    template<class T> constexpr inline Real<T> sqrt (const Real<T> &x)                             noexcept { return (Real<T>)std::sqrt (x.value); };
-    template<class T> constexpr inline Real<T> cbrt (const Real<T> &x)                             noexcept { return (Real<T>)std::cbrt (x.value); };
-    template<class T> constexpr inline Real<T> hypot(const Real<T> &x,    const Real<T> &y)        noexcept { return (Real<T>)std::hypot(x.value, y.value); };
+    template<class T> constexpr inline Real<T> pow  (const Real<T> &base, const Real<T> &exponent) noexcept { BD_COUNT(pow, 1); return (Real<T>)std::pow  (base.value, exponent.value); };
+    template<class T> constexpr inline Real<T> sqrt (const Real<T> &x)                             noexcept { BD_COUNT(sqrt, 1); return (Real<T>)std::sqrt (x.value); };
+    template<class T> constexpr inline Real<T> cbrt (const Real<T> &x)                             noexcept { BD_COUNT(cbrt, 1); return (Real<T>)std::cbrt (x.value); };
+    template<class T> constexpr inline Real<T> hypot(const Real<T> &x,    const Real<T> &y)        noexcept { BD_COUNT(hypot, 1); return (Real<T>)std::hypot(x.value, y.value); };
 
     //Error and gamma functions
-    template<class T> constexpr inline Real<T> erf   (const Real<T> &x) noexcept { return (Real<T>)std::erf   (x.value); };
-    template<class T> constexpr inline Real<T> erfc  (const Real<T> &x) noexcept { return (Real<T>)std::erfc  (x.value); };
-    template<class T> constexpr inline Real<T> tgamma(const Real<T> &x) noexcept { return (Real<T>)std::tgamma(x.value); };
-    template<class T> constexpr inline Real<T> lgamma(const Real<T> &x) noexcept { return (Real<T>)std::lgamma(x.value); };
+    template<class T> constexpr inline Real<T> erf   (const Real<T> &x) noexcept { BD_COUNT(erf, 1); return (Real<T>)std::erf   (x.value); };
+    template<class T> constexpr inline Real<T> erfc  (const Real<T> &x) noexcept { BD_COUNT(erfc, 1); return (Real<T>)std::erfc  (x.value); };
+    template<class T> constexpr inline Real<T> tgamma(const Real<T> &x) noexcept { BD_COUNT(tgamma, 1); return (Real<T>)std::tgamma(x.value); };
+    template<class T> constexpr inline Real<T> lgamma(const Real<T> &x) noexcept { BD_COUNT(lgamma, 1); return (Real<T>)std::lgamma(x.value); };
 
     //Rounding and remainder functions
     template<class T> constexpr inline Real<T>       ceil     (const Real<T> &x) noexcept { return (Real<T>)std::ceil     (x.value); };
@@ -123,14 +124,14 @@ namespace bd
     template<class T> constexpr inline Real<T> nexttoward(const Real<T> &x, const Real<T> &y) noexcept { return (Real<T>)std::nexttoward(x.value, y.value); };
     
     //Minimum, maximum, difference functions
-    template<class T> constexpr inline Real<T> fdim(const Real<T> &x, const Real<T> &y) noexcept { (Real<T>)std::fdim(x.value, y.value); };
-    template<class T> constexpr inline Real<T> fmax(const Real<T> &x, const Real<T> &y) noexcept { (Real<T>)std::fmax(x.value, y.value); };
-    template<class T> constexpr inline Real<T> fmin(const Real<T> &x, const Real<T> &y) noexcept { (Real<T>)std::fmin(x.value, y.value); };
+    template<class T> constexpr inline Real<T> fdim(const Real<T> &x, const Real<T> &y) noexcept { return (Real<T>)std::fdim(x.value, y.value); };
+    template<class T> constexpr inline Real<T> fmax(const Real<T> &x, const Real<T> &y) noexcept { return (Real<T>)std::fmax(x.value, y.value); };
+    template<class T> constexpr inline Real<T> fmin(const Real<T> &x, const Real<T> &y) noexcept { return (Real<T>)std::fmin(x.value, y.value); };
     
     //Other functions
     template<class T> constexpr inline Real<T> fabs(const Real<T> &x) noexcept { return (Real<T>)std::fabs(x.value); };
     template<class T> constexpr inline Real<T> abs (const Real<T> &x) noexcept { return (Real<T>)std::abs (x.value); };
-    template<class T> constexpr inline Real<T> fma (const Real<T> &x, const Real<T> &y, const Real<T> &z) noexcept { return (Real<T>)std::fma(x.value, y.value, z.value); };
+    template<class T> constexpr inline Real<T> fma (const Real<T> &x, const Real<T> &y, const Real<T> &z) noexcept { BD_COUNT(fma, 1); return (Real<T>)std::fma(x.value, y.value, z.value); };
 
     //Classification macro / functions
     template<class T> constexpr inline int  fpclassify(const Real<T> &x) noexcept { return std::fpclassify(x.value); }
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+
+namespace bd
+{
+    ///Value and derivative of elementary functions, shared by all differentiable types.
+    ///Unary rules return `f(x)` and set `d = f'(x)`, binary rules return `f(a, b)` and set partial derivatives `da`, `db`.
+    ///Every rule evaluates the function once and derives the derivative from intermediate results where possible.
+    namespace rules
+    {
+        //Sine and cosine in one call
+        #ifdef __GNUC__
+        inline void _sincos(float x, float &s, float &c)             noexcept { __builtin_sincosf(x, &s, &c); };
+        inline void _sincos(double x, double &s, double &c)          noexcept { __builtin_sincos (x, &s, &c); };
+        inline void _sincos(long double x, long double &s, long double &c) noexcept { __builtin_sincosl(x, &s, &c); };
+        #endif
+        template<class T> inline void _sincos(T x, T &s, T &c) noexcept { s = std::sin(x); c = std::cos(x); };
+
+        //Trigonometric functions
+        template<class T> inline T cos  (T x, T &d) noexcept { T s, c; _sincos(x, s, c); d = -s; return c; };
+        template<class T> inline T sin  (T x, T &d) noexcept { T s, c; _sincos(x, s, c); d =  c; return s; };
+        template<class T> inline T tan  (T x, T &d) noexcept { const T t = std::tan(x); d = 1 + t * t; return t; };
+        template<class T> inline T acos (T x, T &d) noexcept { d = -1 / std::sqrt(1 - x * x); return std::acos(x); };
+        template<class T> inline T asin (T x, T &d) noexcept { d =  1 / std::sqrt(1 - x * x); return std::asin(x); };
+        template<class T> inline T atan (T x, T &d) noexcept { d =  1 / (1 + x * x); return std::atan(x); };
+
+        //Hyperbolic functions
+        template<class T> inline T cosh (T x, T &d) noexcept { d = std::sinh(x); return std::cosh(x); };
+        template<class T> inline T sinh (T x, T &d) noexcept
+        {
+            //cosh = sqrt(1 + sinh^2), the square root is cheaper than a second exponential
+            const T s = std::sinh(x);
+            d = (std::fabs(s) < 1 / std::sqrt(std::numeric_limits<T>::epsilon())) ? std::sqrt(1 + s * s) : std::fabs(s);
+            return s;
+        };
+        template<class T> inline T tanh (T x, T &d) noexcept { const T t = std::tanh(x); d = 1 - t * t; return t; };
+        template<class T> inline T acosh(T x, T &d) noexcept { d = 1 / std::sqrt(x * x - 1); return std::acosh(x); };
+        template<class T> inline T asinh(T x, T &d) noexcept { d = 1 / std::sqrt(x * x + 1); return std::asinh(x); };
+        template<class T> inline T atanh(T x, T &d) noexcept { d = 1 / (1 - x * x); return std::atanh(x); };
+
+        //Exponential and logarithmic functions
+        template<class T> inline T exp  (T x, T &d) noexcept { const T e = std::exp  (x); d = e; return e; };
+        template<class T> inline T log  (T x, T &d) noexcept { d = 1 / x; return std::log(x); };
+        template<class T> inline T log10(T x, T &d) noexcept { d = (T)M_LOG10E / x; return std::log10(x); };
+        template<class T> inline T exp2 (T x, T &d) noexcept { const T e = std::exp2 (x); d = (T)M_LN2 * e; return e; };
+        template<class T> inline T expm1(T x, T &d) noexcept { const T e = std::expm1(x); d = e + 1; return e; };
+        template<class T> inline T log1p(T x, T &d) noexcept { d = 1 / (x + 1); return std::log1p(x); };
+        template<class T> inline T log2 (T x, T &d) noexcept { d = (T)M_LOG2E / x; return std::log2(x); };
+
+        //Power functions
+        template<class T> inline T pow  (T a, T b, T &da, T &db) noexcept
+        {
+            //b * a^(b - 1) from a^b, without second pow
+            const T p = std::pow(a, b);
+            da = (a != 0) ? (b * p / a) : (b * std::pow(a, b - 1));
+            db = (p == 0) ? (T)0 : std::log(a) * p;
+            return p;
+        };
+        template<class T> inline T sqrt (T x, T &d) noexcept { const T r = std::sqrt(x); d = 1 / (2 * r); return r; };
+        template<class T> inline T cbrt (T x, T &d) noexcept { const T r = std::cbrt(x); d = 1 / (3 * r * r); return r; };
+        template<class T> inline T hypot(T a, T b, T &da, T &db) noexcept { const T h = std::hypot(a, b); da = a / h; db = b / h; return h; };
+
+        //Error and gamma functions
+        template<class T> inline T erf   (T x, T &d) noexcept { d =  (T)M_2_SQRTPI * std::exp(-x * x); return std::erf (x); };
+        template<class T> inline T erfc  (T x, T &d) noexcept { d = -(T)M_2_SQRTPI * std::exp(-x * x); return std::erfc(x); };
+        template<class T> inline T tgamma(T x, T &d) noexcept { d = std::numeric_limits<T>::quiet_NaN(); return std::tgamma(x); };
+        template<class T> inline T lgamma(T x, T &d) noexcept { d = std::numeric_limits<T>::quiet_NaN(); return std::lgamma(x); };
+
+        //Other functions
+        template<class T> inline T fabs(T x, T &d) noexcept { d = (x == 0) ? (std::numeric_limits<T>::quiet_NaN()) : ((x > 0) ? (T)1 : (T)-1); return std::fabs(x); };
+        template<class T> inline T abs (T x, T &d) noexcept { return fabs(x, d); };
+
+        ///Second-order rules return `f(x)` and set `d = f'(x)`, `dd = f''(x)`, binary rules set `da`, `db` and `daa`, `dab`, `dbb`.
+        ///Second derivatives are expressed through the first, so they cost a few multiplications on top of the first-order rule.
+
+        //Trigonometric functions, second order
+        template<class T> inline T cos  (T x, T &d, T &dd) noexcept { const T c = cos(x, d); dd = -c; return c; };
+        template<class T> inline T sin  (T x, T &d, T &dd) noexcept { const T s = sin(x, d); dd = -s; return s; };
+        template<class T> inline T tan  (T x, T &d, T &dd) noexcept { const T t = tan(x, d); dd = 2 * t * d; return t; };
+        template<class T> inline T acos (T x, T &d, T &dd) noexcept { const T r = acos(x, d); dd = d * x / (1 - x * x); return r; };
+        template<class T> inline T asin (T x, T &d, T &dd) noexcept { const T r = asin(x, d); dd = d * x / (1 - x * x); return r; };
+        template<class T> inline T atan (T x, T &d, T &dd) noexcept { const T r = atan(x, d); dd = -2 * x * d * d; return r; };
+
+        //Hyperbolic functions, second order
+        template<class T> inline T cosh (T x, T &d, T &dd) noexcept { const T c = cosh(x, d); dd = c; return c; };
+        template<class T> inline T sinh (T x, T &d, T &dd) noexcept { const T s = sinh(x, d); dd = s; return s; };
+        template<class T> inline T tanh (T x, T &d, T &dd) noexcept { const T t = tanh(x, d); dd = -2 * t * d; return t; };
+        template<class T> inline T acosh(T x, T &d, T &dd) noexcept { const T r = acosh(x, d); dd = -d * x / (x * x - 1); return r; };
+        template<class T> inline T asinh(T x, T &d, T &dd) noexcept { const T r = asinh(x, d); dd = -d * x / (x * x + 1); return r; };
+        template<class T> inline T atanh(T x, T &d, T &dd) noexcept { const T r = atanh(x, d); dd = 2 * x * d * d; return r; };
+
+        //Exponential and logarithmic functions, second order
+        template<class T> inline T exp  (T x, T &d, T &dd) noexcept { const T e = exp(x, d); dd = e; return e; };
+        template<class T> inline T log  (T x, T &d, T &dd) noexcept { const T r = log(x, d); dd = -d * d; return r; };
+        template<class T> inline T log10(T x, T &d, T &dd) noexcept { const T r = log10(x, d); dd = -d / x; return r; };
+        template<class T> inline T exp2 (T x, T &d, T &dd) noexcept { const T e = exp2(x, d); dd = (T)M_LN2 * d; return e; };
+        template<class T> inline T expm1(T x, T &d, T &dd) noexcept { const T e = expm1(x, d); dd = d; return e; };
+        template<class T> inline T log1p(T x, T &d, T &dd) noexcept { const T r = log1p(x, d); dd = -d * d; return r; };
+        template<class T> inline T log2 (T x, T &d, T &dd) noexcept { const T r = log2(x, d); dd = -d / x; return r; };
+
+        //Power functions, second order
+        template<class T> inline T pow  (T a, T b, T &da, T &db, T &daa, T &dab, T &dbb) noexcept
+        {
+            //Partial derivatives of b * a^(b - 1) and log(a) * a^b, reusing the first-order results
+            const T p = pow(a, b, da, db);
+            daa = (a != 0) ? ((b - 1) * da / a) : (b * (b - 1) * std::pow(a, b - 2));
+            dab = (p == 0) ? (T)0 : (p / a + b * db / a);
+            dbb = (p == 0) ? (T)0 : std::log(a) * db;
+            return p;
+        };
+        template<class T> inline T sqrt (T x, T &d, T &dd) noexcept { const T r = sqrt(x, d); dd = -d * d / r; return r; };
+        template<class T> inline T cbrt (T x, T &d, T &dd) noexcept { const T r = cbrt(x, d); dd = -2 * d / (3 * x); return r; };
+        template<class T> inline T hypot(T a, T b, T &da, T &db, T &daa, T &dab, T &dbb) noexcept
+        {
+            const T h = hypot(a, b, da, db);
+            daa = db * db / h; dab = -da * db / h; dbb = da * da / h;
+            return h;
+        };
+
+        //Error and gamma functions, second order
+        template<class T> inline T erf   (T x, T &d, T &dd) noexcept { const T r = erf (x, d); dd = -2 * x * d; return r; };
+        template<class T> inline T erfc  (T x, T &d, T &dd) noexcept { const T r = erfc(x, d); dd = -2 * x * d; return r; };
+        template<class T> inline T tgamma(T x, T &d, T &dd) noexcept { const T r = tgamma(x, d); dd = d; return r; };
+        template<class T> inline T lgamma(T x, T &d, T &dd) noexcept { const T r = lgamma(x, d); dd = d; return r; };
+
+        //Other functions, second order
+        template<class T> inline T fabs(T x, T &d, T &dd) noexcept { const T r = fabs(x, d); dd = 0 * d; return r; };
+        template<class T> inline T abs (T x, T &d, T &dd) noexcept { return fabs(x, d, dd); };
+    }
+}
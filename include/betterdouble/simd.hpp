@@ -0,0 +1,303 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <new>
+#include <utility>
+
+#if !defined(BD_NO_SIMD) && (defined(__AVX512F__) || defined(__AVX__) || defined(__SSE2__))
+    #include <immintrin.h>
+#endif
+
+namespace bd
+{
+    namespace simd
+    {
+        ///Vector register of W elements, only the widths supported by the target are `available`.
+        ///Width 1 is a scalar, define `BD_NO_SIMD` to use it for all types.
+        ///@tparam T Element type
+        ///@tparam W Number of elements
+        template<class T, unsigned int W>
+        struct Packet
+        {
+            static constexpr bool available = false;
+        };
+        template<class T>
+        struct Packet<T, 1>
+        {
+            typedef T Type;
+            static constexpr bool available = true;
+            static inline Type load (const T *a)                                      noexcept { return *a; };
+            static inline void store(T *v, const Type &a)                             noexcept { *v = a; };
+            static inline Type set  (const T &a)                                      noexcept { return a; };
+            static inline Type add  (const Type &a, const Type &b)                    noexcept { return a + b; };
+            static inline Type sub  (const Type &a, const Type &b)                    noexcept { return a - b; };
+            static inline Type mul  (const Type &a, const Type &b)                    noexcept { return a * b; };
+            static inline Type fmadd(const Type &a, const Type &b, const Type &c)     noexcept { return a * b + c; };
+        };
+
+        #if !defined(BD_NO_SIMD) && defined(__AVX512F__)
+        template<> struct Packet<float, 16>
+        {
+            typedef __m512 Type;
+            static constexpr bool available = true;
+            static inline Type load (const float *a)                             noexcept { return _mm512_loadu_ps(a); };
+            static inline void store(float *v, const Type &a)                    noexcept { _mm512_storeu_ps(v, a); };
+            static inline Type set  (const float &a)                             noexcept { return _mm512_set1_ps(a); };
+            static inline Type add  (const Type &a, const Type &b)                    noexcept { return _mm512_add_ps(a, b); };
+            static inline Type sub  (const Type &a, const Type &b)                    noexcept { return _mm512_sub_ps(a, b); };
+            static inline Type mul  (const Type &a, const Type &b)                    noexcept { return _mm512_mul_ps(a, b); };
+            static inline Type fmadd(const Type &a, const Type &b, const Type &c)     noexcept { return _mm512_fmadd_ps(a, b, c); };
+        };
+        template<> struct Packet<double, 8>
+        {
+            typedef __m512d Type;
+            static constexpr bool available = true;
+            static inline Type load (const double *a)                            noexcept { return _mm512_loadu_pd(a); };
+            static inline void store(double *v, const Type &a)                   noexcept { _mm512_storeu_pd(v, a); };
+            static inline Type set  (const double &a)                            noexcept { return _mm512_set1_pd(a); };
+            static inline Type add  (const Type &a, const Type &b)                    noexcept { return _mm512_add_pd(a, b); };
+            static inline Type sub  (const Type &a, const Type &b)                    noexcept { return _mm512_sub_pd(a, b); };
+            static inline Type mul  (const Type &a, const Type &b)                    noexcept { return _mm512_mul_pd(a, b); };
+            static inline Type fmadd(const Type &a, const Type &b, const Type &c)     noexcept { return _mm512_fmadd_pd(a, b, c); };
+        };
+        #endif
+        #if !defined(BD_NO_SIMD) && defined(__AVX__)
+        template<> struct Packet<float, 8>
+        {
+            typedef __m256 Type;
+            static constexpr bool available = true;
+            static inline Type load (const float *a)                             noexcept { return _mm256_loadu_ps(a); };
+            static inline void store(float *v, const Type &a)                    noexcept { _mm256_storeu_ps(v, a); };
+            static inline Type set  (const float &a)                             noexcept { return _mm256_set1_ps(a); };
+            static inline Type add  (const Type &a, const Type &b)                    noexcept { return _mm256_add_ps(a, b); };
+            static inline Type sub  (const Type &a, const Type &b)                    noexcept { return _mm256_sub_ps(a, b); };
+            static inline Type mul  (const Type &a, const Type &b)                    noexcept { return _mm256_mul_ps(a, b); };
+            #ifdef __FMA__
+            static inline Type fmadd(const Type &a, const Type &b, const Type &c)     noexcept { return _mm256_fmadd_ps(a, b, c); };
+            #else
+            static inline Type fmadd(const Type &a, const Type &b, const Type &c)     noexcept { return _mm256_add_ps(_mm256_mul_ps(a, b), c); };
+            #endif
+        };
+        template<> struct Packet<double, 4>
+        {
+            typedef __m256d Type;
+            static constexpr bool available = true;
+            static inline Type load (const double *a)                            noexcept { return _mm256_loadu_pd(a); };
+            static inline void store(double *v, const Type &a)                   noexcept { _mm256_storeu_pd(v, a); };
+            static inline Type set  (const double &a)                            noexcept { return _mm256_set1_pd(a); };
+            static inline Type add  (const Type &a, const Type &b)                    noexcept { return _mm256_add_pd(a, b); };
+            static inline Type sub  (const Type &a, const Type &b)                    noexcept { return _mm256_sub_pd(a, b); };
+            static inline Type mul  (const Type &a, const Type &b)                    noexcept { return _mm256_mul_pd(a, b); };
+            #ifdef __FMA__
+            static inline Type fmadd(const Type &a, const Type &b, const Type &c)     noexcept { return _mm256_fmadd_pd(a, b, c); };
+            #else
+            static inline Type fmadd(const Type &a, const Type &b, const Type &c)     noexcept { return _mm256_add_pd(_mm256_mul_pd(a, b), c); };
+            #endif
+        };
+        #endif
+        #if !defined(BD_NO_SIMD) && defined(__SSE2__)
+        template<> struct Packet<float, 4>
+        {
+            typedef __m128 Type;
+            static constexpr bool available = true;
+            static inline Type load (const float *a)                             noexcept { return _mm_loadu_ps(a); };
+            static inline void store(float *v, const Type &a)                    noexcept { _mm_storeu_ps(v, a); };
+            static inline Type set  (const float &a)                             noexcept { return _mm_set1_ps(a); };
+            static inline Type add  (const Type &a, const Type &b)                    noexcept { return _mm_add_ps(a, b); };
+            static inline Type sub  (const Type &a, const Type &b)                    noexcept { return _mm_sub_ps(a, b); };
+            static inline Type mul  (const Type &a, const Type &b)                    noexcept { return _mm_mul_ps(a, b); };
+            static inline Type fmadd(const Type &a, const Type &b, const Type &c)     noexcept { return _mm_add_ps(_mm_mul_ps(a, b), c); };
+        };
+        template<> struct Packet<double, 2>
+        {
+            typedef __m128d Type;
+            static constexpr bool available = true;
+            static inline Type load (const double *a)                            noexcept { return _mm_loadu_pd(a); };
+            static inline void store(double *v, const Type &a)                   noexcept { _mm_storeu_pd(v, a); };
+            static inline Type set  (const double &a)                            noexcept { return _mm_set1_pd(a); };
+            static inline Type add  (const Type &a, const Type &b)                    noexcept { return _mm_add_pd(a, b); };
+            static inline Type sub  (const Type &a, const Type &b)                    noexcept { return _mm_sub_pd(a, b); };
+            static inline Type mul  (const Type &a, const Type &b)                    noexcept { return _mm_mul_pd(a, b); };
+            static inline Type fmadd(const Type &a, const Type &b, const Type &c)     noexcept { return _mm_add_pd(_mm_mul_pd(a, b), c); };
+        };
+        #endif
+
+        ///Next available width below W
+        template<class T, unsigned int W>
+        struct Narrower
+        {
+            static constexpr unsigned int value = Packet<T, W / 2>::available ? W / 2 : Narrower<T, W / 2>::value;
+        };
+        template<class T> struct Narrower<T, 1> { static constexpr unsigned int value = 1; };
+        template<class T> struct Narrower<T, 2> { static constexpr unsigned int value = 1; };
+
+        ///Widest and narrowest available vector widths, 1 if there are none
+        template<class T>
+        struct Width
+        {
+            static constexpr unsigned int widest = Packet<T, 16>::available ? 16 : Packet<T, 8>::available ? 8 : Packet<T, 4>::available ? 4 : Packet<T, 2>::available ? 2 : 1;
+            static constexpr unsigned int narrowest = Packet<T, 2>::available ? 2 : Packet<T, 4>::available ? 4 : Packet<T, 8>::available ? 8 : Packet<T, 16>::available ? 16 : 1;
+        };
+
+        ///Applies `f(Packet<T, W>(), i)` with the widest packets first, then steps down to narrower ones for the remainder
+        template<class T, unsigned int W>
+        struct Loop
+        {
+            template<class F> static inline void run(std::size_t i, std::size_t n, const F &f) noexcept
+            {
+                for (const std::size_t e = n - (n - i) % W; i < e; i += W) f(Packet<T, W>(), i);
+                Loop<T, Narrower<T, W>::value>::run(i, n, f);
+            };
+        };
+        template<class T>
+        struct Loop<T, 1>
+        {
+            template<class F> static inline void run(std::size_t i, std::size_t n, const F &f) noexcept
+            {
+                for (; i < n; ++i) f(Packet<T, 1>(), i);
+            };
+        };
+
+        ///Largest alignment that `new` respects, over-aligned types in standard containers break before C++17
+        #ifdef __cpp_aligned_new
+        constexpr std::size_t max_alignment = 64;
+        #else
+        constexpr std::size_t max_alignment = alignof(std::max_align_t);
+        #endif
+
+        ///Largest power of two not greater than n
+        constexpr std::size_t floor2(std::size_t n) noexcept
+        {
+            std::size_t p = 1;
+            while (2 * p <= n) p *= 2;
+            return p;
+        };
+
+        ///Storage of N derivatives: padded to whole narrowest packets, so no scalar remainder is left, and aligned to the widest packet.
+        ///Sizes below the narrowest packet are left as they are.
+        ///@tparam T Element type
+        ///@tparam N Number of elements
+        template<class T, unsigned int N>
+        struct Layout
+        {
+            static constexpr unsigned int width = Width<T>::narrowest;
+            static constexpr unsigned int size = (N < width) ? N : ((N + width - 1) / width * width);
+            static constexpr std::size_t alignment = (N < width) ? alignof(T) : std::min(floor2(sizeof(T) * std::min(Width<T>::widest, size)), std::max(max_alignment, alignof(T)));
+        };
+
+        //Kernels, operate on P elements
+        template<unsigned int P, class T> inline void fill(T *v, const T &s) noexcept
+        {
+            Loop<T, Width<T>::widest>::run(0, P, [&](auto k, std::size_t i) { typedef decltype(k) K; K::store(v + i, K::set(s)); });
+        };
+        template<unsigned int P, class T> inline void copy(T *v, const T *a) noexcept
+        {
+            Loop<T, Width<T>::widest>::run(0, P, [&](auto k, std::size_t i) { typedef decltype(k) K; K::store(v + i, K::load(a + i)); });
+        };
+        template<unsigned int P, class T> inline void add(T *v, const T *a, const T *b) noexcept
+        {
+            Loop<T, Width<T>::widest>::run(0, P, [&](auto k, std::size_t i) { typedef decltype(k) K; K::store(v + i, K::add(K::load(a + i), K::load(b + i))); });
+        };
+        template<unsigned int P, class T> inline void sub(T *v, const T *a, const T *b) noexcept
+        {
+            Loop<T, Width<T>::widest>::run(0, P, [&](auto k, std::size_t i) { typedef decltype(k) K; K::store(v + i, K::sub(K::load(a + i), K::load(b + i))); });
+        };
+        ///`v = sa * a`
+        template<unsigned int P, class T> inline void scale(T *v, const T *a, const T &sa) noexcept
+        {
+            Loop<T, Width<T>::widest>::run(0, P, [&](auto k, std::size_t i) { typedef decltype(k) K; K::store(v + i, K::mul(K::set(sa), K::load(a + i))); });
+        };
+        ///`v = sa * a + sb * b`, product rule
+        template<unsigned int P, class T> inline void combine(T *v, const T *a, const T &sa, const T *b, const T &sb) noexcept
+        {
+            Loop<T, Width<T>::widest>::run(0, P, [&](auto k, std::size_t i) { typedef decltype(k) K; K::store(v + i, K::fmadd(K::set(sa), K::load(a + i), K::mul(K::set(sb), K::load(b + i)))); });
+        };
+
+        //Lane-wise kernels, operate on n elements known at runtime
+        template<class T> inline void fill(std::size_t n, T *v, const T &s) noexcept
+        {
+            Loop<T, Width<T>::widest>::run(0, n, [&](auto k, std::size_t i) { typedef decltype(k) K; K::store(v + i, K::set(s)); });
+        };
+        template<class T> inline void add(std::size_t n, T *v, const T *a, const T *b) noexcept
+        {
+            Loop<T, Width<T>::widest>::run(0, n, [&](auto k, std::size_t i) { typedef decltype(k) K; K::store(v + i, K::add(K::load(a + i), K::load(b + i))); });
+        };
+        template<class T> inline void sub(std::size_t n, T *v, const T *a, const T *b) noexcept
+        {
+            Loop<T, Width<T>::widest>::run(0, n, [&](auto k, std::size_t i) { typedef decltype(k) K; K::store(v + i, K::sub(K::load(a + i), K::load(b + i))); });
+        };
+        ///`v = a * b` lane-wise
+        template<class T> inline void mul(std::size_t n, T *v, const T *a, const T *b) noexcept
+        {
+            Loop<T, Width<T>::widest>::run(0, n, [&](auto k, std::size_t i) { typedef decltype(k) K; K::store(v + i, K::mul(K::load(a + i), K::load(b + i))); });
+        };
+        ///`v = sa * a` with scalar `sa`
+        template<class T> inline void scale(std::size_t n, T *v, const T *a, const T &sa) noexcept
+        {
+            Loop<T, Width<T>::widest>::run(0, n, [&](auto k, std::size_t i) { typedef decltype(k) K; K::store(v + i, K::mul(K::set(sa), K::load(a + i))); });
+        };
+        ///`v = sa * a + sb * b` lane-wise, product rule over a batch
+        template<class T> inline void combine(std::size_t n, T *v, const T *a, const T *sa, const T *b, const T *sb) noexcept
+        {
+            Loop<T, Width<T>::widest>::run(0, n, [&](auto k, std::size_t i) { typedef decltype(k) K; K::store(v + i, K::fmadd(K::load(sa + i), K::load(a + i), K::mul(K::load(sb + i), K::load(b + i)))); });
+        };
+
+        ///Heap array aligned to `alignment` bytes, storage of batches, or array owned by the caller after `wrap()`
+        ///@tparam T Element type, trivially copyable
+        template<class T>
+        class Buffer
+        {
+        private:
+            T *_data;
+            std::size_t _size;
+            bool _owner;
+
+            ///Over-allocates and keeps the original pointer just before the aligned block
+            static inline T *_allocate(std::size_t size)
+            {
+                if (size == 0) return nullptr;
+                char *raw = static_cast<char*>(::operator new(size * sizeof(T) + alignment + sizeof(void*)));
+                char *aligned = raw + sizeof(void*);
+                aligned += (alignment - reinterpret_cast<std::uintptr_t>(aligned) % alignment) % alignment;
+                reinterpret_cast<void**>(aligned)[-1] = raw;
+                return reinterpret_cast<T*>(aligned);
+            };
+            static inline void _release(T *data) noexcept { if (data != nullptr) ::operator delete(reinterpret_cast<void**>(data)[-1]); };
+
+        public:
+            static constexpr std::size_t alignment = 64;
+
+            //Constructors & assignment
+            inline Buffer()                           noexcept : _data(nullptr), _size(0), _owner(true) {};
+            inline explicit Buffer(std::size_t size)           : _data(_allocate(size)), _size(size), _owner(true) { std::fill(_data, _data + _size, (T)0); };
+            inline Buffer(const Buffer &other)                 : _data(_allocate(other._size)), _size(other._size), _owner(true) { std::copy(other._data, other._data + _size, _data); };
+            inline Buffer(Buffer &&other)             noexcept : _data(other._data), _size(other._size), _owner(other._owner) { other._data = nullptr; other._size = 0; other._owner = true; };
+            inline ~Buffer() { if (_owner) _release(_data); };
+            inline Buffer &operator=(const Buffer &other)
+            {
+                if (this == &other) return *this;
+                if (_size != other._size) { T *data = _allocate(other._size); if (_owner) _release(_data); _data = data; _size = other._size; _owner = true; }
+                std::copy(other._data, other._data + _size, _data);
+                return *this;
+            };
+            inline Buffer &operator=(Buffer &&other) noexcept { std::swap(_data, other._data); std::swap(_size, other._size); std::swap(_owner, other._owner); return *this; };
+            ///Buffer over `size` elements at `data`, which stay owned by the caller. Copies own their memory, copy assignments of same size write through.
+            static inline Buffer wrap(T *data, std::size_t size) noexcept { Buffer b; b._data = data; b._size = size; b._owner = false; return b; };
+
+            //Access
+            inline std::size_t size() const noexcept { return _size; };
+            inline T *data()                noexcept { return _data; };
+            inline const T *data()    const noexcept { return _data; };
+            inline T &operator[](std::size_t k)             noexcept { return _data[k]; };
+            inline const T &operator[](std::size_t k) const noexcept { return _data[k]; };
+        };
+
+        ///Number of elements `n` rounded up to whole aligned blocks, keeps consecutive planes of a batch aligned
+        template<class T> constexpr std::size_t stride(std::size_t n) noexcept
+        {
+            return (n + Buffer<T>::alignment / sizeof(T) - 1) / (Buffer<T>::alignment / sizeof(T)) * (Buffer<T>::alignment / sizeof(T));
+        };
+    }
+}
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+namespace bd
+{
+    //Predefine
+    template<class T, unsigned int K> class Taylor;
+
+    //Basic arithmetics
+    template<class T, unsigned int K> constexpr inline Taylor<T, K> operator+(const Taylor<T, K> &a, const Taylor<T, K> &b) { Taylor<T, K> v = a; v += b; return v; };
+    template<class T, unsigned int K> constexpr inline Taylor<T, K> operator-(const Taylor<T, K> &a, const Taylor<T, K> &b) { Taylor<T, K> v = a; v -= b; return v; };
+    template<class T, unsigned int K> constexpr inline Taylor<T, K> operator*(const Taylor<T, K> &a, const Taylor<T, K> &b)
+    {
+        //Cauchy product
+        Taylor<T, K> v;
+        for (unsigned int k = 0; k <= K; ++k)
+        {
+            T s = 0;
+            for (unsigned int j = 0; j <= k; ++j) s += a.coefficient[j] * b.coefficient[k - j];
+            v.coefficient[k] = s;
+        }
+        return v;
+    };
+    template<class T, unsigned int K> constexpr inline Taylor<T, K> operator/(const Taylor<T, K> &a, const Taylor<T, K> &b)
+    {
+        //a = v b solved for v one coefficient at a time
+        Taylor<T, K> v;
+        for (unsigned int k = 0; k <= K; ++k)
+        {
+            T s = a.coefficient[k];
+            for (unsigned int j = 1; j <= k; ++j) s -= b.coefficient[j] * v.coefficient[k - j];
+            v.coefficient[k] = s / b.coefficient[0];
+        }
+        return v;
+    };
+
+    ///Same as double, but with a truncated Taylor series in one variable: `coefficient[k]` is the k-th derivative divided by k!, `coefficient[0]` is the value.
+    ///Functions propagate the series with the usual recurrences, O(K^2) per operation, instead of nesting K levels of Differentiable.
+    ///For `x' = f(x)`, seed `x` with the known coefficients and evaluate `f(x)` K times, coefficient k of the result gives coefficient k + 1 of `x` divided by k + 1.
+    ///@tparam T Base type
+    ///@tparam K Highest order
+    template<class T, unsigned int K>
+    class Taylor
+    {
+    public:
+        //Constants
+        static constexpr unsigned int order = K;
+
+        //Variables
+        T coefficient[K + 1];
+
+        //Constructors & assignment
+        constexpr inline explicit Taylor()                   noexcept : coefficient() {};
+        constexpr inline Taylor(const T &other)              noexcept : coefficient() { coefficient[0] = other; };
+        constexpr inline Taylor(const Taylor<T, K> &other)   noexcept = default;
+        constexpr inline Taylor &operator=(const Taylor &other) noexcept = default;
+        ///Independent variable `x + t`
+        static constexpr inline Taylor variable(const T &x) noexcept { Taylor v = x; if (K > 0) v.coefficient[1 % (K + 1)] = 1; return v; };
+
+        //Kernels
+        ///Sets coefficients to `s * x`
+        constexpr inline Taylor &scale(const Taylor &x, T s) noexcept { for (unsigned int k = 0; k <= K; ++k) coefficient[k] = s * x.coefficient[k]; return *this; };
+        ///Sets coefficients of `f` from its value and `f' = h x'`, `f_k = 1/k sum j x_j h_(k-j)`.
+        ///`h` may be `*this`, it is read only below the coefficient being written. `x` may not.
+        constexpr inline Taylor &integrate(T value, const Taylor &x, const Taylor &h) noexcept
+        {
+            coefficient[0] = value;
+            for (unsigned int k = 1; k <= K; ++k)
+            {
+                T s = 0;
+                for (unsigned int j = 1; j <= k; ++j) s += (T)j * x.coefficient[j] * h.coefficient[k - j];
+                coefficient[k] = s / (T)k;
+            }
+            return *this;
+        };
+
+        //Increments/decrements
+        constexpr inline Taylor &operator++()    noexcept { ++coefficient[0]; return *this; };
+        constexpr inline Taylor &operator--()    noexcept { --coefficient[0]; return *this; };
+        constexpr inline Taylor operator++ (int) noexcept { Taylor v = *this; ++coefficient[0]; return v; };
+        constexpr inline Taylor operator-- (int) noexcept { Taylor v = *this; --coefficient[0]; return v; };
+
+        //Arithmetics
+        constexpr inline Taylor &operator+=(const Taylor &other) noexcept { for (unsigned int k = 0; k <= K; ++k) coefficient[k] += other.coefficient[k]; return *this; };
+        constexpr inline Taylor &operator-=(const Taylor &other) noexcept { for (unsigned int k = 0; k <= K; ++k) coefficient[k] -= other.coefficient[k]; return *this; };
+        constexpr inline Taylor &operator*=(const Taylor &other) noexcept { return *this = *this * other; };
+        constexpr inline Taylor &operator/=(const Taylor &other) noexcept { return *this = *this / other; };
+
+        //Transformations
+        constexpr inline Taylor operator+() const noexcept { return *this; };
+        constexpr inline Taylor operator-() const noexcept { Taylor v; return v.scale(*this, -1); };
+
+        //Cast
+        constexpr inline explicit operator T() const noexcept { return coefficient[0]; };
+    };
+
+    //Series helpers
+    ///Sine and cosine, or hyperbolic sine and cosine for `sign = 1`, computed together because each is the derivative of the other
+    template<class T, unsigned int K> inline void _sincos(const Taylor<T, K> &x, Taylor<T, K> &s, Taylor<T, K> &c, T s0, T c0, T sign) noexcept
+    {
+        s.coefficient[0] = s0; c.coefficient[0] = c0;
+        for (unsigned int k = 1; k <= K; ++k)
+        {
+            T ss = 0, cc = 0;
+            for (unsigned int j = 1; j <= k; ++j) { ss += (T)j * x.coefficient[j] * c.coefficient[k - j]; cc += (T)j * x.coefficient[j] * s.coefficient[k - j]; }
+            s.coefficient[k] = ss / (T)k; c.coefficient[k] = sign * cc / (T)k;
+        }
+    };
+    ///Tangent or hyperbolic tangent for `sign = -1`, `t' = (1 + sign t^2) x'` with `u = 1 + sign t^2` built alongside
+    template<class T, unsigned int K> inline Taylor<T, K> _tan(const Taylor<T, K> &x, T t0, T sign) noexcept
+    {
+        Taylor<T, K> t, u;
+        t.coefficient[0] = t0;
+        for (unsigned int k = 1; k <= K; ++k)
+        {
+            T uu = 0;
+            for (unsigned int j = 0; j <= k - 1; ++j) uu += t.coefficient[j] * t.coefficient[k - 1 - j];
+            u.coefficient[k - 1] = ((k == 1) ? (T)1 : (T)0) + sign * uu;
+            T tt = 0;
+            for (unsigned int j = 1; j <= k; ++j) tt += (T)j * x.coefficient[j] * u.coefficient[k - j];
+            t.coefficient[k] = tt / (T)k;
+        }
+        return t;
+    };
+    ///Logarithm with value `l0`, `x = e^l` solved for `l` one coefficient at a time
+    template<class T, unsigned int K> inline Taylor<T, K> _log(const Taylor<T, K> &x, T l0) noexcept
+    {
+        Taylor<T, K> l;
+        l.coefficient[0] = l0;
+        for (unsigned int k = 1; k <= K; ++k)
+        {
+            T s = 0;
+            for (unsigned int j = 1; j < k; ++j) s += (T)j * l.coefficient[j] * x.coefficient[k - j];
+            l.coefficient[k] = (x.coefficient[k] - s / (T)k) / x.coefficient[0];
+        }
+        return l;
+    };
+    ///Constant series with value `v`, higher coefficients set to `d`
+    template<class T, unsigned int K> inline Taylor<T, K> _constant(T v, T d) noexcept { Taylor<T, K> c; for (unsigned int k = 0; k <= K; ++k) c.coefficient[k] = d; c.coefficient[0] = v; return c; };
+    ///Power with constant exponent `r` and value `p0`, from `x p' = r p x'`.
+    ///The recurrence divides by `x_0`, so at `x_0 = 0` nonnegative integer exponents use repeated Cauchy products, and others factor `x = t^m y` with `y_0 != 0`.
+    template<class T, unsigned int K> inline Taylor<T, K> _pow(const Taylor<T, K> &x, T r, T p0) noexcept
+    {
+        Taylor<T, K> p;
+        if (x.coefficient[0] == 0)
+        {
+            if (r >= 0 && r == std::floor(r) && r <= (T)std::numeric_limits<unsigned int>::max())
+            {
+                Taylor<T, K> power = x;
+                p = (Taylor<T, K>)1;
+                for (unsigned int n = (unsigned int)r; n > 0; n >>= 1) { if (n & 1) p *= power; if (n > 1) power *= power; }
+                return p;
+            }
+            unsigned int m = 1;
+            while (m <= K && x.coefficient[m] == 0) ++m;
+            if (m > K) return _constant<T, K>(p0, (r > 0) ? (T)0 : std::numeric_limits<T>::quiet_NaN());
+            //`x^r = t^(m r) y^r` is a series only for nonnegative integer `m r`, and `y` is known up to coefficient `K - m`
+            const T shift = (T)m * r;
+            if (shift < 0 || shift != std::floor(shift)) return _constant<T, K>(p0, std::numeric_limits<T>::quiet_NaN());
+            const unsigned int s = (shift > (T)K) ? K + 1 : (unsigned int)shift;
+            Taylor<T, K> y;
+            for (unsigned int k = 0; k + m <= K; ++k) y.coefficient[k] = x.coefficient[k + m];
+            const Taylor<T, K> q = _pow(y, r, std::pow(y.coefficient[0], r));
+            for (unsigned int k = 0; k <= K; ++k) p.coefficient[k] = (k < s) ? (T)0 : ((k - s <= K - m) ? q.coefficient[k - s] : std::numeric_limits<T>::quiet_NaN());
+            return p;
+        }
+        p.coefficient[0] = p0;
+        for (unsigned int k = 1; k <= K; ++k)
+        {
+            T s = 0;
+            for (unsigned int j = 0; j < k; ++j) s += (r * (T)(k - j) - (T)j) * x.coefficient[k - j] * p.coefficient[j];
+            p.coefficient[k] = s / ((T)k * x.coefficient[0]);
+        }
+        return p;
+    };
+
+    //Comparison
+    template<class T, unsigned int K> constexpr inline bool operator==(const Taylor<T, K> &a, const Taylor<T, K> &b) { return a.coefficient[0] == b.coefficient[0]; };
+    template<class T, unsigned int K> constexpr inline bool operator!=(const Taylor<T, K> &a, const Taylor<T, K> &b) { return a.coefficient[0] != b.coefficient[0]; };
+    template<class T, unsigned int K> constexpr inline bool operator> (const Taylor<T, K> &a, const Taylor<T, K> &b) { return a.coefficient[0] >  b.coefficient[0]; };
+    template<class T, unsigned int K> constexpr inline bool operator< (const Taylor<T, K> &a, const Taylor<T, K> &b) { return a.coefficient[0] <  b.coefficient[0]; };
+    template<class T, unsigned int K> constexpr inline bool operator>=(const Taylor<T, K> &a, const Taylor<T, K> &b) { return a.coefficient[0] >= b.coefficient[0]; };
+    template<class T, unsigned int K> constexpr inline bool operator<=(const Taylor<T, K> &a, const Taylor<T, K> &b) { return a.coefficient[0] <= b.coefficient[0]; };
+
+    //Trigonometric functions
+    template<class T, unsigned int K> inline Taylor<T, K> cos  (const Taylor<T, K> &x) noexcept { Taylor<T, K> s, c; _sincos(x, s, c, std::sin(x.coefficient[0]), std::cos(x.coefficient[0]), (T)-1); return c; };
+    template<class T, unsigned int K> inline Taylor<T, K> sin  (const Taylor<T, K> &x) noexcept { Taylor<T, K> s, c; _sincos(x, s, c, std::sin(x.coefficient[0]), std::cos(x.coefficient[0]), (T)-1); return s; };
+    template<class T, unsigned int K> inline Taylor<T, K> tan  (const Taylor<T, K> &x) noexcept { return _tan(x, std::tan(x.coefficient[0]), (T)1); };
+    template<class T, unsigned int K> inline Taylor<T, K> acos (const Taylor<T, K> &x) noexcept { Taylor<T, K> v; return v.integrate(std::acos(x.coefficient[0]), x, -_pow((Taylor<T, K>)1 - x * x, (T)-0.5, 1 / std::sqrt(1 - x.coefficient[0] * x.coefficient[0]))); };
+    template<class T, unsigned int K> inline Taylor<T, K> asin (const Taylor<T, K> &x) noexcept { Taylor<T, K> v; return v.integrate(std::asin(x.coefficient[0]), x, _pow((Taylor<T, K>)1 - x * x, (T)-0.5, 1 / std::sqrt(1 - x.coefficient[0] * x.coefficient[0]))); };
+    template<class T, unsigned int K> inline Taylor<T, K> atan (const Taylor<T, K> &x) noexcept { Taylor<T, K> v; return v.integrate(std::atan(x.coefficient[0]), x, (Taylor<T, K>)1 / ((Taylor<T, K>)1 + x * x)); };
+
+    //Hyperbolic functions
+    template<class T, unsigned int K> inline Taylor<T, K> cosh (const Taylor<T, K> &x) noexcept { Taylor<T, K> s, c; _sincos(x, s, c, std::sinh(x.coefficient[0]), std::cosh(x.coefficient[0]), (T)1); return c; };
+    template<class T, unsigned int K> inline Taylor<T, K> sinh (const Taylor<T, K> &x) noexcept { Taylor<T, K> s, c; _sincos(x, s, c, std::sinh(x.coefficient[0]), std::cosh(x.coefficient[0]), (T)1); return s; };
+    template<class T, unsigned int K> inline Taylor<T, K> tanh (const Taylor<T, K> &x) noexcept { return _tan(x, std::tanh(x.coefficient[0]), (T)-1); };
+    template<class T, unsigned int K> inline Taylor<T, K> acosh(const Taylor<T, K> &x) noexcept { Taylor<T, K> v; return v.integrate(std::acosh(x.coefficient[0]), x, _pow(x * x - (Taylor<T, K>)1, (T)-0.5, 1 / std::sqrt(x.coefficient[0] * x.coefficient[0] - 1))); };
+    template<class T, unsigned int K> inline Taylor<T, K> asinh(const Taylor<T, K> &x) noexcept { Taylor<T, K> v; return v.integrate(std::asinh(x.coefficient[0]), x, _pow(x * x + (Taylor<T, K>)1, (T)-0.5, 1 / std::sqrt(x.coefficient[0] * x.coefficient[0] + 1))); };
+    template<class T, unsigned int K> inline Taylor<T, K> atanh(const Taylor<T, K> &x) noexcept { Taylor<T, K> v; return v.integrate(std::atanh(x.coefficient[0]), x, (Taylor<T, K>)1 / ((Taylor<T, K>)1 - x * x)); };
+
+    //Exponential and logarithmic functions
+    template<class T, unsigned int K> inline Taylor<T, K> exp  (const Taylor<T, K> &x) noexcept { Taylor<T, K> v; return v.integrate(std::exp(x.coefficient[0]), x, v); };
+    template<class T, unsigned int K> inline Taylor<T, K> log  (const Taylor<T, K> &x) noexcept { return _log(x, std::log(x.coefficient[0])); };
+    template<class T, unsigned int K> inline Taylor<T, K> log10(const Taylor<T, K> &x) noexcept { Taylor<T, K> v; v.scale(_log(x, std::log(x.coefficient[0])), (T)M_LOG10E); v.coefficient[0] = std::log10(x.coefficient[0]); return v; };
+    template<class T, unsigned int K> inline Taylor<T, K> exp2 (const Taylor<T, K> &x) noexcept { Taylor<T, K> v, y; y.scale(x, (T)M_LN2); return v.integrate(std::exp2(x.coefficient[0]), y, v); };
+    template<class T, unsigned int K> inline Taylor<T, K> expm1(const Taylor<T, K> &x) noexcept { Taylor<T, K> v; v.integrate(std::exp(x.coefficient[0]), x, v); v.coefficient[0] = std::expm1(x.coefficient[0]); return v; };
+    template<class T, unsigned int K> inline Taylor<T, K> log1p(const Taylor<T, K> &x) noexcept { Taylor<T, K> y = x; y.coefficient[0] += 1; return _log(y, std::log1p(x.coefficient[0])); };
+    template<class T, unsigned int K> inline Taylor<T, K> log2 (const Taylor<T, K> &x) noexcept { Taylor<T, K> v; v.scale(_log(x, std::log(x.coefficient[0])), (T)M_LOG2E); v.coefficient[0] = std::log2(x.coefficient[0]); return v; };
+
+    //Power functions
+    template<class T, unsigned int K> inline Taylor<T, K> pow  (const Taylor<T, K> &base, const Taylor<T, K> &exponent) noexcept
+    {
+        //Constant exponents use the power recurrence, which also covers negative bases, others go through e^(b log(a))
+        bool constant = true;
+        for (unsigned int k = 1; k <= K; ++k) constant = constant && exponent.coefficient[k] == 0;
+        const T p = std::pow(base.coefficient[0], exponent.coefficient[0]);
+        if (constant) return _pow(base, exponent.coefficient[0], p);
+        Taylor<T, K> v;
+        return v.integrate(p, exponent * _log(base, std::log(base.coefficient[0])), v);
+    };
+    template<class T, unsigned int K> inline Taylor<T, K> sqrt (const Taylor<T, K> &x)                          noexcept { return _pow(x, (T)0.5, std::sqrt(x.coefficient[0])); };
+    template<class T, unsigned int K> inline Taylor<T, K> cbrt (const Taylor<T, K> &x)                          noexcept { return _pow(x, (T)1 / 3, std::cbrt(x.coefficient[0])); };
+    template<class T, unsigned int K> inline Taylor<T, K> hypot(const Taylor<T, K> &x, const Taylor<T, K> &y)   noexcept { return _pow(x * x + y * y, (T)0.5, std::hypot(x.coefficient[0], y.coefficient[0])); };
+
+    //Error and gamma functions
+    template<class T, unsigned int K> inline Taylor<T, K> erf   (const Taylor<T, K> &x) noexcept { Taylor<T, K> v, h; h.scale(exp(-(x * x)), (T)M_2_SQRTPI); return v.integrate(std::erf(x.coefficient[0]), x, h); };
+    template<class T, unsigned int K> inline Taylor<T, K> erfc  (const Taylor<T, K> &x) noexcept { Taylor<T, K> v, h; h.scale(exp(-(x * x)), -(T)M_2_SQRTPI); return v.integrate(std::erfc(x.coefficient[0]), x, h); };
+    template<class T, unsigned int K> inline Taylor<T, K> tgamma(const Taylor<T, K> &x) noexcept { return _constant<T, K>(std::tgamma(x.coefficient[0]), std::numeric_limits<T>::quiet_NaN()); };
+    template<class T, unsigned int K> inline Taylor<T, K> lgamma(const Taylor<T, K> &x) noexcept { return _constant<T, K>(std::lgamma(x.coefficient[0]), std::numeric_limits<T>::quiet_NaN()); };
+
+    //Rounding and remainder functions
+    template<class T, unsigned int K> inline Taylor<T, K>  ceil     (const Taylor<T, K> &x) noexcept { return (Taylor<T, K>)std::ceil     (x.coefficient[0]); };
+    template<class T, unsigned int K> inline Taylor<T, K>  floor    (const Taylor<T, K> &x) noexcept { return (Taylor<T, K>)std::floor    (x.coefficient[0]); };
+    template<class T, unsigned int K> inline Taylor<T, K>  trunc    (const Taylor<T, K> &x) noexcept { return (Taylor<T, K>)std::trunc    (x.coefficient[0]); };
+    template<class T, unsigned int K> inline Taylor<T, K>  round    (const Taylor<T, K> &x) noexcept { return (Taylor<T, K>)std::round    (x.coefficient[0]); };
+    template<class T, unsigned int K> inline long int      lround   (const Taylor<T, K> &x) noexcept { return std::lround   (x.coefficient[0]); };
+    template<class T, unsigned int K> inline long long int llround  (const Taylor<T, K> &x) noexcept { return std::llround  (x.coefficient[0]); };
+    template<class T, unsigned int K> inline Taylor<T, K>  rint     (const Taylor<T, K> &x) noexcept { return (Taylor<T, K>)std::rint     (x.coefficient[0]); };
+    template<class T, unsigned int K> inline long int      lrint    (const Taylor<T, K> &x) noexcept { return std::lrint    (x.coefficient[0]); };
+    template<class T, unsigned int K> inline long long int llrint   (const Taylor<T, K> &x) noexcept { return std::llrint   (x.coefficient[0]); };
+    template<class T, unsigned int K> inline Taylor<T, K>  nearbyint(const Taylor<T, K> &x) noexcept { return (Taylor<T, K>)std::nearbyint(x.coefficient[0]); };
+    template<class T, unsigned int K> inline Taylor<T, K>  remainder(const Taylor<T, K> &numer, const Taylor<T, K> &denom)            noexcept { return (Taylor<T, K>)std::remainder(numer.coefficient[0], denom.coefficient[0]); };
+    template<class T, unsigned int K> inline Taylor<T, K>  remquo   (const Taylor<T, K> &numer, const Taylor<T, K> &denom, int *quot) noexcept { return (Taylor<T, K>)std::remquo   (numer.coefficient[0], denom.coefficient[0], quot); };
+
+    //Floating-point manipulation functions
+    template<class T, unsigned int K> inline Taylor<T, K> copysign  (const Taylor<T, K> &mag, const Taylor<T, K> &sgn) noexcept { return (std::isnan(mag.coefficient[0])) ? ((Taylor<T, K>)(T)((sgn.coefficient[0] > 0) - (sgn.coefficient[0] < 0))) : ((std::signbit(mag.coefficient[0]) == std::signbit(sgn.coefficient[0])) ? (mag) : (-mag)); };
+    template<class T, unsigned int K> inline Taylor<T, K> nextafter (const Taylor<T, K> &x,   const Taylor<T, K> &y)   noexcept { return (Taylor<T, K>)std::nextafter (x.coefficient[0], y.coefficient[0]); };
+    template<class T, unsigned int K> inline Taylor<T, K> nexttoward(const Taylor<T, K> &x,   const Taylor<T, K> &y)   noexcept { return (Taylor<T, K>)std::nexttoward(x.coefficient[0], y.coefficient[0]); };
+
+    //Minimum, maximum, difference functions
+    template<class T, unsigned int K> inline Taylor<T, K> fdim(const Taylor<T, K> &x, const Taylor<T, K> &y) noexcept { return (x > y) ? (x - y) : ((Taylor<T, K>)0); };
+    template<class T, unsigned int K> inline Taylor<T, K> fmax(const Taylor<T, K> &x, const Taylor<T, K> &y) noexcept { if (std::isnan(x.coefficient[0])) return y; if (std::isnan(y.coefficient[0])) return x; return (x > y) ? (x) : (y); };
+    template<class T, unsigned int K> inline Taylor<T, K> fmin(const Taylor<T, K> &x, const Taylor<T, K> &y) noexcept { if (std::isnan(x.coefficient[0])) return y; if (std::isnan(y.coefficient[0])) return x; return (x < y) ? (x) : (y); };
+
+    //Other functions
+    template<class T, unsigned int K> inline Taylor<T, K> fabs(const Taylor<T, K> &x) noexcept { return (x.coefficient[0] > 0) ? x : ((x.coefficient[0] < 0) ? -x : _constant<T, K>(0, std::numeric_limits<T>::quiet_NaN())); };
+    template<class T, unsigned int K> inline Taylor<T, K> abs (const Taylor<T, K> &x) noexcept { return fabs(x); };
+    template<class T, unsigned int K> inline Taylor<T, K> fma (const Taylor<T, K> &x, const Taylor<T, K> &y, const Taylor<T, K> &z) noexcept { return x * y + z; };
+
+    //Classification macro / functions
+    template<class T, unsigned int K> constexpr inline int  fpclassify(const Taylor<T, K> &x) noexcept { return std::fpclassify(x.coefficient[0]); }
+    template<class T, unsigned int K> constexpr inline bool isfinite  (const Taylor<T, K> &x) noexcept { return std::isfinite  (x.coefficient[0]); }
+    template<class T, unsigned int K> constexpr inline bool isinf     (const Taylor<T, K> &x) noexcept { return std::isinf     (x.coefficient[0]); }
+    template<class T, unsigned int K> constexpr inline bool isnan     (const Taylor<T, K> &x) noexcept { return std::isnan     (x.coefficient[0]); }
+    template<class T, unsigned int K> constexpr inline bool isnormal  (const Taylor<T, K> &x) noexcept { return std::isnormal  (x.coefficient[0]); }
+    template<class T, unsigned int K> constexpr inline bool signbit   (const Taylor<T, K> &x) noexcept { return std::signbit   (x.coefficient[0]); }
+
+    //Comparison macro / functions
+    template<class T, unsigned int K> constexpr inline bool isgreater     (const Taylor<T, K> &x, const Taylor<T, K> &y) noexcept { return std::isgreater     (x.coefficient[0], y.coefficient[0]); }
+    template<class T, unsigned int K> constexpr inline bool isgreaterequal(const Taylor<T, K> &x, const Taylor<T, K> &y) noexcept { return std::isgreaterequal(x.coefficient[0], y.coefficient[0]); }
+    template<class T, unsigned int K> constexpr inline bool isless        (const Taylor<T, K> &x, const Taylor<T, K> &y) noexcept { return std::isless        (x.coefficient[0], y.coefficient[0]); }
+    template<class T, unsigned int K> constexpr inline bool islessequal   (const Taylor<T, K> &x, const Taylor<T, K> &y) noexcept { return std::islessequal   (x.coefficient[0], y.coefficient[0]); }
+    template<class T, unsigned int K> constexpr inline bool islessgreater (const Taylor<T, K> &x, const Taylor<T, K> &y) noexcept { return std::islessgreater (x.coefficient[0], y.coefficient[0]); }
+    template<class T, unsigned int K> constexpr inline bool isunordered   (const Taylor<T, K> &x, const Taylor<T, K> &y) noexcept { return std::isunordered   (x.coefficient[0], y.coefficient[0]); }
+}
+
+namespace std
+{
+    template<class C, class T, unsigned int K> basic_ostream<C> &operator<<(basic_ostream<C> &os, const bd::Taylor<T, K> &x)
+    {
+        os << x.coefficient[0];
+        for (unsigned int k = 1; k <= K; k++) { os << ' ' << x.coefficient[k]; }
+        return os;
+    }
+
+    template<class T, unsigned int K> std::string to_string(const bd::Taylor<T, K> &x)
+    {
+        std::stringstream str;
+        str << x;
+        return str.str();
+    }
+
+    template<class T, unsigned int K> std::wstring to_wstring(const bd::Taylor<T, K> &x)
+    {
+        std::wstringstream str;
+        str << x;
+        return str.str();
+    }
+};
\ No newline at end of file
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bd
+{
+    ///Fixed set of worker threads that run parallel loops, the calling thread takes part in every loop
+    class ThreadPool
+    {
+    private:
+        std::vector<std::thread> _workers;
+        std::mutex _call;                        //one loop at a time
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        std::condition_variable _done;
+        const std::function<void(std::size_t)> *_task = nullptr;
+        std::size_t _count = 0;
+        std::atomic<std::size_t> _next{0};
+        unsigned int _active = 0;
+        unsigned long _generation = 0;
+        bool _stop = false;
+        std::exception_ptr _error;
+
+        static inline bool &_inside() noexcept { static thread_local bool inside = false; return inside; };
+
+        inline void _run() noexcept
+        {
+            const bool inside = _inside();
+            _inside() = true;
+            for (std::size_t i = _next++; i < _count; i = _next++)
+            {
+                try { (*_task)(i); }
+                catch (...) { std::lock_guard<std::mutex> lock(_mutex); if (!_error) _error = std::current_exception(); _next = _count; }
+            }
+            _inside() = inside;
+        };
+
+        inline void _work()
+        {
+            unsigned long generation = 0;
+            while (true)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _wake.wait(lock, [&] { return _stop || _generation != generation; });
+                    if (_stop) return;
+                    generation = _generation;
+                }
+                _run();
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (--_active == 0) _done.notify_one();
+            }
+        };
+
+    public:
+        ///Creates pool of `threads` threads in total, including the caller
+        inline explicit ThreadPool(unsigned int threads = std::thread::hardware_concurrency())
+        {
+            for (unsigned int i = 1; i < threads; ++i) _workers.emplace_back([this] { _work(); });
+        };
+        ThreadPool(const ThreadPool &other) = delete;
+        ThreadPool &operator=(const ThreadPool &other) = delete;
+        inline ~ThreadPool()
+        {
+            { std::lock_guard<std::mutex> lock(_mutex); _stop = true; }
+            _wake.notify_all();
+            for (std::thread &worker : _workers) worker.join();
+        };
+
+        ///Number of threads, including the caller
+        inline unsigned int size() const noexcept { return (unsigned int)_workers.size() + 1; };
+
+        ///Calls `f(i)` for every `i < count` and waits for completion. The first exception is rethrown.
+        ///Loops started from inside a loop run serially on the current thread.
+        template<class F> inline void parallel_for(std::size_t count, const F &f)
+        {
+            if (count == 0) return;
+            if (_workers.empty() || count == 1 || _inside())
+            {
+                for (std::size_t i = 0; i < count; ++i) f(i);
+                return;
+            }
+            std::lock_guard<std::mutex> call(_call);
+            const std::function<void(std::size_t)> task = [&f](std::size_t i) { f(i); };
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _task = &task;
+                _count = count;
+                _next = 0;
+                _active = (unsigned int)_workers.size();
+                _error = nullptr;
+                ++_generation;
+            }
+            _wake.notify_all();
+            _run();
+            std::exception_ptr error;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _done.wait(lock, [&] { return _active == 0; });
+                _task = nullptr;
+                error = _error;
+            }
+            if (error) std::rethrow_exception(error);
+        };
+
+        ///Pool shared by the library, one thread per hardware thread
+        static inline ThreadPool &global()
+        {
+            static ThreadPool pool;
+            return pool;
+        };
+    };
+
+    ///Accumulator followed by a cache line of padding, so that accumulators of different threads never share a line, even in storage that is not line aligned
+    template<class A> struct _Padded
+    {
+        A value;
+        char padding[64];
+    };
+
+    ///Sums `parts` pairwise in a fixed tree, `((0 + 1) + (2 + 3)) + ...`, into `parts[0]`
+    template<class A> inline A &_tree_sum(std::vector<_Padded<A>> &parts)
+    {
+        for (std::size_t stride = 1; stride < parts.size(); stride *= 2)
+            for (std::size_t i = 0; i + stride < parts.size(); i += 2 * stride) parts[i].value += parts[i + stride].value;
+        return parts[0].value;
+    };
+
+    ///Sum of `f(i)` over `i < count`, usually a loss with its gradient, e.g. `Differentiable<T, N>` summed over samples.
+    ///Samples are split in blocks of `block`, idle threads take the next block from a shared counter, so uneven samples balance across threads.
+    ///By default every task accumulates into its own padded accumulator, then the accumulators are summed in a tree.
+    ///The grouping of samples then depends on scheduling and the result may differ in the last bits between runs.
+    ///With `deterministic`, every block has its own accumulator, and blocks are summed in a fixed tree, so the result only depends on `count` and `block`.
+    ///`f` must be safe to call concurrently.
+    ///@param f Function `A(std::size_t)` or any result that can be added to A with `+=`
+    ///@param zero Initial value of every accumulator, e.g. `Differentiable<T, Dynamic>(0, n)` to size dynamic derivatives once
+    template<class A, class F>
+    A parallel_reduce_gradient(std::size_t count, const F &f, const A &zero, bool deterministic = false, std::size_t block = 4096, ThreadPool &pool = ThreadPool::global())
+    {
+        if (block == 0) block = 1;
+        const std::size_t blocks = (count + block - 1) / block;
+        if (blocks == 0) return zero;
+        auto accumulate = [&](A &sum, std::size_t b)
+        {
+            const std::size_t end = (b + 1) * block < count ? (b + 1) * block : count;
+            for (std::size_t i = b * block; i < end; ++i) sum += f(i);
+        };
+        if (deterministic)
+        {
+            std::vector<_Padded<A>> parts(blocks, _Padded<A>{ zero, {} });
+            pool.parallel_for(blocks, [&](std::size_t b) { accumulate(parts[b].value, b); });
+            return _tree_sum(parts);
+        }
+        const std::size_t tasks = (pool.size() < blocks) ? pool.size() : blocks;
+        std::vector<_Padded<A>> parts(tasks, _Padded<A>{ zero, {} });
+        std::atomic<std::size_t> next{0};
+        pool.parallel_for(tasks, [&](std::size_t t)
+        {
+            A &sum = parts[t].value;
+            for (std::size_t b = next++; b < blocks; b = next++) accumulate(sum, b);
+        });
+        return _tree_sum(parts);
+    };
+}
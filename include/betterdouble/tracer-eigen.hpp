@@ -0,0 +1,34 @@
+#pragma once
+
+#include "tracer.hpp"
+#include <Eigen/Core>
+
+template<class T> struct Eigen::NumTraits<bd::Tracer<T>>
+{
+    typedef bd::Tracer<T> Real;
+    typedef bd::Tracer<T> NonInteger;
+    typedef bd::Tracer<T> Literal;
+    typedef bd::Tracer<T> Nested;
+
+    enum
+    {
+        IsComplex = 0,
+        IsInteger = 0,
+        IsSigned = 1,
+        ReadCost = 1,
+        AddCost = 3,
+        MulCost = 3,
+        RequireInitialization = 1 //index sets own memory
+    };
+
+    static inline bd::Tracer<T> epsilon        () noexcept { return (bd::Tracer<T>)std::numeric_limits<T>::epsilon(); }
+    static inline bd::Tracer<T> dummy_precision() noexcept { return (bd::Tracer<T>)std::numeric_limits<T>::epsilon(); }
+    static inline bd::Tracer<T> highest        () noexcept { return (bd::Tracer<T>)std::numeric_limits<T>::infinity(); }
+    static inline bd::Tracer<T> lowest         () noexcept { return (bd::Tracer<T>)-std::numeric_limits<T>::infinity(); }
+    static inline int           digits         () noexcept { return std::numeric_limits<T>::digits; }
+    static inline int           digits10       () noexcept { return std::numeric_limits<T>::digits10; }
+    static inline int           min_exponent   () noexcept { return std::numeric_limits<T>::min_exponent; }
+    static inline int           max_exponent   () noexcept { return std::numeric_limits<T>::max_exponent; }
+    static inline bd::Tracer<T> infinity       () noexcept { return (bd::Tracer<T>)std::numeric_limits<T>::infinity(); }
+    static inline bd::Tracer<T> quiet_NaN      () noexcept { return (bd::Tracer<T>)std::numeric_limits<T>::quiet_NaN(); }
+};
\ No newline at end of file
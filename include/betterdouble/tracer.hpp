@@ -0,0 +1,188 @@
+#pragma once
+
+#include "differentiable-dynamic.hpp"
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace bd
+{
+    ///Sparsity tracer, same as double, but records which variables every value depends on instead of derivatives.
+    ///Values are carried along, so comparisons and branches behave as for T and the pattern is the one at the traced point.
+    ///Functions of two arguments with kinks (`fmax`, `fmin`, `fdim`, `copysign`) depend on both arguments regardless of the branch,
+    ///so that the pattern stays valid in a neighbourhood of the point. Rounding functions depend on nothing.
+    ///@tparam T Base type
+    template<class T>
+    class Tracer
+    {
+    public:
+        //Variables
+        T value;
+        SmallVector<unsigned int> index; //sorted indices of variables the value depends on
+
+        //Constructors & assignment
+        inline explicit Tracer()                       noexcept : value(0)                                             {};
+        inline Tracer(const T &other)                  noexcept : value(other)                                         {};
+        inline Tracer(const Tracer &other)                      : value(other.value), index(other.index)            {};
+        inline Tracer(Tracer &&other)                  noexcept : value(other.value), index(std::move(other.index)) {};
+        inline Tracer &operator=(const Tracer &other)           { value = other.value; index = other.index;            return *this; };
+        inline Tracer &operator=(Tracer &&other)       noexcept { value = other.value; index = std::move(other.index); return *this; };
+
+        ///Value that depends on variable `i` only
+        static inline Tracer variable(const T &value, unsigned int i) { Tracer v = value; v.index.resize(1); v.index[0] = i; return v; };
+
+        //Kernels
+        ///Sets value and adds dependencies of `other`
+        inline Tracer &merge(T value, const Tracer &other)
+        {
+            this->value = value;
+            if (&other == this || other.index.size() == 0) return *this;
+            if (index.size() == 0) { index = other.index; return *this; }
+            const unsigned int size = index.size(), other_size = other.index.size();
+            SmallVector<unsigned int> merged;
+            merged.resize(size + other_size);
+            unsigned int i = 0, j = 0, k = 0;
+            while (i < size && j < other_size)
+            {
+                if (index[i] < other.index[j])      merged[k++] = index[i++];
+                else if (index[i] > other.index[j]) merged[k++] = other.index[j++];
+                else                                { merged[k++] = index[i++]; ++j; }
+            }
+            for (; i < size; ++i)       merged[k++] = index[i];
+            for (; j < other_size; ++j) merged[k++] = other.index[j];
+            merged.resize(k);
+            index = std::move(merged);
+            return *this;
+        };
+        ///Sets value and drops all dependencies
+        inline Tracer &constant(T value) noexcept { this->value = value; index.resize(0); return *this; };
+
+        //Increments/decrements
+        inline Tracer &operator++()    noexcept { ++value; return *this; };
+        inline Tracer &operator--()    noexcept { --value; return *this; };
+        inline Tracer operator++ (int)          { Tracer v = *this; ++value; return v; };
+        inline Tracer operator-- (int)          { Tracer v = *this; --value; return v; };
+
+        //Arithmetics
+        inline Tracer &operator+=(const Tracer &other) { return merge(value + other.value, other); };
+        inline Tracer &operator-=(const Tracer &other) { return merge(value - other.value, other); };
+        inline Tracer &operator*=(const Tracer &other) { return merge(value * other.value, other); };
+        inline Tracer &operator/=(const Tracer &other) { return merge(value / other.value, other); };
+
+        //Transformations
+        inline Tracer operator+() const & { return *this; };
+        inline Tracer operator+() &&      { return std::move(*this); };
+        inline Tracer operator-() const & { Tracer v = *this; v.value = -value; return v; };
+        inline Tracer operator-() &&      { value = -value; return std::move(*this); };
+
+        //Cast
+        inline explicit operator T() const noexcept { return value; };
+    };
+
+    //Basic arithmetics, rvalue operands donate their buffers
+    template<class T> inline Tracer<T> operator+(Tracer<T> a, const Tracer<T> &b)  { return std::move(a += b); };
+    template<class T> inline Tracer<T> operator+(const Tracer<T> &a, Tracer<T> &&b) { return std::move(b += a); };
+    template<class T> inline Tracer<T> operator-(Tracer<T> a, const Tracer<T> &b)  { return std::move(a -= b); };
+    template<class T> inline Tracer<T> operator-(const Tracer<T> &a, Tracer<T> &&b) { return std::move(b.merge(a.value - b.value, a)); };
+    template<class T> inline Tracer<T> operator*(Tracer<T> a, const Tracer<T> &b)  { return std::move(a *= b); };
+    template<class T> inline Tracer<T> operator*(const Tracer<T> &a, Tracer<T> &&b) { return std::move(b *= a); };
+    template<class T> inline Tracer<T> operator/(Tracer<T> a, const Tracer<T> &b)  { return std::move(a /= b); };
+    template<class T> inline Tracer<T> operator/(const Tracer<T> &a, Tracer<T> &&b) { return std::move(b.merge(a.value / b.value, a)); };
+
+    //Comparison
+    template<class T> inline bool operator==(const Tracer<T> &a, const Tracer<T> &b) noexcept { return a.value == b.value; };
+    template<class T> inline bool operator!=(const Tracer<T> &a, const Tracer<T> &b) noexcept { return a.value != b.value; };
+    template<class T> inline bool operator> (const Tracer<T> &a, const Tracer<T> &b) noexcept { return a.value >  b.value; };
+    template<class T> inline bool operator< (const Tracer<T> &a, const Tracer<T> &b) noexcept { return a.value <  b.value; };
+    template<class T> inline bool operator>=(const Tracer<T> &a, const Tracer<T> &b) noexcept { return a.value >= b.value; };
+    template<class T> inline bool operator<=(const Tracer<T> &a, const Tracer<T> &b) noexcept { return a.value <= b.value; };
+
+    //Trigonometric functions
+    template<class T> inline Tracer<T> cos  (Tracer<T> x) noexcept { x.value = std::cos  (x.value); return x; };
+    template<class T> inline Tracer<T> sin  (Tracer<T> x) noexcept { x.value = std::sin  (x.value); return x; };
+    template<class T> inline Tracer<T> tan  (Tracer<T> x) noexcept { x.value = std::tan  (x.value); return x; };
+    template<class T> inline Tracer<T> acos (Tracer<T> x) noexcept { x.value = std::acos (x.value); return x; };
+    template<class T> inline Tracer<T> asin (Tracer<T> x) noexcept { x.value = std::asin (x.value); return x; };
+    template<class T> inline Tracer<T> atan (Tracer<T> x) noexcept { x.value = std::atan (x.value); return x; };
+    template<class T> inline Tracer<T> atan2(Tracer<T> y, const Tracer<T> &x)   { return std::move(y.merge(std::atan2(y.value, x.value), x)); };
+
+    //Hyperbolic functions
+    template<class T> inline Tracer<T> cosh (Tracer<T> x) noexcept { x.value = std::cosh (x.value); return x; };
+    template<class T> inline Tracer<T> sinh (Tracer<T> x) noexcept { x.value = std::sinh (x.value); return x; };
+    template<class T> inline Tracer<T> tanh (Tracer<T> x) noexcept { x.value = std::tanh (x.value); return x; };
+    template<class T> inline Tracer<T> acosh(Tracer<T> x) noexcept { x.value = std::acosh(x.value); return x; };
+    template<class T> inline Tracer<T> asinh(Tracer<T> x) noexcept { x.value = std::asinh(x.value); return x; };
+    template<class T> inline Tracer<T> atanh(Tracer<T> x) noexcept { x.value = std::atanh(x.value); return x; };
+
+    //Exponential and logarithmic functions
+    template<class T> inline Tracer<T> exp  (Tracer<T> x) noexcept { x.value = std::exp  (x.value); return x; };
+    template<class T> inline Tracer<T> log  (Tracer<T> x) noexcept { x.value = std::log  (x.value); return x; };
+    template<class T> inline Tracer<T> log10(Tracer<T> x) noexcept { x.value = std::log10(x.value); return x; };
+    template<class T> inline Tracer<T> exp2 (Tracer<T> x) noexcept { x.value = std::exp2 (x.value); return x; };
+    template<class T> inline Tracer<T> expm1(Tracer<T> x) noexcept { x.value = std::expm1(x.value); return x; };
+    template<class T> inline Tracer<T> log1p(Tracer<T> x) noexcept { x.value = std::log1p(x.value); return x; };
+    template<class T> inline Tracer<T> log2 (Tracer<T> x) noexcept { x.value = std::log2 (x.value); return x; };
+
+    //Power functions
+    template<class T> inline Tracer<T> pow  (Tracer<T> base, const Tracer<T> &exponent) { return std::move(base.merge(std::pow(base.value, exponent.value), exponent)); };
+    template<class T> inline Tracer<T> sqrt (Tracer<T> x) noexcept                      { x.value = std::sqrt(x.value); return x; };
+    template<class T> inline Tracer<T> cbrt (Tracer<T> x) noexcept                      { x.value = std::cbrt(x.value); return x; };
+    template<class T> inline Tracer<T> hypot(Tracer<T> x, const Tracer<T> &y)           { return std::move(x.merge(std::hypot(x.value, y.value), y)); };
+
+    //Error and gamma functions
+    template<class T> inline Tracer<T> erf   (Tracer<T> x) noexcept { x.value = std::erf   (x.value); return x; };
+    template<class T> inline Tracer<T> erfc  (Tracer<T> x) noexcept { x.value = std::erfc  (x.value); return x; };
+    template<class T> inline Tracer<T> tgamma(Tracer<T> x) noexcept { x.value = std::tgamma(x.value); return x; };
+    template<class T> inline Tracer<T> lgamma(Tracer<T> x) noexcept { x.value = std::lgamma(x.value); return x; };
+
+    //Rounding and remainder functions
+    template<class T> inline Tracer<T> ceil     (Tracer<T> x) noexcept { return std::move(x.constant(std::ceil     (x.value))); };
+    template<class T> inline Tracer<T> floor    (Tracer<T> x) noexcept { return std::move(x.constant(std::floor    (x.value))); };
+    template<class T> inline Tracer<T> trunc    (Tracer<T> x) noexcept { return std::move(x.constant(std::trunc    (x.value))); };
+    template<class T> inline Tracer<T> round    (Tracer<T> x) noexcept { return std::move(x.constant(std::round    (x.value))); };
+    template<class T> inline Tracer<T> rint     (Tracer<T> x) noexcept { return std::move(x.constant(std::rint     (x.value))); };
+    template<class T> inline Tracer<T> nearbyint(Tracer<T> x) noexcept { return std::move(x.constant(std::nearbyint(x.value))); };
+    template<class T> inline Tracer<T> fmod     (Tracer<T> numer, const Tracer<T> &denom) { return std::move(numer.merge(std::fmod     (numer.value, denom.value), denom)); };
+    template<class T> inline Tracer<T> remainder(Tracer<T> numer, const Tracer<T> &denom) { return std::move(numer.merge(std::remainder(numer.value, denom.value), denom)); };
+
+    //Minimum, maximum, difference functions
+    template<class T> inline Tracer<T> fdim    (Tracer<T> x,   const Tracer<T> &y)   { return std::move(x.merge(std::fdim    (x.value, y.value),     y)); };
+    template<class T> inline Tracer<T> fmax    (Tracer<T> x,   const Tracer<T> &y)   { return std::move(x.merge(std::fmax    (x.value, y.value),     y)); };
+    template<class T> inline Tracer<T> fmin    (Tracer<T> x,   const Tracer<T> &y)   { return std::move(x.merge(std::fmin    (x.value, y.value),     y)); };
+    template<class T> inline Tracer<T> copysign(Tracer<T> mag, const Tracer<T> &sgn) { return std::move(mag.merge(std::copysign(mag.value, sgn.value), sgn)); };
+
+    //Other functions
+    template<class T> inline Tracer<T> fabs(Tracer<T> x) noexcept { x.value = std::fabs(x.value); return x; };
+    template<class T> inline Tracer<T> abs (Tracer<T> x) noexcept { x.value = std::abs (x.value); return x; };
+    template<class T> inline Tracer<T> fma (Tracer<T> x, const Tracer<T> &y, const Tracer<T> &z) { x.merge(x.value, y); return std::move(x.merge(std::fma(x.value, y.value, z.value), z)); };
+
+    //Classification macro / functions
+    template<class T> inline bool isfinite(const Tracer<T> &x) noexcept { return std::isfinite(x.value); };
+    template<class T> inline bool isinf   (const Tracer<T> &x) noexcept { return std::isinf   (x.value); };
+    template<class T> inline bool isnan   (const Tracer<T> &x) noexcept { return std::isnan   (x.value); };
+    template<class T> inline bool signbit (const Tracer<T> &x) noexcept { return std::signbit (x.value); };
+
+    //Defines
+    typedef Tracer<float> TFloat;
+    typedef Tracer<double> TDouble;
+    typedef Tracer<long double> TLongDouble;
+}
+
+namespace std
+{
+    template<class C, class T> basic_ostream<C> &operator<<(basic_ostream<C> &os, const bd::Tracer<T> &x)
+    {
+        os << x.value << " {";
+        for (unsigned int k = 0; k < x.index.size(); k++) { os << ((k == 0) ? "" : " ") << x.index[k]; }
+        os << '}';
+        return os;
+    }
+
+    template<class T> std::string to_string(const bd::Tracer<T> &x)
+    {
+        std::stringstream str;
+        str << x;
+        return str.str();
+    }
+};
\ No newline at end of file
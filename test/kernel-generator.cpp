@@ -0,0 +1,12 @@
+#include "../include/betterdouble/codegen.hpp"
+#include "kernel.hpp"
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char **argv)
+{
+    if (argc != 2) { std::cerr << "Usage: kernel-generator <output>" << std::endl; return 1; }
+    std::ofstream file(argv[1]);
+    file << bd::codegen::generate<double>("generated_model", 3, [](const std::vector<bd::SDouble> &x) { return kernel_model(x); });
+    return file.good() ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <vector>
+
+///Model shared by test/kernel-generator.cpp and the test comparing the generated kernel, generic over scalar S
+template<class S> inline std::vector<S> kernel_model(const std::vector<S> &x)
+{
+    using std::sin; using std::exp; using std::sqrt; using std::hypot; using std::pow; using std::atan; using std::tanh; using std::log1p;
+    using std::exp2; using std::log10; using std::log2; using std::erfc; using std::fma; using std::fmin; using std::fmax; using std::fdim; using std::copysign;
+    const S shared = x[0] * x[1] + sin(x[2]);
+    std::vector<S> y(3);
+    y[0] = shared * shared + 0 * x[1] + fma(x[0], x[2], exp2(x[1]));
+    y[1] = exp(x[0]) / hypot(x[1], x[2]) + pow(x[2], 3) + fmax(x[0], x[1]) * log10(x[2]) - fdim(x[2], x[0]);
+    y[2] = atan(x[1] / x[0]) * sqrt(shared) - tanh(x[0] * x[1]) + log1p(x[2] * x[2]) + copysign(log2(x[1] + 2), x[0] - x[1]) * fmin(erfc(x[0]), x[1]);
+    return y;
+}
\ No newline at end of file
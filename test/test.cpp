@@ -1,10 +1,39 @@
+#define BD_FAST_POW 1 //tests the approximation on all targets
 #include "../include/betterdouble/betterdouble-eigen.hpp"
+#include "../include/betterdouble/differentiable-expression.hpp"
+#include "../include/betterdouble/differentiable-batch.hpp"
+#include "../include/betterdouble/fast.hpp"
+#include "../include/betterdouble/taylor.hpp"
+#include "../include/betterdouble/io.hpp"
+#include "../include/betterdouble/codegen.hpp"
+#include "kernel.hpp"
 #include <gtest/gtest.h>
 #include <Eigen/Eigenvalues>
+#include <unsupported/Eigen/IterativeSolvers>
+#include <clocale>
+#include <cstring>
 #include <limits>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 template class bd::Real<double>;
 template class bd::Differentiable<double, 1>;
+template class bd::Differentiable<double, 4, float>;
+template class bd::Differentiable<double, bd::Dynamic>;
+template class bd::Differentiable<double, bd::Sparse>;
+template class bd::Lazy<double, 3>;
+template class bd::Adjoint<double>;
+template class bd::RealBatch<double>;
+template class bd::DifferentiableBatch<double, 3>;
+template class bd::HyperDual<double, 3>;
+template class bd::Taylor<double, 6>;
+template class bd::Tracer<double>;
+template class bd::Symbol<double>;
+
+//Generated by kernel-generator
+void generated_model(const double *x, double *y) noexcept;
+void generated_model_jacobian(const double *x, double *y, double *jacobian) noexcept;
 
 TEST(Arithmetics, Operators)
 {
@@ -56,6 +85,45 @@ TEST(Arithmetics, Division)
     EXPECT_NEAR(c.derivative[0], 2.0/9.0, 0.001);
 }
 
+TEST(Arithmetics, Mixed)
+{
+    typedef bd::Differentiable<double, 4> D;
+    D x = 3; x.derivative[0] = 1; x.derivative[3] = -2;
+    const D promoted = D(2.0) * x + D(1.5) - x / D(2.0) + D(1.0) / x - bd::pow(x, D(2.0)) + bd::pow(D(2.0), x) + bd::hypot(x, D(4.0));
+    #ifdef BD_INSTRUMENT
+    bd::counters::reset();
+    #endif
+    const D mixed = 2 * x + 1.5 - x / 2.0 + 1 / x - bd::pow(x, 2) + bd::pow(2.0, x) + bd::hypot(x, 4.0);
+    #ifdef BD_INSTRUMENT
+    EXPECT_EQ(bd::counters::snapshot()[bd::counters::Operation::derivative], 4u * 11); //one pass per operation, none for constants
+    #endif
+    EXPECT_NEAR(mixed.value, promoted.value, 1e-12);
+    for (unsigned int i = 0; i < 4; i++) EXPECT_NEAR(mixed.derivative[i], promoted.derivative[i], 1e-12);
+    EXPECT_TRUE(x < 4 && 4.0 > x && x == 3);
+    EXPECT_EQ(bd::fmax(x, 4.0).derivative[0], 0);
+    EXPECT_EQ(bd::fmax(4.0, x + 2).derivative[0], 1);
+    const D r = bd::Real<double>(2) * x - bd::Real<double>(1);
+    EXPECT_EQ(r.value, 5);
+    EXPECT_EQ(r.derivative[3], -4);
+
+    //Base type matrices multiply Differentiable ones without promotion
+    const Eigen::MatrixXd a = Eigen::MatrixXd::Random(5, 5);
+    Eigen::Matrix<D, Eigen::Dynamic, 1> v(5);
+    for (Eigen::Index i = 0; i < 5; i++) { v(i) = 0.5 * (double)i; v(i).derivative[i % 4] = 1; }
+    const Eigen::Matrix<D, Eigen::Dynamic, 1> av = a * v, bv = a.cast<D>() * v, scaled = v * 2.0;
+    for (Eigen::Index i = 0; i < 5; i++)
+    {
+        EXPECT_NEAR(av(i).value, bv(i).value, 1e-12);
+        for (unsigned int k = 0; k < 4; k++) EXPECT_NEAR(av(i).derivative[k], bv(i).derivative[k], 1e-12);
+        EXPECT_EQ(scaled(i).derivative[i % 4], 2);
+    }
+    const Eigen::Matrix<D, Eigen::Dynamic, Eigen::Dynamic> m = v * v.transpose(), am = a.transpose() * m.transpose(), bm = a.transpose().cast<D>() * m;
+    for (Eigen::Index i = 0; i < am.size(); i++) for (unsigned int k = 0; k < 4; k++) EXPECT_NEAR(am(i).derivative[k], bm(i).derivative[k], 1e-12);
+    bd::DDoubleX dx(1.0, 2); dx.derivative[1] = 1;
+    EXPECT_EQ((2.0 - dx * 3.0).derivative[1], -3);
+    EXPECT_EQ(bd::pow(dx, 3.0).derivative[1], 3);
+}
+
 TEST(Trigonometry, Sine)
 {
     bd::DDouble a = 1; a.derivative[0] = 1;
@@ -72,6 +140,850 @@ TEST(Trigonometry, Cosine)
     EXPECT_NEAR(c.derivative[0], -std::sin(1), 0.001);
 }
 
+TEST(Precision, Derivatives)
+{
+    typedef bd::Differentiable<double, 9> D;
+    typedef bd::DDoubleF<9> F;
+    EXPECT_LT(sizeof(F), sizeof(D));
+    D a = 0.7, b = 1.3;
+    for (unsigned int i = 0; i < 9; i++) { a.derivative[i] = 1.0 / (i + 1); b.derivative[i] = 0.5 * i; }
+    const F fa(a), fb(b);
+    const D d = bd::sin(a) * b + bd::exp(a * b) / bd::pow(b, a);
+    const F f = bd::sin(fa) * fb + bd::exp(fa * fb) / bd::pow(fb, fa);
+    EXPECT_EQ(f.value, d.value);
+    for (unsigned int i = 0; i < 9; i++) EXPECT_NEAR(f.derivative[i], d.derivative[i], 1e-6 * std::abs(d.derivative[i]) + 1e-7);
+    EXPECT_EQ(D(f).derivative[3], (double)f.derivative[3]);
+    Eigen::Matrix<F, 2, 2> m;
+    m << fa, fb, fb, fa;
+    const Eigen::Matrix<F, 2, 1> v = m * Eigen::Matrix<F, 2, 1>(fa, fb);
+    EXPECT_EQ(v(0).value, a.value * a.value + b.value * b.value);
+    EXPECT_NEAR(v(1).derivative[4], 2 * (a.value * b.derivative[4] + b.value * a.derivative[4]), 1e-6);
+}
+
+TEST(Dynamic, Arithmetics)
+{
+    bd::DDoubleX a(1, 3); a.derivative[0] = 2;
+    bd::DDoubleX b(3, 2); b.derivative[1] = 4;
+    bd::DDoubleX c = a * b + bd::DDoubleX(5);
+    EXPECT_EQ((double)c, 8);
+    ASSERT_EQ(c.derivative.size(), 3);
+    EXPECT_EQ(c.derivative[0], 6);
+    EXPECT_EQ(c.derivative[1], 4);
+    EXPECT_EQ(c.derivative[2], 0);
+    bd::DDoubleX d = a / b - b;
+    EXPECT_NEAR((double)d, 1.0 / 3.0 - 3, 0.001);
+    EXPECT_NEAR(d.derivative[0], 2.0 / 3.0, 0.001);
+    EXPECT_NEAR(d.derivative[1], -4.0 / 9.0 - 4, 0.001);
+}
+
+TEST(Dynamic, Functions)
+{
+    bd::DDoubleX a(1, 1); a.derivative[0] = 1;
+    bd::DDoubleX c = bd::sin(a) * bd::exp(a);
+    EXPECT_NEAR((double)c, std::sin(1) * std::exp(1), 0.001);
+    EXPECT_NEAR(c.derivative[0], (std::cos(1) + std::sin(1)) * std::exp(1), 0.001);
+}
+
+TEST(Dynamic, BufferReuse)
+{
+    bd::DDoubleX a(1, 100); a.derivative[99] = 1;
+    bd::DDoubleX b = a * a;
+    const double *buffer = b.derivative.data();
+    bd::DDoubleX c = std::move(b) + a;
+    EXPECT_EQ(c.derivative.data(), buffer);
+    EXPECT_EQ(c.derivative[99], 3);
+    c = bd::cos(std::move(c));
+    EXPECT_EQ(c.derivative.data(), buffer);
+    EXPECT_NEAR(c.derivative[99], -3 * std::sin(2), 0.001);
+}
+
+TEST(Dynamic, BufferPool)
+{
+    //Pool keeps at most `limit` buffers per capacity
+    std::thread([]
+    {
+        std::vector<bd::DDoubleX> values;
+        for (unsigned int i = 0; i < 2 * bd::BufferPool<double>::limit; ++i) values.emplace_back(1, 1000);
+        values.clear();
+        EXPECT_EQ(bd::BufferPool<double>::cached(1000), (std::size_t)bd::BufferPool<double>::limit);
+    }).join();
+
+    //Thread-local value constructed before the pool releases its buffer after the pool is destroyed
+    std::thread([]
+    {
+        static thread_local bd::DDoubleX late(1, 0);
+        late = bd::DDoubleX(2, 1000);
+        late.derivative[999] = 1;
+        EXPECT_EQ(late.derivative[999], 1);
+    }).join();
+}
+
+TEST(Sparse, Merge)
+{
+    bd::DDoubleS a = 2; a.set(3, 1);
+    bd::DDoubleS b = 5; b.set(1000, 1);
+    bd::DDoubleS c = a * b + bd::sin(a);
+    EXPECT_FALSE(c.dense);
+    EXPECT_EQ(c.nonzeros(), 2);
+    EXPECT_NEAR(c.get(3), 5 + std::cos(2), 0.001);
+    EXPECT_EQ(c.get(1000), 2);
+    EXPECT_EQ(c.get(4), 0);
+    bd::DDoubleS d = c * c;
+    EXPECT_NEAR(d.get(1000), 2 * c.value * 2, 0.001);
+}
+
+TEST(Sparse, Densify)
+{
+    bd::DDoubleS sum = 0;
+    for (unsigned int i = 0; i < 8; i++) { bd::DDoubleS x = i; x.set(i, 1); sum += x * x; }
+    EXPECT_TRUE(sum.dense);
+    EXPECT_EQ(sum.value, 140);
+    for (unsigned int i = 0; i < 8; i++) EXPECT_EQ(sum.get(i), 2.0 * i);
+    bd::DDoubleS y = 1; y.set(20, 1);
+    sum = sum / y;
+    EXPECT_EQ(sum.get(20), -140);
+    EXPECT_EQ(sum.get(7), 14);
+}
+
+TEST(Sparse, LowIndices)
+{
+    bd::DDoubleS a = 2; a.set(0, 1);
+    bd::DDoubleS b = 5; b.set(100000, 1);
+    bd::DDoubleS c = a * b;
+    EXPECT_FALSE(a.dense);
+    EXPECT_FALSE(c.dense);
+    EXPECT_EQ(c.nonzeros(), 2);
+    EXPECT_EQ(c.get(0), 5);
+    EXPECT_EQ(c.get(100000), 2);
+    bd::DDoubleS sum = 0;
+    for (unsigned int i = 0; i < 8; i++) { bd::DDoubleS x = i + 1; x.set(i, 1); sum += x; }
+    EXPECT_TRUE(sum.dense);
+    sum = sum * b;
+    EXPECT_FALSE(sum.dense);
+    EXPECT_EQ(sum.nonzeros(), 9);
+    EXPECT_EQ(sum.get(3), 5);
+    EXPECT_EQ(sum.get(100000), 36);
+    sum.set(200000, 1);
+    EXPECT_EQ(sum.nonzeros(), 10);
+}
+
+TEST(Expression, Arithmetics)
+{
+    bd::Differentiable<double, 3> a = 1; a.derivative[0] = 1;
+    bd::Differentiable<double, 3> b = 2; b.derivative[1] = 1;
+    bd::Differentiable<double, 3> c = 3; c.derivative[2] = 1;
+    bd::Differentiable<double, 3> eager = a * b + c * a - b / c;
+    bd::LDouble<3> la = a, lb = b, lc = c;
+    bd::LDouble<3> lazy = la * lb + lc * la - lb / lc;
+    bd::Differentiable<double, 3> converted = bd::lazy(a) * b + c * a - b / c;
+    EXPECT_NEAR(lazy.value, eager.value, 1e-12);
+    EXPECT_NEAR(converted.value, eager.value, 1e-12);
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        EXPECT_NEAR(lazy.derivative[i], eager.derivative[i], 1e-12);
+        EXPECT_NEAR(converted.derivative[i], eager.derivative[i], 1e-12);
+    }
+}
+
+TEST(Expression, Functions)
+{
+    bd::LDouble<2> a = 1; a.derivative[0] = 1;
+    bd::LDouble<2> b = 2; b.derivative[1] = 1;
+    a = bd::sin(a) * bd::exp(b) + bd::pow(a, b);
+    EXPECT_NEAR(a.value, std::sin(1) * std::exp(2) + 1, 0.001);
+    EXPECT_NEAR(a.derivative[0], std::cos(1) * std::exp(2) + 2, 0.001);
+    EXPECT_NEAR(a.derivative[1], std::sin(1) * std::exp(2), 0.001);
+    EXPECT_TRUE(a > b);
+}
+
+TEST(Adjoint, Gradient)
+{
+    bd::Tape<double> tape;
+    bd::ADouble x = tape.variable(1);
+    bd::ADouble y = tape.variable(2);
+    bd::ADouble z = tape.variable(3);
+    bd::ADouble f = x * y + bd::sin(z) / y - bd::exp(x);
+    tape.backward(f);
+    EXPECT_NEAR((double)f, 2 + std::sin(3) / 2 - std::exp(1), 0.001);
+    EXPECT_NEAR(tape.adjoint(x), 2 - std::exp(1), 0.001);
+    EXPECT_NEAR(tape.adjoint(y), 1 - std::sin(3) / 4, 0.001);
+    EXPECT_NEAR(tape.adjoint(z), std::cos(3) / 2, 0.001);
+}
+
+TEST(Adjoint, Functions)
+{
+    bd::Tape<double> tape;
+    bd::ADouble x = tape.variable(0.5);
+    bd::ADouble y = tape.variable(2);
+    bd::ADouble f = bd::pow(y, x) + bd::hypot(x, y) + bd::tanh(x) + bd::atan(x);
+    tape.backward(f);
+    const double h = std::hypot(0.5, 2);
+    EXPECT_NEAR(tape.adjoint(x), std::log(2) * std::pow(2, 0.5) + 0.5 / h + 1 - std::tanh(0.5) * std::tanh(0.5) + 1 / 1.25, 0.001);
+    EXPECT_NEAR(tape.adjoint(y), 0.5 * std::pow(2, -0.5) + 2 / h, 0.001);
+}
+
+TEST(Adjoint, LongSum)
+{
+    bd::Tape<double> tape;
+    std::vector<bd::ADouble> x;
+    for (unsigned int i = 0; i < 10000; i++) x.push_back(tape.variable(i));
+    bd::ADouble f = 0;
+    for (unsigned int i = 0; i < 10000; i++) f += x[i] * x[i];
+    tape.backward(f);
+    for (unsigned int i = 0; i < 10000; i += 1000) EXPECT_EQ(tape.adjoint(x[i]), 2.0 * i);
+}
+
+TEST(Functions, Derivatives)
+{
+    typedef bd::Differentiable<double, 5> D;
+    const double h = 1e-6;
+    #define BD_CHECK_DERIVATIVE(f, x0) \
+    { \
+        D x = x0; for (unsigned int i = 0; i < 5; i++) x.derivative[i] = i + 1; \
+        const D y = bd::f(x); \
+        const double d = (std::f(x0 + h) - std::f(x0 - h)) / (2 * h); \
+        EXPECT_NEAR(y.value, std::f(x0), 1e-9) << #f; \
+        for (unsigned int i = 0; i < 5; i++) EXPECT_NEAR(y.derivative[i], (i + 1) * d, 1e-5 * (i + 1) * (1 + std::abs(d))) << #f; \
+    }
+    BD_CHECK_DERIVATIVE(cos, 0.5) BD_CHECK_DERIVATIVE(sin, 0.5) BD_CHECK_DERIVATIVE(tan, 0.5)
+    BD_CHECK_DERIVATIVE(acos, 0.5) BD_CHECK_DERIVATIVE(asin, 0.5) BD_CHECK_DERIVATIVE(atan, 0.5)
+    BD_CHECK_DERIVATIVE(cosh, 0.5) BD_CHECK_DERIVATIVE(sinh, 0.5) BD_CHECK_DERIVATIVE(tanh, 0.5)
+    BD_CHECK_DERIVATIVE(acosh, 1.5) BD_CHECK_DERIVATIVE(asinh, 0.5) BD_CHECK_DERIVATIVE(atanh, 0.5)
+    BD_CHECK_DERIVATIVE(exp, 0.5) BD_CHECK_DERIVATIVE(log, 0.5) BD_CHECK_DERIVATIVE(log10, 0.5)
+    BD_CHECK_DERIVATIVE(exp2, 0.5) BD_CHECK_DERIVATIVE(expm1, 0.5) BD_CHECK_DERIVATIVE(log1p, 0.5)
+    BD_CHECK_DERIVATIVE(log2, 0.5) BD_CHECK_DERIVATIVE(sqrt, 0.5) BD_CHECK_DERIVATIVE(cbrt, 0.5)
+    BD_CHECK_DERIVATIVE(erf, 0.5) BD_CHECK_DERIVATIVE(erfc, 0.5) BD_CHECK_DERIVATIVE(fabs, -0.5)
+    #undef BD_CHECK_DERIVATIVE
+}
+
+TEST(Functions, Binary)
+{
+    bd::Differentiable<double, 9> a = 2, b = 3;
+    for (unsigned int i = 0; i < 9; i++) { a.derivative[i] = i; b.derivative[i] = 1; }
+    const bd::Differentiable<double, 9> p = bd::pow(a, b), h = bd::hypot(a, b);
+    a += b;
+    for (unsigned int i = 0; i < 9; i++)
+    {
+        EXPECT_NEAR(p.derivative[i], 3 * 4 * i + std::log(2) * 8, 1e-9);
+        EXPECT_NEAR(h.derivative[i], (2.0 * i + 3) / std::sqrt(13), 1e-9);
+        EXPECT_EQ(a.derivative[i], i + 1);
+    }
+    EXPECT_EQ(a.value, 5);
+}
+
+TEST(Batch, Differentiable)
+{
+    typedef bd::Differentiable<double, 3> D;
+    const std::size_t n = 300; //more than one block, not a multiple of packet size
+    bd::DifferentiableBatch<double, 3> a(n), b(n);
+    for (std::size_t k = 0; k < n; k++)
+    {
+        D x = 0.5 + 0.001 * k, y = 2 - 0.002 * k;
+        for (unsigned int i = 0; i < 3; i++) { x.derivative[i] = i + 1; y.derivative[i] = 0.5 * i; }
+        a.set(k, x); b.set(k, y);
+    }
+    bd::DifferentiableBatch<double, 3> f = bd::sin(a) * b - bd::exp(a) / b + bd::pow(b, a);
+    f *= f; f /= b; f += -a;
+    for (std::size_t k = 0; k < n; k++)
+    {
+        const D x = a.get(k), y = b.get(k);
+        D g = bd::sin(x) * y - bd::exp(x) / y + bd::pow(y, x);
+        g *= g; g /= y; g += -x;
+        const D h = f.get(k);
+        EXPECT_NEAR(h.value, g.value, 1e-12);
+        for (unsigned int i = 0; i < 3; i++) EXPECT_NEAR(h.derivative[i], g.derivative[i], 1e-9);
+    }
+
+    //Moved-from batches stay consistent with their buffers
+    bd::DifferentiableBatch<double, 3> moved = std::move(f);
+    EXPECT_EQ(moved.size(), n);
+    EXPECT_EQ(f.size(), 0u);
+    bd::DifferentiableBatch<double, 3> small(5);
+    small = std::move(moved);
+    EXPECT_EQ(small.size(), n);
+    EXPECT_EQ(moved.size(), 5u);
+    EXPECT_EQ(moved.stride(), bd::simd::stride<double>(5));
+    moved += moved;
+}
+
+TEST(Batch, Real)
+{
+    bd::DoubleBatch x(37), y(37, 2.0);
+    for (std::size_t k = 0; k < x.size(); k++) x[k] = 0.1 * k;
+    const bd::DoubleBatch f = bd::sqrt(x) * y + bd::atan2(x, y) - x / y;
+    for (std::size_t k = 0; k < x.size(); k++) EXPECT_NEAR(f[k], std::sqrt(0.1 * k) * 2 + std::atan2(0.1 * k, 2) - 0.05 * k, 1e-12);
+}
+
+TEST(Io, Binary)
+{
+    typedef bd::Differentiable<double, 3> D;
+    std::vector<D> x(1000);
+    for (std::size_t k = 0; k < x.size(); k++) { x[k] = 0.1 * k; for (unsigned int i = 0; i < 3; i++) x[k].derivative[i] = 1.0 / (k + i + 1); }
+    std::stringstream stream;
+    { bd::io::Writer<D> writer(stream, x.size()); writer.write(x.data(), x.size()); }
+    EXPECT_EQ(stream.str().size(), sizeof(bd::io::Header) + x.size() * 4 * sizeof(double));
+    std::vector<D> y(1001);
+    bd::io::Reader<D> reader(stream);
+    EXPECT_EQ(reader.read(y.data(), y.size()), x.size());
+    EXPECT_EQ(y[999].value, x[999].value);
+    EXPECT_EQ(y[999].derivative[2], x[999].derivative[2]);
+    stream.clear(); stream.seekg(0);
+    bd::io::Reader<bd::Differentiable<double, 4>> wrong(stream);
+    EXPECT_TRUE(stream.fail());
+
+    bd::DifferentiableBatch<double, 2> batch(37);
+    for (std::size_t k = 0; k < batch.size(); k++) batch.value()[k] = batch.derivative(0)[k] = batch.derivative(1)[k] = 0.5 * k;
+    batch.derivative(1)[5] = -1;
+    std::stringstream planes;
+    bd::io::write(planes, batch);
+    bd::DifferentiableBatch<double, 2> copy;
+    ASSERT_TRUE(bd::io::read(planes, copy));
+    EXPECT_EQ(copy.size(), 37u);
+    EXPECT_EQ(copy.derivative(1)[5], -1);
+    const std::string bytes = planes.str();
+    const bd::io::BatchView<double, 2> view(bytes.data(), bytes.size());
+    ASSERT_TRUE(view.valid());
+    EXPECT_EQ(view.value(), reinterpret_cast<const double*>(bytes.data() + sizeof(bd::io::Header)));
+    EXPECT_EQ(view.get(5).derivative[1], -1);
+    EXPECT_EQ(view.get(36).value, 18);
+    EXPECT_FALSE((bd::io::BatchView<float, 2>(bytes.data(), bytes.size()).valid()));
+    EXPECT_EQ(view.batch().size(), 0u);
+
+    std::vector<double> mapped(bytes.size() / sizeof(double));
+    std::memcpy(mapped.data(), bytes.data(), bytes.size());
+    const bd::io::BatchView<double, 2> writable(static_cast<void*>(mapped.data()), bytes.size());
+    bd::DifferentiableBatch<double, 2> inplace = writable.batch();
+    ASSERT_EQ(inplace.data(), mapped.data() + sizeof(bd::io::Header) / sizeof(double));
+    inplace += batch;
+    EXPECT_EQ(writable.get(5).derivative[1], -2);
+    inplace = bd::sin(std::move(inplace));
+    EXPECT_EQ(inplace.data(), writable.value());
+    EXPECT_NEAR(writable.get(36).value, std::sin(36.0), 1e-12);
+    const bd::DifferentiableBatch<double, 2> owned = inplace;
+    EXPECT_NE(owned.data(), inplace.data());
+    EXPECT_EQ(owned.get(36).value, writable.get(36).value);
+}
+
+TEST(Io, Text)
+{
+    bd::Differentiable<double, 3> x = 0.1, y;
+    x.derivative[0] = 1.0 / 3; x.derivative[1] = -1e-300; x.derivative[2] = 123456789.125;
+    char buffer[256];
+    const char *end = bd::io::format(buffer, buffer + sizeof(buffer), x);
+    ASSERT_NE(end, nullptr);
+    EXPECT_EQ(bd::io::parse(buffer, end, y), end);
+    EXPECT_EQ(y.value, x.value);
+    for (unsigned int i = 0; i < 3; i++) EXPECT_EQ(y.derivative[i], x.derivative[i]);
+    EXPECT_EQ(bd::io::format(buffer, buffer + 8, x), nullptr);
+    EXPECT_EQ(bd::io::to_string(bd::Real<double>(0.5)), "0.5");
+    bd::Real<float> f;
+    const std::string text = bd::io::to_string(bd::Real<float>(0.1f));
+    bd::io::parse(text.data(), text.data() + text.size(), f);
+    EXPECT_EQ(f.value, 0.1f);
+
+    //Text does not follow LC_NUMERIC, checked where a locale with decimal comma is installed
+    const char *locales[] = { "de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "German_Germany.1252" };
+    for (const char *name : locales)
+    {
+        if (std::setlocale(LC_NUMERIC, name) == nullptr) continue;
+        EXPECT_EQ(bd::io::to_string(bd::Real<double>(0.5)), "0.5");
+        bd::Real<double> r;
+        const char half[] = "0.5";
+        EXPECT_EQ(bd::io::parse(half, half + 3, r), half + 3);
+        EXPECT_EQ(r.value, 0.5);
+        std::setlocale(LC_NUMERIC, "C");
+        break;
+    }
+}
+
+TEST(Codegen, Kernel)
+{
+    const double x[3] = { 0.3, 0.7, 1.1 };
+    std::vector<bd::Differentiable<double, 3>> dx(x, x + 3);
+    for (unsigned int i = 0; i < 3; i++) dx[i].derivative[i] = 1;
+    const std::vector<bd::Differentiable<double, 3>> dy = kernel_model(dx);
+
+    bd::codegen::Kernel<double> kernel(3);
+    for (const bd::SDouble &y : kernel_model(kernel.inputs())) kernel.output(y);
+    double y[3], yj[3], yi[3], j[9], ji[9];
+    generated_model(x, y);
+    generated_model_jacobian(x, yj, j);
+    kernel.evaluate(x, yi, ji);
+    for (unsigned int r = 0; r < 3; r++)
+    {
+        EXPECT_NEAR(y[r], dy[r].value, 1e-12);
+        EXPECT_EQ(yj[r], y[r]);
+        EXPECT_EQ(yi[r], y[r]);
+        for (unsigned int c = 0; c < 3; c++) EXPECT_NEAR(j[3 * r + c], dy[r].derivative[c], 1e-12);
+        for (unsigned int c = 0; c < 3; c++) EXPECT_NEAR(ji[3 * r + c], dy[r].derivative[c], 1e-12);
+    }
+
+    const std::string source = kernel.generate("model");
+    const std::string values = source.substr(0, source.find("model_jacobian"));
+    EXPECT_EQ(values.find("std::sin(x[2])"), values.rfind("std::sin(x[2])"));
+    EXPECT_EQ(values.find("std::cos"), std::string::npos);
+    EXPECT_EQ(source.find("0.0 *"), std::string::npos);
+    const bd::SDouble folded = bd::sqrt(bd::SDouble(2.0) * bd::SDouble(8.0));
+    EXPECT_EQ(folded.graph, nullptr);
+    EXPECT_EQ(folded.constant, 4.0);
+    EXPECT_EQ(std::stod(bd::codegen::_literal(0.1)), 0.1);
+    EXPECT_EQ(bd::codegen::_literal(-2.0f), "(-2.0f)");
+
+    //Mixed operands, kinks and fused operations
+    bd::codegen::Kernel<double> mixed(2);
+    const bd::SDouble a = mixed.input(0), b = mixed.input(1);
+    EXPECT_EQ((2 * bd::SDouble(3.0)).constant, 6);
+    EXPECT_EQ(bd::fma(bd::SDouble(0.0), a, b).index, b.index);
+    mixed.output(bd::fmax(a, b));
+    mixed.output(bd::fdim(1 - a, b));
+    mixed.output(bd::copysign(a, b) / 2);
+    const double tie[2] = { 1, 1 };
+    double ty[3], tj[6];
+    mixed.evaluate(tie, ty, tj);
+    EXPECT_EQ(tj[0], 0); EXPECT_EQ(tj[1], 1);
+    EXPECT_EQ(tj[2], 0); EXPECT_EQ(tj[3], 0);
+    EXPECT_EQ(tj[4], 0.5); EXPECT_EQ(tj[5], 0);
+    EXPECT_NE(mixed.generate("mixed").find("std::fmax(x[0], x[1])"), std::string::npos);
+}
+
+TEST(Jacobian, Parallel)
+{
+    bd::ThreadPool pool(3);
+    Eigen::VectorXd x(11), value;
+    for (Eigen::Index i = 0; i < x.size(); i++) x(i) = 0.1 * (i + 1);
+    const Eigen::MatrixXd j = bd::jacobian<4>([](const auto &x)
+    {
+        typename std::decay<decltype(x)>::type y(2);
+        y(0) = x.squaredNorm();
+        y(1) = bd::sin(x(0)) * x(x.size() - 1);
+        return y;
+    }, x, &value, pool);
+    ASSERT_EQ(j.rows(), 2);
+    ASSERT_EQ(j.cols(), 11);
+    EXPECT_NEAR(value(0), x.squaredNorm(), 1e-12);
+    for (Eigen::Index i = 0; i < x.size(); i++) EXPECT_NEAR(j(0, i), 2 * x(i), 1e-12);
+    EXPECT_NEAR(j(1, 0), std::cos(x(0)) * x(10), 1e-12);
+    EXPECT_NEAR(j(1, 10), std::sin(x(0)), 1e-12);
+    EXPECT_EQ(j(1, 5), 0);
+}
+
+TEST(Jacobian, Gradient)
+{
+    Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(200, -1, 1);
+    double value;
+    const Eigen::VectorXd g = bd::gradient([](const auto &x) { return bd::exp(x(0)) + x.dot(x); }, x, &value);
+    EXPECT_NEAR(value, std::exp(-1) + x.dot(x), 1e-9);
+    EXPECT_NEAR(g(0), std::exp(-1) - 2, 1e-12);
+    for (Eigen::Index i = 1; i < x.size(); i++) EXPECT_NEAR(g(i), 2 * x(i), 1e-12);
+}
+
+TEST(Jacobian, Hessian)
+{
+    bd::ThreadPool pool(3);
+    Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(11, 0.1, 1.1), g;
+    double value;
+    const Eigen::MatrixXd h = bd::hessian<4>([](const auto &x) { return bd::exp(x(0) * x(10)) + x.dot(x) * x(5); }, x, &value, &g, pool);
+    ASSERT_EQ(h.rows(), 11);
+    ASSERT_EQ(h.cols(), 11);
+    const double e = std::exp(x(0) * x(10));
+    EXPECT_NEAR(value, e + x.dot(x) * x(5), 1e-12);
+    EXPECT_NEAR(g(0), x(10) * e + 2 * x(0) * x(5), 1e-12);
+    EXPECT_NEAR(g(5), x.dot(x) + 2 * x(5) * x(5), 1e-12);
+    EXPECT_NEAR(h(0, 0), x(10) * x(10) * e + 2 * x(5), 1e-12);
+    EXPECT_NEAR(h(0, 10), (1 + x(0) * x(10)) * e, 1e-12);
+    EXPECT_EQ(h(10, 0), h(0, 10));
+    EXPECT_NEAR(h(5, 5), 6 * x(5), 1e-12);
+    EXPECT_NEAR(h(3, 5), 2 * x(3), 1e-12);
+    EXPECT_NEAR(h(3, 3), 2 * x(5), 1e-12);
+    EXPECT_EQ(h(3, 4), 0);
+    EXPECT_EQ(h(6, 4), h(4, 6));
+}
+
+TEST(Jacobian, Sparse)
+{
+    bd::ThreadPool pool(3);
+    const auto f = [](const auto &x)
+    {
+        typename std::decay<decltype(x)>::type y(x.size() + 1);
+        for (Eigen::Index i = 0; i < x.size(); i++) y(i) = bd::sin(x(i)) * ((i + 1 < x.size()) ? x(i + 1) : x(i)) - ((i > 0) ? x(i - 1) : x(i));
+        y(x.size()) = bd::fmax(x(0), x(x.size() - 1));
+        return y;
+    };
+    const Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(50, -1, 2);
+    const bd::SparseJacobian<double, 2> sparse(f, x);
+    EXPECT_EQ(sparse.colors(), 3u);
+    EXPECT_EQ(sparse.pattern().nonZeros(), 3 * 50 - 2 + 2);
+    Eigen::VectorXd value, dense_value;
+    const Eigen::SparseMatrix<double> j = sparse.compute(f, x, &value, pool);
+    const Eigen::MatrixXd dense = bd::jacobian<4>(f, x, &dense_value, pool);
+    EXPECT_EQ(value, dense_value);
+    EXPECT_EQ(Eigen::MatrixXd(j), dense);
+    bd::TDouble a = bd::TDouble::variable(1, 3), b = bd::TDouble::variable(2, 1);
+    const bd::TDouble c = bd::floor(a) + bd::exp(a * b) / b;
+    ASSERT_EQ(c.index.size(), 2u);
+    EXPECT_EQ(c.index[0], 1u);
+    EXPECT_EQ(c.index[1], 3u);
+    EXPECT_EQ(c.value, 1 + std::exp(2) / 2);
+}
+
+TEST(Jacobian, NewtonKrylov)
+{
+    //Bratu problem, tridiagonal Jacobian
+    const auto f = [](const auto &x)
+    {
+        typedef typename std::decay<decltype(x)>::type Vector;
+        typedef typename Vector::Scalar S;
+        const Eigen::Index n = x.size();
+        const double h = 1.0 / (double)(n + 1);
+        Vector y(n);
+        for (Eigen::Index i = 0; i < n; i++) y(i) = ((i > 0) ? x(i - 1) : S(0.0)) - S(2.0) * x(i) + ((i + 1 < n) ? x(i + 1) : S(0.0)) + S(h * h) * bd::exp(x(i));
+        return y;
+    };
+    Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(50, 0.1, 0.2);
+    const Eigen::MatrixXd j = bd::jacobian<4>(f, x);
+    const bd::JacobianOperator<double, decltype(f)> op(f, x);
+    const Eigen::VectorXd v = Eigen::VectorXd::LinSpaced(50, -1, 1);
+    const Eigen::MatrixXd w = Eigen::MatrixXd::Random(50, 7);
+    EXPECT_LT((op * v - j * v).norm(), 1e-12);
+    EXPECT_LT((op.apply<4>(w) - j * w).norm(), 1e-12);
+    bd::ProbedDiagonalPreconditioner<double, 2> preconditioner(op);
+    EXPECT_LT((preconditioner.inverse().cwiseInverse() - j.diagonal()).norm(), 1e-12);
+
+    bd::NewtonKrylovSettings<double> settings;
+    settings.tolerance = 1e-12;
+    const bd::NewtonKrylovResult<double> result = bd::newton_krylov<Eigen::BiCGSTAB, bd::ProbedDiagonalPreconditioner<double, 2>>(f, x, settings);
+    EXPECT_EQ(result.info, Eigen::Success);
+    EXPECT_LE(result.residual, 1e-12);
+    EXPECT_LT(result.iterations, 10u);
+    Eigen::VectorXd g = Eigen::VectorXd::Zero(50);
+    EXPECT_EQ(bd::newton_krylov<Eigen::GMRES>(f, g, settings).info, Eigen::Success);
+    EXPECT_LT((g - x).norm(), 1e-9);
+    const Eigen::Matrix<bd::Differentiable<double, 1>, Eigen::Dynamic, 1> y = f(x.cast<bd::Differentiable<double, 1>>().eval());
+    for (Eigen::Index i = 0; i < 50; i++) EXPECT_NEAR(y(i).value, 0, 1e-12);
+}
+
+TEST(Jacobian, ReduceGradient)
+{
+    bd::ThreadPool one(1), four(4);
+    bd::Differentiable<double, 2> a(0.5), b(-0.25);
+    a.derivative[0] = b.derivative[1] = 1;
+    const auto loss = [&](std::size_t i) { const double x = 0.001 * i, y = std::sin(x); const bd::Differentiable<double, 2> r = a * bd::Differentiable<double, 2>(x) + b - bd::Differentiable<double, 2>(y); return r * r; };
+    bd::Differentiable<double, 2> serial;
+    for (std::size_t i = 0; i < 10007; i++) serial += loss(i);
+    const bd::Differentiable<double, 2> parallel = bd::parallel_reduce_gradient(10007, loss, bd::Differentiable<double, 2>(), false, 100, four);
+    EXPECT_NEAR(parallel.value, serial.value, 1e-9);
+    EXPECT_NEAR(parallel.derivative[0], serial.derivative[0], 1e-9);
+    EXPECT_NEAR(parallel.derivative[1], serial.derivative[1], 1e-9);
+    const bd::Differentiable<double, 2> d1 = bd::parallel_reduce_gradient(10007, loss, bd::Differentiable<double, 2>(), true, 100, one);
+    const bd::Differentiable<double, 2> d4 = bd::parallel_reduce_gradient(10007, loss, bd::Differentiable<double, 2>(), true, 100, four);
+    EXPECT_EQ(d1.value, d4.value);
+    EXPECT_EQ(d1.derivative[0], d4.derivative[0]);
+    EXPECT_EQ(d1.derivative[1], d4.derivative[1]);
+    EXPECT_NEAR(d1.value, serial.value, 1e-9);
+    const bd::Differentiable<double, bd::Dynamic> dynamic = bd::parallel_reduce_gradient(10, [](std::size_t i) { bd::Differentiable<double, bd::Dynamic> v(1.0 * i, 3); v.derivative[i % 3] = 1; return v; }, bd::Differentiable<double, bd::Dynamic>(0, 3), false, 3, four);
+    EXPECT_EQ(dynamic.value, 45);
+    EXPECT_EQ(dynamic.derivative[0], 4);
+    EXPECT_EQ(dynamic.derivative[2], 3);
+}
+
+TEST(HyperDual, Arithmetics)
+{
+    bd::HyperDual<double, 3> a = 2, b = 3, c = 5;
+    a.derivative[0] = 1; b.derivative[1] = 1; c.derivative[2] = 1;
+    const bd::HyperDual<double, 3> v = bd::pow(a * b / c, b) - bd::hypot(a, c);
+    const double q = 6.0 / 5, l = std::log(q), p = std::pow(q, 3.0), r = std::hypot(2.0, 5.0);
+    EXPECT_DOUBLE_EQ(v.value, p - r);
+    EXPECT_NEAR(v.derivative[0], 3 * p / 2 - 2 / r, 1e-12);
+    EXPECT_NEAR(v.derivative[1], p * (l + 1), 1e-12);
+    EXPECT_NEAR(v.second(0, 0), 6 * p / 4 - 25 / (r * r * r), 1e-12);
+    EXPECT_NEAR(v.second(1, 1), p * ((l + 1) * (l + 1) + 1.0 / 3), 1e-12);
+    EXPECT_NEAR(v.second(2, 0), -9 * p / 10 + 10 / (r * r * r), 1e-12);
+    EXPECT_EQ(v.second(0, 2), v.second(2, 0));
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    EXPECT_EQ(bd::copysign(bd::HyperDual<double, 3>(nan), -b).value, -1);
+    EXPECT_EQ((bd::copysign(bd::Differentiable<double, 3>(nan), bd::Differentiable<double, 3>(-3)).value), -1);
+    EXPECT_EQ((bd::copysign(bd::Differentiable<double, 3>(nan), -3.0).value), -1);
+}
+
+TEST(Taylor, Functions)
+{
+    typedef bd::Taylor<double, 6> T6;
+    const T6 x = T6::variable(0.3), one = 1;
+    const T6 e = bd::exp(T6::variable(0));
+    double factorial = 1;
+    for (unsigned int k = 0; k <= 6; k++) { EXPECT_NEAR(e.coefficient[k], 1 / factorial, 1e-15); factorial *= k + 1; }
+    #define BD_CHECK_SERIES(a, b) { const T6 u = a, v = b; for (unsigned int k = 0; k <= 6; k++) EXPECT_NEAR(u.coefficient[k], v.coefficient[k], 1e-12) << #a << ' ' << k; }
+    BD_CHECK_SERIES(bd::exp(bd::log(x)), x) BD_CHECK_SERIES(bd::sin(x) * bd::sin(x) + bd::cos(x) * bd::cos(x), one) BD_CHECK_SERIES(bd::tan(x), bd::sin(x) / bd::cos(x))
+    BD_CHECK_SERIES(bd::asin(bd::sin(x)), x) BD_CHECK_SERIES(bd::acos(bd::cos(x)), x) BD_CHECK_SERIES(bd::atan(bd::tan(x)), x)
+    BD_CHECK_SERIES(bd::cosh(x) * bd::cosh(x) - bd::sinh(x) * bd::sinh(x), one) BD_CHECK_SERIES(bd::tanh(x), bd::sinh(x) / bd::cosh(x))
+    BD_CHECK_SERIES(bd::asinh(bd::sinh(x)), x) BD_CHECK_SERIES(bd::acosh(bd::cosh(x)), x) BD_CHECK_SERIES(bd::atanh(bd::tanh(x)), x)
+    BD_CHECK_SERIES(bd::expm1(bd::log1p(x)), x) BD_CHECK_SERIES(bd::exp2(bd::log2(x)), x) BD_CHECK_SERIES(bd::log10(x), bd::log(x) / bd::log(T6(10)))
+    BD_CHECK_SERIES(bd::sqrt(x) * bd::sqrt(x), x) BD_CHECK_SERIES(bd::cbrt(x) * bd::cbrt(x) * bd::cbrt(x), x) BD_CHECK_SERIES(bd::hypot(x, T6(2)), bd::sqrt(x * x + T6(4)))
+    BD_CHECK_SERIES(bd::pow(x, T6(3)), x * x * x) BD_CHECK_SERIES(bd::pow(-x, T6(2)), x * x) BD_CHECK_SERIES(bd::pow(x, x), bd::exp(x * bd::log(x)))
+    BD_CHECK_SERIES(bd::erf(x) + bd::erfc(x), one) BD_CHECK_SERIES(bd::fabs(-x), x)
+    #undef BD_CHECK_SERIES
+    const T6 d = bd::erf(x);
+    EXPECT_NEAR(d.coefficient[1], M_2_SQRTPI * std::exp(-0.09), 1e-15);
+}
+
+TEST(Taylor, Ode)
+{
+    //x' = x^2, x(0) = 1 has the solution 1 / (1 - t), all coefficients are 1
+    bd::Taylor<double, 8> x = 1;
+    for (unsigned int k = 0; k < 8; k++) x.coefficient[k + 1] = (x * x).coefficient[k] / (k + 1);
+    for (unsigned int k = 0; k <= 8; k++) EXPECT_NEAR(x.coefficient[k], 1, 1e-12);
+}
+
+TEST(Taylor, Zero)
+{
+    typedef bd::Taylor<double, 6> T6;
+    const T6 z = T6::variable(0), one = 1;
+    #define BD_CHECK_SERIES(a, b, n) { const T6 u = a, v = b; for (unsigned int k = 0; k <= n; k++) EXPECT_NEAR(u.coefficient[k], v.coefficient[k], 1e-12) << #a << ' ' << k; }
+    BD_CHECK_SERIES(bd::pow(z, T6(2)), z * z, 6) BD_CHECK_SERIES(bd::pow(z, T6(3)), z * z * z, 6) BD_CHECK_SERIES(bd::pow(z, T6(0)), one, 6)
+    BD_CHECK_SERIES(bd::pow(z * z, T6(1.5)), z * z * z, 6) BD_CHECK_SERIES(bd::sqrt(z * z), z, 5) BD_CHECK_SERIES(bd::hypot(z, T6(0)), z, 5)
+    BD_CHECK_SERIES(bd::copysign(T6(2), -one), T6(-2), 6) BD_CHECK_SERIES(bd::copysign(T6(std::nan("")), -one), -one, 6)
+    #undef BD_CHECK_SERIES
+    EXPECT_TRUE(std::isnan(bd::sqrt(z * z).coefficient[6]));
+    EXPECT_TRUE(std::isnan(bd::sqrt(z).coefficient[1]));
+
+    //x' = 1 + x^2, x(0) = 0 has the solution tan(t)
+    bd::Taylor<double, 6> x = 0;
+    for (unsigned int k = 0; k < 6; k++) x.coefficient[k + 1] = (one + bd::pow(x, T6(2))).coefficient[k] / (k + 1);
+    const T6 t = bd::tan(z);
+    for (unsigned int k = 0; k <= 6; k++) EXPECT_NEAR(x.coefficient[k], t.coefficient[k], 1e-12);
+}
+
+#ifdef BD_INSTRUMENT
+TEST(Counters, Operations)
+{
+    bd::counters::reset();
+    const bd::Real<double> a = 2, b = 3;
+    const bd::Real<double> c = a * b + bd::sin(a) / b;
+    bd::Differentiable<double, 4> x = 2;
+    x *= x;
+    bd::counters::Counters s = bd::counters::snapshot();
+    EXPECT_EQ(s[bd::counters::Operation::mul], 2u);
+    EXPECT_EQ(s[bd::counters::Operation::add], 1u);
+    EXPECT_EQ(s[bd::counters::Operation::div], 1u);
+    EXPECT_EQ(s[bd::counters::Operation::sin], 1u);
+    EXPECT_EQ(s[bd::counters::Operation::derivative], 4u);
+    EXPECT_EQ(s[bd::counters::Operation::cos], 0u);
+    EXPECT_NE(s.json().find("\"mul\": 2"), std::string::npos);
+    EXPECT_EQ(c.value, 6 + std::sin(2.0) / 3);
+
+    //Counts of exited threads are kept in the total
+    const bd::counters::Counters before = bd::counters::total();
+    std::thread([] { bd::Real<double> y = 1; const bd::Real<double> ten = 10; for (int i = 0; i < 10; i++) y = bd::exp(y / ten); }).join();
+    const bd::counters::Counters merged = bd::counters::total() - before;
+    EXPECT_EQ(merged[bd::counters::Operation::exp], 10u);
+    EXPECT_EQ(merged[bd::counters::Operation::div], 10u);
+    bd::counters::reset();
+    EXPECT_EQ(bd::counters::snapshot()[bd::counters::Operation::mul], 0u);
+}
+#endif
+
+TEST(Functions, Rules)
+{
+    const double x = 0.3, h = 1e-6;
+    double d = 0, dh = 0;
+    #define BD_CHECK_RULE(f, x) EXPECT_NEAR((bd::rules::f(x, d), d), (bd::rules::f(x + h, dh) - bd::rules::f(x - h, dh)) / (2 * h), 1e-6) << #f; EXPECT_DOUBLE_EQ(bd::rules::f(x, d), std::f(x)) << #f;
+    BD_CHECK_RULE(cos, x) BD_CHECK_RULE(sin, x) BD_CHECK_RULE(tan, x) BD_CHECK_RULE(acos, x) BD_CHECK_RULE(asin, x) BD_CHECK_RULE(atan, x)
+    BD_CHECK_RULE(cosh, x) BD_CHECK_RULE(sinh, x) BD_CHECK_RULE(tanh, x) BD_CHECK_RULE(acosh, 1 + x) BD_CHECK_RULE(asinh, x) BD_CHECK_RULE(atanh, x)
+    BD_CHECK_RULE(exp, x) BD_CHECK_RULE(log, x) BD_CHECK_RULE(log10, x) BD_CHECK_RULE(exp2, x) BD_CHECK_RULE(expm1, x) BD_CHECK_RULE(log1p, x) BD_CHECK_RULE(log2, x)
+    BD_CHECK_RULE(sqrt, x) BD_CHECK_RULE(cbrt, x) BD_CHECK_RULE(erf, x) BD_CHECK_RULE(erfc, x) BD_CHECK_RULE(fabs, -x)
+    #undef BD_CHECK_RULE
+    double da = 0, db = 0, ea = 0, eb = 0;
+    EXPECT_DOUBLE_EQ(bd::rules::pow(1.5, x, da, db), std::pow(1.5, x));
+    EXPECT_NEAR(da, (bd::rules::pow(1.5 + h, x, ea, eb) - bd::rules::pow(1.5 - h, x, ea, eb)) / (2 * h), 1e-6);
+    EXPECT_NEAR(db, (bd::rules::pow(1.5, x + h, ea, eb) - bd::rules::pow(1.5, x - h, ea, eb)) / (2 * h), 1e-6);
+    EXPECT_EQ((bd::rules::pow(0.0, 2.0, da, db), da), 0);
+    EXPECT_NEAR((bd::rules::sinh(400.0, d), d), std::cosh(400.0), 1e-12 * std::cosh(400.0));
+}
+
+TEST(HyperDual, Rules)
+{
+    const double x = 0.3, h = 1e-6;
+    double d = 0, dd = 0, dp = 0, dm = 0;
+    #define BD_CHECK_RULE(f, x) bd::rules::f(x + h, dp); bd::rules::f(x - h, dm); EXPECT_NEAR((bd::rules::f(x, d, dd), dd), (dp - dm) / (2 * h), 1e-6) << #f; EXPECT_EQ(bd::rules::f(x, d, dd), bd::rules::f(x, dp)) << #f;
+    BD_CHECK_RULE(cos, x) BD_CHECK_RULE(sin, x) BD_CHECK_RULE(tan, x) BD_CHECK_RULE(acos, x) BD_CHECK_RULE(asin, x) BD_CHECK_RULE(atan, x)
+    BD_CHECK_RULE(cosh, x) BD_CHECK_RULE(sinh, x) BD_CHECK_RULE(tanh, x) BD_CHECK_RULE(acosh, 1 + x) BD_CHECK_RULE(asinh, x) BD_CHECK_RULE(atanh, x)
+    BD_CHECK_RULE(exp, x) BD_CHECK_RULE(log, x) BD_CHECK_RULE(log10, x) BD_CHECK_RULE(exp2, x) BD_CHECK_RULE(expm1, x) BD_CHECK_RULE(log1p, x) BD_CHECK_RULE(log2, x)
+    BD_CHECK_RULE(sqrt, x) BD_CHECK_RULE(cbrt, x) BD_CHECK_RULE(erf, x) BD_CHECK_RULE(erfc, x) BD_CHECK_RULE(fabs, -x)
+    #undef BD_CHECK_RULE
+    double da, db, daa, dab, dbb, pa, pb, ma, mb;
+    #define BD_CHECK_RULE(f, a, b) \
+        bd::rules::f(a, b, da, db, daa, dab, dbb); \
+        bd::rules::f(a + h, b, pa, pb); bd::rules::f(a - h, b, ma, mb); \
+        EXPECT_NEAR(daa, (pa - ma) / (2 * h), 1e-6) << #f; \
+        bd::rules::f(a, b + h, pa, pb); bd::rules::f(a, b - h, ma, mb); \
+        EXPECT_NEAR(dab, (pa - ma) / (2 * h), 1e-6) << #f; \
+        EXPECT_NEAR(dbb, (pb - mb) / (2 * h), 1e-6) << #f;
+    BD_CHECK_RULE(pow, 1.5, x) BD_CHECK_RULE(hypot, 1.5, x)
+    #undef BD_CHECK_RULE
+}
+
+///Largest distance from the standard library, in units in the last place of its result
+template<class T, class F, class G> double sweep(F approximation, G reference, double low, double high)
+{
+    double worst = 0;
+    for (int i = 0; i <= 100000; i++)
+    {
+        const T x = (T)(low + (high - low) * i / 100000), a = approximation(x), b = reference(x);
+        const T ulp = std::nextafter(std::fabs(b), std::numeric_limits<T>::infinity()) - std::fabs(b);
+        if (a != b) worst = std::max(worst, std::fabs((double)a - (double)b) / (double)ulp);
+    }
+    return worst;
+}
+
+template<class T> void accuracy()
+{
+    typedef bd::fast::Ulp<T> U;
+    const bool single = std::is_same<T, float>::value;
+    const T b = single ? (T)-20.5 : (T)-150.5;
+    EXPECT_LE(sweep<T>([](T x) { return bd::fast::exp(x); },  [](T x) { return std::exp(x); },  single ? -103 : -745, single ? 88.7 : 709.7), U::exp);
+    EXPECT_LE(sweep<T>([](T x) { return bd::fast::log(x); },  [](T x) { return std::log(x); },  1e-6, 10), U::log);
+    EXPECT_LE(sweep<T>([](T x) { return bd::fast::log(x); },  [](T x) { return std::log(x); },  1, 1e30), U::log);
+    EXPECT_LE(sweep<T>([](T x) { return bd::fast::sin(x); },  [](T x) { return std::sin(x); },  -100, 100), U::sin);
+    EXPECT_LE(sweep<T>([](T x) { return bd::fast::sin(x); },  [](T x) { return std::sin(x); },  -1e6, 1e6), U::sin);
+    EXPECT_LE(sweep<T>([](T x) { return bd::fast::cos(x); },  [](T x) { return std::cos(x); },  -100, 100), U::cos);
+    EXPECT_LE(sweep<T>([](T x) { return bd::fast::atan(x); }, [](T x) { return std::atan(x); }, -10, 10), U::atan);
+    EXPECT_LE(sweep<T>([](T x) { return bd::fast::atan(x); }, [](T x) { return std::atan(x); }, -1e6, 1e6), U::atan);
+    EXPECT_LE(sweep<T>([](T x) { return bd::fast::tanh(x); }, [](T x) { return std::tanh(x); }, -12, 12), U::tanh);
+    EXPECT_LE(sweep<T>([](T x) { return bd::fast::tanh(x); }, [](T x) { return std::tanh(x); }, -1e-3, 1e-3), U::tanh);
+    EXPECT_LE(sweep<T>([](T x) { return bd::fast::erf(x); },  [](T x) { return std::erf(x); },  -7, 7), U::erf);
+    EXPECT_LE(sweep<T>([](T x) { return bd::fast::pow(x, (T)3.3); }, [](T x) { return std::pow(x, (T)3.3); }, 1e-3, 100), U::pow);
+    EXPECT_LE(sweep<T>([](T x) { return bd::fast::pow((T)1.7, x); }, [](T x) { return std::pow((T)1.7, x); }, single ? -200 : -1400, single ? 160 : 1330), U::pow);
+    EXPECT_LE(sweep<T>([b](T x) { return bd::fast::pow(x, b); },    [b](T x) { return std::pow(x, b); },    0.02, 50), U::pow);
+
+    //Specials
+    const T inf = std::numeric_limits<T>::infinity();
+    EXPECT_EQ(bd::fast::exp(inf), inf);
+    EXPECT_EQ(bd::fast::exp(-inf), 0);
+    EXPECT_EQ(bd::fast::log((T)0), -inf);
+    EXPECT_EQ(bd::fast::log(inf), inf);
+    EXPECT_TRUE(std::isnan(bd::fast::log((T)-1)));
+    EXPECT_TRUE(std::isnan(bd::fast::sin(inf)));
+    EXPECT_EQ(bd::fast::atan(inf), (T)M_PI_2);
+    EXPECT_EQ(bd::fast::tanh(-inf), -1);
+    EXPECT_EQ(bd::fast::erf(-inf), -1);
+    EXPECT_EQ(bd::fast::pow((T)-2, (T)3), -8);
+    const T specials[] = { 0, -(T)0, 1, -1, 2, -2, (T)0.5, (T)-0.5, 3, -3, (T)2.5, inf, -inf, std::numeric_limits<T>::quiet_NaN() };
+    for (T x : specials) for (T y : specials)
+    {
+        const T p = bd::fast::pow(x, y), q = std::pow(x, y);
+        if (std::isnan(q)) EXPECT_TRUE(std::isnan(p)) << x << ' ' << y;
+        else { EXPECT_EQ(p, q) << x << ' ' << y; EXPECT_EQ(std::signbit(p), std::signbit(q)) << x << ' ' << y; }
+    }
+}
+
+TEST(Fast, Accuracy)
+{
+    accuracy<float>();
+    accuracy<double>();
+}
+
+TEST(Fast, Derivatives)
+{
+    typedef bd::Differentiable<double, 2> D;
+    D x = 0.7; x.derivative[0] = 1;
+    D y = 1.3; y.derivative[1] = 1;
+    #define BD_CHECK_FAST(f) { const D a = bd::fast::f(x), b = bd::f(x); EXPECT_NEAR(a.value, b.value, 1e-15) << #f; EXPECT_NEAR(a.derivative[0], b.derivative[0], 1e-15) << #f; }
+    BD_CHECK_FAST(exp) BD_CHECK_FAST(log) BD_CHECK_FAST(sin) BD_CHECK_FAST(cos) BD_CHECK_FAST(atan) BD_CHECK_FAST(tanh) BD_CHECK_FAST(erf)
+    #undef BD_CHECK_FAST
+    const D p = bd::fast::pow(y, x), q = bd::pow(y, x);
+    EXPECT_NEAR(p.derivative[0], q.derivative[0], 1e-15);
+    EXPECT_NEAR(p.derivative[1], q.derivative[1], 1e-15);
+    EXPECT_NEAR((double)bd::fast::sin(bd::Real<double>(0.7)), std::sin(0.7), 1e-16);
+}
+
+TEST(Matrices, Product)
+{
+    typedef bd::Differentiable<double, 3> D;
+    Eigen::Matrix<D, Eigen::Dynamic, Eigen::Dynamic> a(5, 4), b(4, 6);
+    for (Eigen::Index c = 0; c < 4; c++) for (Eigen::Index r = 0; r < 5; r++) { a(r, c) = std::sin(r + 2.0 * c); for (unsigned int i = 0; i < 3; i++) a(r, c).derivative[i] = std::cos(r * i + c); }
+    for (Eigen::Index c = 0; c < 6; c++) for (Eigen::Index r = 0; r < 4; r++) { b(r, c) = std::cos(r - 3.0 * c); for (unsigned int i = 0; i < 3; i++) b(r, c).derivative[i] = std::sin(r + c * i); }
+    const Eigen::Matrix<D, Eigen::Dynamic, Eigen::Dynamic> generic = a.lazyProduct(b), split = bd::product(a, b);
+    for (Eigen::Index c = 0; c < 6; c++) for (Eigen::Index r = 0; r < 5; r++)
+    {
+        EXPECT_NEAR(split(r, c).value, generic(r, c).value, 1e-12);
+        for (unsigned int i = 0; i < 3; i++) EXPECT_NEAR(split(r, c).derivative[i], generic(r, c).derivative[i], 1e-12);
+    }
+}
+
+TEST(Matrices, Solve)
+{
+    typedef bd::Differentiable<double, 2> D;
+    Eigen::Matrix<D, Eigen::Dynamic, Eigen::Dynamic> a(3, 3), b(3, 2);
+    for (Eigen::Index c = 0; c < 3; c++) for (Eigen::Index r = 0; r < 3; r++) { a(r, c) = (r == c) ? 4 : 1.0 / (1 + r + c); a(r, c).derivative[0] = r; a(r, c).derivative[1] = 0.5 * c; }
+    for (Eigen::Index c = 0; c < 2; c++) for (Eigen::Index r = 0; r < 3; r++) { b(r, c) = r - c; b(r, c).derivative[0] = 1; b(r, c).derivative[1] = c; }
+    const Eigen::Matrix<D, Eigen::Dynamic, Eigen::Dynamic> x = bd::solve(a, b), residual = bd::product(a, x);
+    for (Eigen::Index c = 0; c < 2; c++) for (Eigen::Index r = 0; r < 3; r++)
+    {
+        EXPECT_NEAR(residual(r, c).value, b(r, c).value, 1e-12);
+        for (unsigned int i = 0; i < 2; i++) EXPECT_NEAR(residual(r, c).derivative[i], b(r, c).derivative[i], 1e-12);
+    }
+}
+
+TEST(Matrices, LeastSquares)
+{
+    typedef bd::Differentiable<double, 1> D;
+    auto a = [](double t) { Eigen::MatrixXd m(4, 2); m << 1, t, 1, 2, 1 + t, 3, 1, 4 * t; return m; };
+    auto b = [](double t) { Eigen::MatrixXd m(4, 1); m << 1, 2 * t, 2, 5; return m; };
+    const double t = 0.7, h = 1e-6;
+    Eigen::Matrix<D, Eigen::Dynamic, Eigen::Dynamic> ad(4, 2), bd(4, 1);
+    for (Eigen::Index c = 0; c < 2; c++) for (Eigen::Index r = 0; r < 4; r++) { ad(r, c) = a(t)(r, c); ad(r, c).derivative[0] = (a(t + h)(r, c) - a(t - h)(r, c)) / (2 * h); }
+    for (Eigen::Index r = 0; r < 4; r++) { bd(r, 0) = b(t)(r, 0); bd(r, 0).derivative[0] = (b(t + h)(r, 0) - b(t - h)(r, 0)) / (2 * h); }
+    const Eigen::Matrix<D, Eigen::Dynamic, Eigen::Dynamic> x = bd::LinearSolver<Eigen::Matrix<D, Eigen::Dynamic, Eigen::Dynamic>, Eigen::ColPivHouseholderQR<Eigen::MatrixXd>>(ad).solve(bd);
+    const Eigen::MatrixXd xp = a(t + h).colPivHouseholderQr().solve(b(t + h)), xm = a(t - h).colPivHouseholderQr().solve(b(t - h));
+    for (Eigen::Index r = 0; r < 2; r++)
+    {
+        EXPECT_NEAR(x(r, 0).value, a(t).colPivHouseholderQr().solve(b(t))(r, 0), 1e-12);
+        EXPECT_NEAR(x(r, 0).derivative[0], (xp(r, 0) - xm(r, 0)) / (2 * h), 1e-6);
+    }
+}
+
+TEST(Matrices, EigenDerivatives)
+{
+    typedef bd::Differentiable<double, 1> D;
+    auto a = [](double t) { Eigen::MatrixXd m(3, 3); m << 2, t, 0, t, 3, 1, 0, 1, 5 + t; return m; };
+    auto g = [](double t) { Eigen::MatrixXd m(2, 2); m << 0, 1, -2 * t, -3; return m; };
+    const double t = 0.8, h = 1e-6;
+    Eigen::Matrix<D, Eigen::Dynamic, Eigen::Dynamic> ad(3, 3), gd(2, 2);
+    for (Eigen::Index c = 0; c < 3; c++) for (Eigen::Index r = 0; r < 3; r++) { ad(r, c) = a(t)(r, c); ad(r, c).derivative[0] = (a(t + h)(r, c) - a(t - h)(r, c)) / (2 * h); }
+    for (Eigen::Index c = 0; c < 2; c++) for (Eigen::Index r = 0; r < 2; r++) { gd(r, c) = g(t)(r, c); gd(r, c).derivative[0] = (g(t + h)(r, c) - g(t - h)(r, c)) / (2 * h); }
+
+    const bd::SelfAdjointEigenSolver<Eigen::Matrix<D, Eigen::Dynamic, Eigen::Dynamic>> symmetric(ad);
+    const Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> sp(a(t + h)), sm(a(t - h));
+    for (Eigen::Index k = 0; k < 3; k++)
+    {
+        EXPECT_NEAR(symmetric.eigenvalues()(k).derivative[0], (sp.eigenvalues()(k) - sm.eigenvalues()(k)) / (2 * h), 1e-6);
+        const double sign = (sp.eigenvectors().col(k).dot(sm.eigenvectors().col(k)) < 0) ? -1 : 1;
+        const double align = (symmetric.eigenvectors()(0, k).value * sp.eigenvectors()(0, k) < 0) ? -1 : 1;
+        for (Eigen::Index r = 0; r < 3; r++) EXPECT_NEAR(align * symmetric.eigenvectors()(r, k).derivative[0], (sp.eigenvectors()(r, k) - sign * sm.eigenvectors()(r, k)) / (2 * h), 1e-6);
+    }
+
+    const bd::EigenSolver<Eigen::Matrix<D, Eigen::Dynamic, Eigen::Dynamic>> general(gd);
+    const Eigen::EigenSolver<Eigen::MatrixXd> gp(g(t + h)), gm(g(t - h));
+    for (Eigen::Index k = 0; k < 2; k++)
+    {
+        EXPECT_NEAR(general.eigenvalues()(k).real().derivative[0], (gp.eigenvalues()(k).real() - gm.eigenvalues()(k).real()) / (2 * h), 1e-6);
+        EXPECT_NEAR(general.eigenvalues()(k).imag().derivative[0], 0, 1e-12);
+        const double sign = (gp.eigenvectors().col(k).real().dot(gm.eigenvectors().col(k).real()) < 0) ? -1 : 1;
+        const double align = (general.eigenvectors()(0, k).real().value * gp.eigenvectors()(0, k).real() < 0) ? -1 : 1;
+        for (Eigen::Index r = 0; r < 2; r++) EXPECT_NEAR(align * general.eigenvectors()(r, k).real().derivative[0], (gp.eigenvectors()(r, k).real() - sign * gm.eigenvectors()(r, k).real()) / (2 * h), 1e-6);
+    }
+}
+
+TEST(Matrices, RealPackets)
+{
+    const Eigen::MatrixXd a = Eigen::MatrixXd::Random(37, 29), b = Eigen::MatrixXd::Random(29, 41), c = a * b;
+    const Eigen::Matrix<bd::Double, Eigen::Dynamic, Eigen::Dynamic> ar = a.cast<bd::Double>(), br = b.cast<bd::Double>(), cr = ar * br;
+    for (Eigen::Index j = 0; j < c.cols(); j++) for (Eigen::Index i = 0; i < c.rows(); i++) EXPECT_NEAR(cr(i, j).value, c(i, j), 1e-12);
+    EXPECT_NEAR(ar.sum().value, a.sum(), 1e-12);
+    EXPECT_EQ(ar.maxCoeff().value, a.maxCoeff());
+    EXPECT_NEAR(ar.cwiseAbs().cwiseSqrt().sum().value, a.cwiseAbs().cwiseSqrt().sum(), 1e-12);
+}
+
 TEST(Matrices, LinearSystem)
 {
     Eigen::Matrix<bd::Double, Eigen::Dynamic, Eigen::Dynamic> matrix(2, 2);